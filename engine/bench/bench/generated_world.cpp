@@ -0,0 +1,110 @@
+/*
+ * Copyright (C) 2021-2023 Jean-Marie BARAN (jeanmarie.baran@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Refer to 'COPYING.txt' for the full notice.
+ */
+
+#include <bench/generated_world.hpp>
+#include <libflatkiss/logic/logic.hpp>
+#include <stdexcept>
+#include <utility>
+
+using std::invalid_argument;
+using std::make_unique;
+using std::move;
+using std::unordered_map;
+using std::vector;
+
+GeneratedWorld::GeneratedWorld(int64_t max_levels)
+    : tileset_{16, 16, 8, 8, 0, 0, 0, 0, 0, 0, 0},
+      characterset_{16, 16, 8, 8, 0, 0, 0, 1, 0, 0, 0},
+      tile_animations_{{}},
+      character_animations_{{}},
+      tile_solid_mapper_{{{kWallTile, kWallSolid}}},
+      action_sprite_mapper_{
+          {{kWalkLeft, 0}, {kWalkDown, 0}, {kWalkRight, 0}, {kWalkUp, 0}}},
+      max_levels_{max_levels} {
+  solids_.emplace(kCharacterSolid,
+                  Solid{{},
+                        {PositionedRectangle{Position{2, 4},
+                                             Rectangle{12, 12}}}});
+  solids_.emplace(kWallSolid,
+                  Solid{{},
+                        {PositionedRectangle{Position{0, 0},
+                                             Rectangle{16, 16}}}});
+  levels_.reserve(max_levels_);
+}
+
+CharacterTemplate const& GeneratedWorld::addCharacterTemplate(
+    ControllerType controller_type, int64_t behaviour_index,
+    Behaviour const* behaviour) {
+  character_templates_.push_back(make_unique<CharacterTemplate>(
+      action_sprite_mapper_, character_animations_, behaviour,
+      behaviour_index, vector<ControllerType>{controller_type}, characterset_,
+      characterSolid()));
+  return *character_templates_.back();
+}
+
+Level& GeneratedWorld::addLevel(int64_t width, int64_t height,
+                                int64_t wall_percent, uint64_t seed) {
+  if (levels_.size() == max_levels_) {
+    throw invalid_argument("Too many levels");
+  }
+
+  RandomStream random_stream{seed, 0, 0};
+  vector<uint16_t> tiles(width * height, 0);
+  for (uint16_t& tile : tiles) {
+    if (random_stream.between(0, 99) < wall_percent) {
+      tile = kWallTile;
+    }
+  }
+  return levels_.emplace_back(move(tiles), width, height, tileset_,
+                              tile_animations_, tile_solid_mapper_);
+}
+
+Solid const& GeneratedWorld::characterSolid() const {
+  return solids_.at(kCharacterSolid);
+}
+
+vector<Level>& GeneratedWorld::levels() { return levels_; }
+
+void GeneratedWorld::populate(Level& level,
+                              CharacterTemplate const& character_template,
+                              int64_t num_characters, uint64_t seed) const {
+  for (int64_t i{0}; i < num_characters; i++) {
+    TilePosition const tile{randomFreeTile(level, seed, i)};
+    level.spawnCharacter(
+        character_template,
+        Position{tile.x() * tileset_.spritesWidth(),
+                 tile.y() * tileset_.spritesHeight()});
+  }
+}
+
+TilePosition GeneratedWorld::randomFreeTile(Level const& level, uint64_t seed,
+                                            uint64_t draw) {
+  RandomStream random_stream{seed, draw, 0};
+  while (true) {
+    TilePosition const tile{random_stream.between(0, level.widthInTiles() - 1),
+                      random_stream.between(0, level.heightInTiles() - 1)};
+    if (level.tileIndex(tile.x(), tile.y()) != kWallTile) {
+      return tile;
+    }
+  }
+}
+
+unordered_map<int64_t, Solid const> const& GeneratedWorld::solids() const {
+  return solids_;
+}
@@ -0,0 +1,94 @@
+/*
+ * Copyright (C) 2021-2023 Jean-Marie BARAN (jeanmarie.baran@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Refer to 'COPYING.txt' for the full notice.
+ */
+
+#ifndef BENCH_GENERATED_WORLD_HPP_INCLUDED
+#define BENCH_GENERATED_WORLD_HPP_INCLUDED
+
+#include <libflatkiss/model/model.hpp>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief Levels of random walls and the assets they need, made up for the
+ * benchmarks instead of loaded from files.
+ *
+ * Tiles are 16x16 pixels: tile 0 is free and tile 1 is a wall. Characters
+ * stand on 12x12 pixels at the bottom of their 16x16 sprites. The same seed
+ * always gives the same world.
+ */
+class GeneratedWorld {
+ public:
+  /**
+   * @param max_levels Maximum number of levels, so that they do not move.
+   */
+  GeneratedWorld(int64_t max_levels);
+  GeneratedWorld(GeneratedWorld const& other) = delete;
+  GeneratedWorld(GeneratedWorld&& other) = delete;
+  GeneratedWorld& operator=(GeneratedWorld const& other) = delete;
+  GeneratedWorld& operator=(GeneratedWorld&& other) = delete;
+  /**
+   * @brief Add a template of characters driven by the given controller.
+   *
+   * @param behaviour Behaviour run by a bytecode controller, or nullptr.
+   */
+  CharacterTemplate const& addCharacterTemplate(ControllerType controller_type,
+                                                int64_t behaviour_index,
+                                                Behaviour const* behaviour);
+  /**
+   * @brief Add a level whose tiles are walls with the given probability.
+   *
+   * @param wall_percent Probability of a tile being a wall, in percents.
+   */
+  Level& addLevel(int64_t width, int64_t height, int64_t wall_percent,
+                  uint64_t seed);
+  Solid const& characterSolid() const;
+  std::vector<Level>& levels();
+  /**
+   * @brief Spawn characters on random free tiles of a level.
+   */
+  void populate(Level& level, CharacterTemplate const& character_template,
+                int64_t num_characters, uint64_t seed) const;
+  /**
+   * @brief Returns a random free tile of a level.
+   *
+   * @param draw Number of the draw, different draws give different tiles.
+   */
+  static TilePosition randomFreeTile(Level const& level, uint64_t seed,
+                                     uint64_t draw);
+  std::unordered_map<int64_t, Solid const> const& solids() const;
+
+ private:
+  std::unordered_map<int64_t, Solid const> solids_;
+  Spriteset const tileset_;
+  Spriteset const characterset_;
+  AnimationPlayer const tile_animations_;
+  AnimationPlayer const character_animations_;
+  TileSolidMapper const tile_solid_mapper_;
+  ActionSpriteMapper const action_sprite_mapper_;
+  std::vector<std::unique_ptr<CharacterTemplate>> character_templates_;
+  std::vector<Level> levels_;
+  int64_t const max_levels_;
+
+  static int64_t constexpr kCharacterSolid{0};
+  static int64_t constexpr kWallSolid{1};
+  static uint16_t constexpr kWallTile{1};
+};
+
+#endif
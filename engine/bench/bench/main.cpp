@@ -0,0 +1,418 @@
+/*
+ * Copyright (C) 2021-2023 Jean-Marie BARAN (jeanmarie.baran@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Refer to 'COPYING.txt' for the full notice.
+ */
+
+#include <algorithm>
+#include <bench/generated_world.hpp>
+#include <chrono>
+#include <cstdlib>
+#include <exception>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <libflatkiss/logic/bytecode_character_controller.hpp>
+#include <libflatkiss/logic/keyboard_character_controller.hpp>
+#include <libflatkiss/logic/logic.hpp>
+#include <libflatkiss/logic/scripted_character_controller.hpp>
+#include <libflatkiss/logic/stroll_character_controller.hpp>
+#include <libflatkiss/media/media.hpp>
+#include <libflatkiss/model/model.hpp>
+#include <memory>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using std::accumulate;
+using std::cerr;
+using std::cout;
+using std::endl;
+using std::exception;
+using std::fixed;
+using std::make_unique;
+using std::max;
+using std::max_element;
+using std::milli;
+using std::numeric_limits;
+using std::runtime_error;
+using std::setprecision;
+using std::sort;
+using std::string;
+using std::swap;
+using std::to_string;
+using std::unique_ptr;
+using std::vector;
+using std::chrono::duration;
+using std::chrono::steady_clock;
+
+/* The figures of the commits come from this program: the levels are generated
+ * from fixed seeds, so that anyone can run the same queries again. */
+uint64_t const kSeed(42);
+// Same as the flow field cache of a level simulation.
+int64_t const kFlowFieldCacheCapacity(16);
+// Same as the path cache of a level simulation.
+int64_t const kPathCacheCapacity(1024);
+// Number of nodes the path requests may expand at each tick.
+int64_t const kPathBudgetExpansions(8192);
+// Index of the script of CharacterScripts strolling like the stroll controller.
+int64_t const kStrollScript(1);
+// Index of the script of CharacterScripts walking to random goals.
+int64_t const kWanderScript(3);
+// Probability of a tile being a wall, in percents.
+int64_t const kWallPercent(20);
+
+/**
+ * @brief Print the mean, median and maximum of durations in milliseconds.
+ */
+void printDurations(string const& name, vector<double> durations_ms) {
+  sort(durations_ms.begin(), durations_ms.end());
+  double const mean_ms{accumulate(durations_ms.cbegin(), durations_ms.cend(),
+                                  0.0) /
+                       static_cast<double>(durations_ms.size())};
+  cout << fixed << setprecision(3) << name << ": " << durations_ms.size()
+       << " runs, mean " << mean_ms << " ms, median "
+       << durations_ms[durations_ms.size() / 2] << " ms, max "
+       << durations_ms.back() << " ms" << endl;
+}
+
+/**
+ * @brief Time grid A* queries between random free tiles.
+ */
+void benchmarkPathFinder(int64_t level_size, int64_t num_queries) {
+  GeneratedWorld world{1};
+  Level& level{world.addLevel(level_size, level_size, kWallPercent, kSeed)};
+  TileSolids const tile_solids{level, world.solids()};
+  ClearanceMap const clearance_map{tile_solids};
+  PathFinder path_finder;
+  vector<TilePosition> path;
+  vector<double> durations_ms;
+  int64_t num_found{0};
+  for (int64_t i{0}; i < num_queries; i++) {
+    TilePosition const start{
+        GeneratedWorld::randomFreeTile(level, kSeed, 2 * i)};
+    TilePosition const goal{
+        GeneratedWorld::randomFreeTile(level, kSeed, 2 * i + 1)};
+    auto const begin{steady_clock::now()};
+    num_found += path_finder.findPath(world.characterSolid(), start, goal,
+                                      clearance_map, path)
+                     ? 1
+                     : 0;
+    durations_ms.push_back(
+        duration<double, milli>(steady_clock::now() - begin).count());
+  }
+  printDurations("Grid A* on " + to_string(level_size) + "x" +
+                     to_string(level_size) + " tiles (" +
+                     to_string(num_found) + " paths found)",
+                 durations_ms);
+}
+
+/**
+ * @brief Time the building of the hierarchical path finder, then its queries
+ * between random free tiles: the waypoints alone, and the full paths.
+ */
+void benchmarkHierarchicalPathFinder(int64_t level_size, int64_t num_queries) {
+  GeneratedWorld world{1};
+  Level& level{world.addLevel(level_size, level_size, kWallPercent, kSeed)};
+  TileSolids const tile_solids{level, world.solids()};
+  ClearanceMap const clearance_map{tile_solids};
+  PathCache path_cache{kPathCacheCapacity};
+  string const size{to_string(level_size) + "x" + to_string(level_size)};
+
+  auto const build_begin{steady_clock::now()};
+  HierarchicalPathFinder path_finder{world.characterSolid(), clearance_map,
+                                     path_cache};
+  printDurations("HPA* build on " + size + " tiles",
+                 {duration<double, milli>(steady_clock::now() - build_begin)
+                      .count()});
+
+  /* The queries are between different tiles, so that none reuses the route of
+   * a previous one from the path cache. */
+  vector<TilePosition> path;
+  vector<double> waypoints_durations_ms;
+  vector<double> path_durations_ms;
+  int64_t num_found{0};
+  for (int64_t i{0}; i < 2 * num_queries; i++) {
+    TilePosition const start{
+        GeneratedWorld::randomFreeTile(level, kSeed, 2 * i)};
+    TilePosition const goal{
+        GeneratedWorld::randomFreeTile(level, kSeed, 2 * i + 1)};
+    auto const begin{steady_clock::now()};
+    if (i < num_queries) {
+      num_found += path_finder.findAbstractPath(start, goal, path) ? 1 : 0;
+      waypoints_durations_ms.push_back(
+          duration<double, milli>(steady_clock::now() - begin).count());
+    } else {
+      path_finder.findPath(start, goal, path);
+      path_durations_ms.push_back(
+          duration<double, milli>(steady_clock::now() - begin).count());
+    }
+  }
+  printDurations("HPA* waypoints on " + size + " tiles (" +
+                     to_string(num_found) + " paths found)",
+                 waypoints_durations_ms);
+  printDurations("HPA* full paths on " + size + " tiles",
+                 path_durations_ms);
+}
+
+/**
+ * @brief Add a level of characters split evenly between the controller types.
+ *
+ * Bytecode controllers run the given behaviour, scripted controllers stroll.
+ * The same arguments always give the same level.
+ */
+Level& addPopulatedLevel(GeneratedWorld& world,
+                         vector<ControllerType> const& controller_types,
+                         int64_t level_size, int64_t num_characters,
+                         Behaviour const& behaviour) {
+  Level& level{world.addLevel(level_size, level_size, kWallPercent, kSeed)};
+  int64_t const num_characters_per_type{
+      num_characters / static_cast<int64_t>(controller_types.size())};
+  for (int64_t i{0}; i < controller_types.size(); i++) {
+    ControllerType const controller_type{controller_types[i]};
+    CharacterTemplate const& character_template{world.addCharacterTemplate(
+        controller_type,
+        controller_type == ControllerType::kScriptedController ? kStrollScript
+                                                               : 0,
+        controller_type == ControllerType::kBytecodeController ? &behaviour
+                                                               : nullptr)};
+    world.populate(level, character_template, num_characters_per_type,
+                   kSeed + i);
+  }
+  return level;
+}
+
+/**
+ * @brief Time the ticks of a level simulation whose characters are all
+ * observed, so that every controller is called when it asks to.
+ *
+ * The controllers are stored in per-type pools and ticked type by type
+ * (refer to CharacterControllerPool).
+ */
+vector<double> timePooledTicks(GeneratedWorld const& world, Level& level,
+                               int64_t num_ticks) {
+  LevelSimulation simulation{level, world.solids(),
+                             LevelOfDetail{0, 0, 1, 1}, kSeed};
+  Spriteset const& tileset{level.spriteset()};
+  simulation.addObserver(PositionedRectangle{
+      Position{0, 0}, Rectangle{level.widthInTiles() * tileset.spritesWidth(),
+                                level.heightInTiles() *
+                                    tileset.spritesHeight()}});
+  Navigator const navigator{world.solids()};
+  EventHandler const event_handler;
+  vector<double> durations_ms;
+  for (int64_t i{0}; i < num_ticks; i++) {
+    auto const begin{steady_clock::now()};
+    simulation.tick(event_handler, navigator, kPathBudgetExpansions);
+    durations_ms.push_back(
+        duration<double, milli>(steady_clock::now() - begin).count());
+  }
+  return durations_ms;
+}
+
+/**
+ * @brief Time the same ticks as timePooledTicks(), with the controllers stored
+ * as they were before the pools: each behind its own unique_ptr, in an
+ * arbitrary order, called through the virtual onTick().
+ *
+ * The controllers are called at the ticks they ask for like in a level
+ * simulation, so that only the layout differs.
+ */
+vector<double> timeLegacyTicks(GeneratedWorld const& world, Level& level,
+                               int64_t num_ticks) {
+  vector<unique_ptr<CharacterController>> controllers;
+  for (int64_t i{0}; i < level.numCharacterSlots(); i++) {
+    if (!level.isCharacterAlive(i)) {
+      continue;
+    }
+    Character const character{level.character(i)};
+    switch (character.controllers()[0]) {
+      case ControllerType::kKeyboardController:
+        controllers.push_back(
+            make_unique<KeyboardCharacterController>(character));
+        break;
+      case ControllerType::kStrollController:
+        controllers.push_back(
+            make_unique<StrollCharacterController>(character, kSeed));
+        break;
+      case ControllerType::kBytecodeController:
+        controllers.push_back(
+            make_unique<BytecodeCharacterController>(character, kSeed));
+        break;
+      case ControllerType::kScriptedController:
+        controllers.push_back(
+            make_unique<ScriptedCharacterController>(character, kSeed));
+        break;
+      default:
+        throw runtime_error("Unknown controller type");
+    }
+  }
+  // Shuffled, so that neighbours in the vector are of any type.
+  RandomStream random_stream{kSeed, 0, 0};
+  for (int64_t i{static_cast<int64_t>(controllers.size()) - 1}; i > 0; i--) {
+    swap(controllers[i], controllers[random_stream.between(0, i)]);
+  }
+
+  TileSolids const tile_solids{level, world.solids()};
+  ClearanceMap const clearance_map{tile_solids};
+  FlowFieldCache flow_fields{clearance_map, kFlowFieldCacheCapacity};
+  PathCache path_cache{kPathCacheCapacity};
+  PathRequestService path_requests{clearance_map, path_cache};
+  MoveBatch move_batch;
+  Navigator const navigator{world.solids()};
+  EventHandler const event_handler;
+  vector<int64_t> wake_ticks(controllers.size(), 1);
+  vector<double> durations_ms;
+  for (int64_t tick{1}; tick <= num_ticks; tick++) {
+    auto const begin{steady_clock::now()};
+    TickContext const context{tick, event_handler, move_batch, level,
+                              clearance_map, flow_fields, path_requests};
+    for (int64_t i{0}; i < controllers.size(); i++) {
+      if (wake_ticks[i] > tick) {
+        continue;
+      }
+      int64_t const next_tick{controllers[i]->onTick(context)};
+      wake_ticks[i] = next_tick == CharacterController::kWakeOnEvent
+                          ? numeric_limits<int64_t>::max()
+                          : max(next_tick, tick + 1);
+    }
+    move_batch.resolve(navigator, tile_solids, clearance_map);
+    path_requests.process(tick, kPathBudgetExpansions);
+    durations_ms.push_back(
+        duration<double, milli>(steady_clock::now() - begin).count());
+  }
+  return durations_ms;
+}
+
+/**
+ * @brief Time the ticks of the same characters in both layouts of the
+ * controllers: per-type pools, and the former unique_ptr in arbitrary order.
+ *
+ * @param population Name of the characters, for the output.
+ * @param controller_types The characters are split evenly between these types.
+ */
+void benchmarkTicks(string const& population,
+                    vector<ControllerType> const& controller_types,
+                    int64_t level_size, int64_t num_characters,
+                    int64_t num_ticks) {
+  using Opcode = Behaviour::Opcode;
+  /* Pick a direction where the character fits, walk 16 steps towards it, and
+   * start again. */
+  Behaviour const random_walk{{{Opcode::kRandom, 0, 3},
+                               {Opcode::kFits, 1, 0},
+                               {Opcode::kJumpIfZero, 1, 0},
+                               {Opcode::kSet, 2, 16},
+                               {Opcode::kMove, 0, 0},
+                               {Opcode::kAdd, 2, -1},
+                               {Opcode::kJumpIfNotZero, 2, 4},
+                               {Opcode::kJump, 0, 0}}};
+
+  // Two copies of the same level, one per layout.
+  GeneratedWorld world{2};
+  Level& pooled_level{addPopulatedLevel(world, controller_types, level_size,
+                                        num_characters, random_walk)};
+  Level& legacy_level{addPopulatedLevel(world, controller_types, level_size,
+                                        num_characters, random_walk)};
+  if (pooled_level.stateHash() != legacy_level.stateHash()) {
+    throw runtime_error("The levels of both layouts differ");
+  }
+
+  string const name{"Ticks of " + to_string(num_characters) + " " +
+                    population + " characters on " + to_string(level_size) +
+                    "x" + to_string(level_size) + " tiles"};
+  printDurations(name + ", per-type pools",
+                 timePooledTicks(world, pooled_level, num_ticks));
+  printDurations(name + ", unique_ptr in arbitrary order",
+                 timeLegacyTicks(world, legacy_level, num_ticks));
+}
+
+/**
+ * @brief Run a level of wandering characters and record the hash of the level
+ * after each tick, as a replay without inputs would.
+ *
+ * The characters walk along paths from the path request service, so the
+ * hashes only match between runs if the requests are solved at the same ticks.
+ */
+vector<uint64_t> replayWanderers(int64_t level_size, int64_t num_characters,
+                                 int64_t num_ticks) {
+  GeneratedWorld world{1};
+  Level& level{world.addLevel(level_size, level_size, kWallPercent, kSeed)};
+  world.populate(level,
+                 world.addCharacterTemplate(ControllerType::kScriptedController,
+                                            kWanderScript, nullptr),
+                 num_characters, kSeed);
+  LevelSimulation simulation{level, world.solids(),
+                             LevelOfDetail{0, 0, 1, 1}, kSeed};
+  Spriteset const& tileset{level.spriteset()};
+  simulation.addObserver(PositionedRectangle{
+      Position{0, 0}, Rectangle{level.widthInTiles() * tileset.spritesWidth(),
+                                level.heightInTiles() *
+                                    tileset.spritesHeight()}});
+  Navigator const navigator{world.solids()};
+  EventHandler const event_handler;
+  vector<uint64_t> hashes;
+  for (int64_t i{0}; i < num_ticks; i++) {
+    simulation.tick(event_handler, navigator, kPathBudgetExpansions);
+    hashes.push_back(level.stateHash());
+  }
+  return hashes;
+}
+
+/**
+ * @brief Replay the same level of wandering characters twice and check that
+ * the hashes match at every tick.
+ */
+void checkReplay(int64_t level_size, int64_t num_characters,
+                 int64_t num_ticks) {
+  vector<uint64_t> const first{
+      replayWanderers(level_size, num_characters, num_ticks)};
+  vector<uint64_t> const second{
+      replayWanderers(level_size, num_characters, num_ticks)};
+  for (int64_t i{0}; i < num_ticks; i++) {
+    if (first[i] != second[i]) {
+      throw runtime_error("The replays of wanderers diverged at tick " +
+                          to_string(i + 1));
+    }
+  }
+  cout << "Replays of " << num_characters << " wanderers on " << level_size
+       << "x" << level_size << " tiles: " << num_ticks
+       << " ticks, same hashes" << endl;
+}
+
+int main(int argc, char* argv[]) {
+  try {
+    checkReplay(256, 1000, 2000);
+    benchmarkPathFinder(256, 200);
+    benchmarkPathFinder(512, 100);
+    benchmarkHierarchicalPathFinder(1024, 200);
+    benchmarkTicks("stroll", {ControllerType::kStrollController}, 512, 10000,
+                   500);
+    benchmarkTicks("bytecode", {ControllerType::kBytecodeController}, 512,
+                   10000, 500);
+    benchmarkTicks("scripted", {ControllerType::kScriptedController}, 512,
+                   10000, 500);
+    benchmarkTicks("mixed",
+                   {ControllerType::kStrollController,
+                    ControllerType::kBytecodeController,
+                    ControllerType::kScriptedController},
+                   512, 9999, 500);
+    return EXIT_SUCCESS;
+  } catch (exception& exception) {
+    cerr << exception.what() << endl;
+    return EXIT_FAILURE;
+  }
+}
@@ -39,9 +39,33 @@ Configuration::Configuration(string const& file_path) {
   inipp::get_value(ini.sections["ActionSpriteMaps"], "path",
                    action_sprite_maps_path_);
   inipp::get_value(ini.sections["Animations"], "path", animations_path_);
+  inipp::get_value(ini.sections["Behaviours"], "path", behaviours_path_);
   inipp::get_value(ini.sections["Characters"], "path", characters_path_);
+  inipp::get_value(ini.sections["Engine"], "dormant_tick_interval",
+                   engine_dormant_tick_interval_);
+  inipp::get_value(ini.sections["Engine"], "fast_forward_ticks",
+                   engine_fast_forward_ticks_);
+  inipp::get_value(ini.sections["Engine"], "headless", engine_headless_);
+  inipp::get_value(ini.sections["Engine"], "lod_coarse_tick_interval",
+                   engine_lod_coarse_tick_interval_);
+  inipp::get_value(ini.sections["Engine"], "lod_far_distance",
+                   engine_lod_far_distance_);
+  inipp::get_value(ini.sections["Engine"], "lod_near_distance",
+                   engine_lod_near_distance_);
+  inipp::get_value(ini.sections["Engine"], "lod_reduced_tick_interval",
+                   engine_lod_reduced_tick_interval_);
+  inipp::get_value(ini.sections["Engine"], "path_budget_expansions",
+                   engine_path_budget_expansions_);
+  inipp::get_value(ini.sections["Engine"], "seed", engine_seed_);
   inipp::get_value(ini.sections["Engine"], "tick_duration_ms",
                    engine_tick_duration_ms_);
+  inipp::get_value(ini.sections["Engine"], "worker_count",
+                   engine_worker_count_);
+  inipp::get_value(ini.sections["Hashes"], "compare_path",
+                   hashes_compare_path_);
+  inipp::get_value(ini.sections["Hashes"], "output_path", hashes_output_path_);
+  inipp::get_value(ini.sections["Input"], "record_path", input_record_path_);
+  inipp::get_value(ini.sections["Input"], "replay_path", input_replay_path_);
   inipp::get_value(ini.sections["Levels"], "path", levels_path_);
   inipp::get_value(ini.sections["Solids"], "path", solids_path_);
   inipp::get_value(ini.sections["Sprites"], "files_directory",
@@ -61,12 +85,68 @@ string const& Configuration::actionSpriteMapsPath() const {
 
 string Configuration::animationsPath() const { return animations_path_; }
 
+string const& Configuration::behavioursPath() const {
+  return behaviours_path_;
+}
+
 string const& Configuration::charactersPath() const { return characters_path_; }
 
+int64_t Configuration::engineDormantTickInterval() const {
+  return engine_dormant_tick_interval_;
+}
+
+int64_t Configuration::engineFastForwardTicks() const {
+  return engine_fast_forward_ticks_;
+}
+
+bool Configuration::engineHeadless() const { return engine_headless_; }
+
+int64_t Configuration::engineLodCoarseTickInterval() const {
+  return engine_lod_coarse_tick_interval_;
+}
+
+int64_t Configuration::engineLodFarDistance() const {
+  return engine_lod_far_distance_;
+}
+
+int64_t Configuration::engineLodNearDistance() const {
+  return engine_lod_near_distance_;
+}
+
+int64_t Configuration::engineLodReducedTickInterval() const {
+  return engine_lod_reduced_tick_interval_;
+}
+
+int64_t Configuration::enginePathBudgetExpansions() const {
+  return engine_path_budget_expansions_;
+}
+
+uint64_t Configuration::engineSeed() const { return engine_seed_; }
+
 int64_t Configuration::engineTickDurationMs() const {
   return engine_tick_duration_ms_;
 }
 
+int64_t Configuration::engineWorkerCount() const {
+  return engine_worker_count_;
+}
+
+string const& Configuration::hashesComparePath() const {
+  return hashes_compare_path_;
+}
+
+string const& Configuration::hashesOutputPath() const {
+  return hashes_output_path_;
+}
+
+string const& Configuration::inputRecordPath() const {
+  return input_record_path_;
+}
+
+string const& Configuration::inputReplayPath() const {
+  return input_replay_path_;
+}
+
 string const& Configuration::levelsPath() const { return levels_path_; }
 
 string Configuration::spritesetFilesDirectory() const {
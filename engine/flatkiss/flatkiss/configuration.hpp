@@ -33,8 +33,48 @@ class Configuration {
   Configuration(std::string const& file_path);
   std::string const& actionSpriteMapsPath() const;
   std::string animationsPath() const;
+  std::string const& behavioursPath() const;
   std::string const& charactersPath() const;
+  int64_t engineDormantTickInterval() const;
+  /**
+   * @brief Whether to run without a window, as fast as possible (e.g. to
+   * replay a session as a benchmark).
+   */
+  bool engineHeadless() const;
+  /**
+   * @brief Number of ticks to run at once when starting, as fast as possible.
+   */
+  int64_t engineFastForwardTicks() const;
+  int64_t engineLodCoarseTickInterval() const;
+  int64_t engineLodFarDistance() const;
+  int64_t engineLodNearDistance() const;
+  int64_t engineLodReducedTickInterval() const;
+  int64_t enginePathBudgetExpansions() const;
+  uint64_t engineSeed() const;
   int64_t engineTickDurationMs() const;
+  /**
+   * @brief Number of threads running jobs besides the main thread.
+   *
+   * The levels behind the warps are only preloaded with at least one.
+   */
+  int64_t engineWorkerCount() const;
+  /**
+   * @brief Path of a file of hashes to compare those of the world with, or
+   * empty.
+   */
+  std::string const& hashesComparePath() const;
+  /**
+   * @brief Path of the file to write the hashes of the world into, or empty.
+   */
+  std::string const& hashesOutputPath() const;
+  /**
+   * @brief Path of the file to record the inputs into, or empty.
+   */
+  std::string const& inputRecordPath() const;
+  /**
+   * @brief Path of the file to replay the inputs from, or empty.
+   */
+  std::string const& inputReplayPath() const;
   std::string const& levelsPath() const;
   std::string const& solidsPath() const;
   std::string spritesetFilesDirectory() const;
@@ -46,8 +86,23 @@ class Configuration {
  private:
   std::string action_sprite_maps_path_{};
   std::string animations_path_{};
+  std::string behaviours_path_{};
   std::string characters_path_{};
+  int64_t engine_dormant_tick_interval_{0};
+  int64_t engine_fast_forward_ticks_{0};
+  bool engine_headless_{false};
+  int64_t engine_lod_coarse_tick_interval_{0};
+  int64_t engine_lod_far_distance_{0};
+  int64_t engine_lod_near_distance_{0};
+  int64_t engine_lod_reduced_tick_interval_{0};
+  int64_t engine_path_budget_expansions_{0};
+  uint64_t engine_seed_{0};
   int64_t engine_tick_duration_ms_{0};
+  int64_t engine_worker_count_{0};
+  std::string hashes_compare_path_{};
+  std::string hashes_output_path_{};
+  std::string input_record_path_{};
+  std::string input_replay_path_{};
   std::string levels_path_{};
   std::string solids_path_{};
   std::string spriteset_files_directory_{};
@@ -24,29 +24,75 @@
 #include <fstream>
 #include <iostream>
 #include <libflatkiss/data/data.hpp>
+#include <libflatkiss/job/job.hpp>
 #include <libflatkiss/logic/logic.hpp>
 #include <libflatkiss/media/media.hpp>
 #include <libflatkiss/model/model.hpp>
 #include <memory>
+#include <optional>
 #include <stdexcept>
 #include <string>
 #include <thread>
 #include <unordered_map>
 #include <vector>
 
+using std::abs;
 using std::cerr;
+using std::cout;
 using std::endl;
 using std::exception;
-using std::move;
-using std::unique_ptr;
+using std::ifstream;
+using std::invalid_argument;
+using std::milli;
+using std::ofstream;
+using std::optional;
+using std::runtime_error;
+using std::to_string;
 using std::unordered_map;
 using std::vector;
+using std::chrono::duration;
 using std::chrono::milliseconds;
+using std::chrono::steady_clock;
 using std::this_thread::sleep_for;
 
 int64_t const kCharacterSizePixels(16);
+// Distance in tiles from a warp at which its destination is preloaded.
+int64_t const kWarpPreloadDistance(4);
 int64_t const kViewportSize(160);
 
+/**
+ * @brief Compare the hash of the world at a tick with the next line of a
+ * reference file of hashes.
+ *
+ * A reference which ends early or cannot be read counts as a divergence, so
+ * that a truncated or unrelated file does not pass.
+ */
+void compareHash(ifstream& hashes_reference, int64_t tick,
+                 uint64_t state_hash) {
+  int64_t reference_tick{0};
+  uint64_t reference_hash{0};
+  if (!(hashes_reference >> reference_tick >> reference_hash)) {
+    throw runtime_error(
+        (hashes_reference.eof() ? "The reference hashes end before tick "
+                                : "Unreadable reference hash at tick ") +
+        to_string(tick));
+  }
+  if (reference_tick != tick || reference_hash != state_hash) {
+    throw runtime_error("The world diverged at tick " + to_string(tick));
+  }
+}
+
+/**
+ * @brief Returns the tile under the centre of a character.
+ */
+TilePosition tileOf(Character const& character) {
+  Spriteset const& spriteset{character.spriteset()};
+  return TilePosition{
+      (character.x() + spriteset.spritesWidth() / 2) / spriteset.spritesWidth(),
+      (character.y() + spriteset.spritesHeight() / 2) /
+          spriteset.spritesHeight()};
+}
+
 void updateViewport(Character const& character, PositionedRectangle& viewport,
                     Level const& level, int64_t tiles_width,
                     int64_t tiles_height) {
@@ -78,53 +124,161 @@ void updateViewport(Character const& character, PositionedRectangle& viewport,
 
 void start() {
   Configuration configuration{"configuration.ini"};
+  bool const headless{configuration.engineHeadless()};
+
+  // Without a window, the inputs can only come from a replay.
+  optional<InputReplayer> replayer;
+  if (!configuration.inputReplayPath().empty()) {
+    replayer.emplace(configuration.inputReplayPath());
+  } else if (headless) {
+    throw invalid_argument("The headless mode needs inputs to replay");
+  }
+  optional<InputRecorder> recorder;
+  if (!configuration.inputRecordPath().empty()) {
+    recorder.emplace(configuration.inputRecordPath());
+  }
+  /* The hash of the world after each tick, written as "<tick> <hash>" lines,
+   * and read back to find where a run diverges from another. */
+  optional<ofstream> hashes_output;
+  if (!configuration.hashesOutputPath().empty()) {
+    hashes_output.emplace(configuration.hashesOutputPath());
+  }
+  optional<ifstream> hashes_reference;
+  if (!configuration.hashesComparePath().empty()) {
+    hashes_reference.emplace(configuration.hashesComparePath());
+    if (!hashes_reference->is_open()) {
+      throw invalid_argument("Failed to open file: " +
+                             configuration.hashesComparePath());
+    }
+  }
 
   PositionedRectangle viewport{Position{0, 0},
                                Rectangle{kViewportSize, kViewportSize}};
-  Window const window{FLATKISS_PROJECT_NAME, viewport.rectangle().width(),
-                      viewport.rectangle().height()};
-
-  Data data{
-      configuration.actionSpriteMapsPath(), configuration.animationsPath(),
-      configuration.charactersPath(),       configuration.levelsPath(),
-      configuration.solidsPath(),           configuration.spritesetsPath(),
-      configuration.tileSolidMapsPath()};
-  Model model{data.load()};
-
-  Navigator navigator{model.solids()};
-  vector<unique_ptr<CharacterController>> character_controllers;
-  for (auto& level : model.levels()) {
-    CharacterControllerLoader::load(level.characters(), character_controllers);
+  optional<Window> window;
+  if (!headless) {
+    window.emplace(FLATKISS_PROJECT_NAME, viewport.rectangle().width(),
+                   viewport.rectangle().height());
   }
 
-  Logic logic{move(character_controllers), navigator};
+  JobSystem job_system{configuration.engineWorkerCount()};
+
+  Data data{configuration.actionSpriteMapsPath(),
+            configuration.animationsPath(),
+            configuration.behavioursPath(),
+            configuration.charactersPath(),
+            configuration.levelsPath(),
+            configuration.solidsPath(),
+            configuration.spritesetsPath(),
+            configuration.tileSolidMapsPath()};
+  Model model{data.load(job_system)};
 
-  Level& level{model.levels()[0]};
+  Logic logic{model.levels(),
+              model.solids(),
+              configuration.enginePathBudgetExpansions(),
+              configuration.engineDormantTickInterval(),
+              {configuration.engineLodNearDistance(),
+               configuration.engineLodFarDistance(),
+               configuration.engineLodReducedTickInterval(),
+               configuration.engineLodCoarseTickInterval()},
+              configuration.engineSeed(),
+              job_system};
 
-  TextureAtlas textures{model.spritesets(), window.renderer(),
-                        configuration.spritesetFilesDirectory(),
-                        configuration.spritesetFilesPrefix(),
-                        configuration.spritesetFilesSuffix()};
+  /* The level viewed, and the character followed by the viewport. Taking a
+   * warp swaps them for those of the destination level, which was preloaded
+   * in the background as the character approached the warp. */
+  // FIXME: Way to define which level is viewed first.
+  int64_t level_index{0};
+  LevelSimulation* simulation{&logic.simulation(level_index)};
+  int64_t viewport_observer{simulation->addObserver(viewport)};
+  Level* level{&simulation->level()};
+  // FIXME: Way to define which character is followed by the viewport.
+  int64_t player_index{0};
+  // A warp is taken when entering its tile, not when arriving on it.
+  TilePosition player_tile{-1, -1};
+
+  optional<TextureAtlas const> textures;
+  if (window) {
+    textures.emplace(model.spritesets(), window->renderer(),
+                     configuration.spritesetFilesDirectory(),
+                     configuration.spritesetFilesPrefix(),
+                     configuration.spritesetFilesSuffix());
+  }
 
   bool quit = false;
   int64_t tick(0);
+  if (configuration.engineFastForwardTicks() > 0) {
+    double const ticks_per_second{
+        logic.fastForward(tick + 1, configuration.engineFastForwardTicks())};
+    tick += configuration.engineFastForwardTicks();
+    cout << "Fast forwarded " << tick << " ticks at " << ticks_per_second
+         << " ticks per second" << endl;
+  }
   EventHandler event_handler;
+  auto const start_time{steady_clock::now()};
   while (!quit) {
-    window.render(level, viewport, tick++, textures, level.characters());
-    sleep_for(milliseconds(configuration.engineTickDurationMs()));
-    event_handler.handleEvents();
+    if (window) {
+      window->render(*level, viewport, tick, *textures, job_system);
+      sleep_for(milliseconds(configuration.engineTickDurationMs()));
+    }
+    tick++;
+    if (replayer) {
+      replayer->replay(event_handler);
+    } else {
+      event_handler.handleEvents();
+    }
+    if (recorder) {
+      recorder->record(event_handler);
+    }
     quit = event_handler.mustQuit();
-    for (auto& controller : logic.characterControllers()) {
-      // FIXME: Move all this into logic.
-      controller->onTick(tick, event_handler, logic.navigator(), level);
+    logic.tick(tick, event_handler);
+    uint64_t const state_hash{logic.stateHash()};
+    if (hashes_output) {
+      *hashes_output << tick << ' ' << state_hash << '\n';
+    }
+    if (hashes_reference) {
+      compareHash(*hashes_reference, tick, state_hash);
     }
-    // FIXME: Way to define which character is followed by the viewport.
-    if (!logic.characterControllers().empty()) {
-      updateViewport(level.characters()[0], viewport, level,
-                     level.spriteset().spritesWidth(),
-                     level.spriteset().spritesHeight());
+    if (player_index < level->numCharacterSlots() &&
+        level->isCharacterAlive(player_index)) {
+      Character const player{level->character(player_index)};
+      TilePosition const tile{tileOf(player)};
+      for (Warp const& warp : level->warps()) {
+        if (abs(warp.position().x() - tile.x()) <= kWarpPreloadDistance &&
+            abs(warp.position().y() - tile.y()) <= kWarpPreloadDistance) {
+          logic.preload(warp.destinationLevelIndex(), player.solid());
+        }
+      }
+      Warp const* warp{level->warpAt(tile)};
+      if (warp != nullptr && tile != player_tile) {
+        player_index = logic.warp(level_index, player, *warp).index();
+        simulation->removeObserver(viewport_observer);
+        level_index = warp->destinationLevelIndex();
+        simulation = &logic.simulation(level_index);
+        viewport_observer = simulation->addObserver(viewport);
+        level = &simulation->level();
+        player_tile = warp->destination();
+      } else {
+        player_tile = tile;
+      }
+      updateViewport(level->character(player_index), viewport, *level,
+                     level->spriteset().spritesWidth(),
+                     level->spriteset().spritesHeight());
+      simulation->moveObserver(viewport_observer, viewport.position());
     }
   }
+
+  // A reference longer than the run does not come from the same inputs.
+  int64_t reference_tick{0};
+  if (hashes_reference && *hashes_reference >> reference_tick) {
+    throw runtime_error("The reference hashes go on after tick " +
+                        to_string(tick));
+  }
+
+  if (headless) {
+    duration<double, milli> const elapsed{steady_clock::now() -
+                                               start_time};
+    cout << tick << " ticks in " << elapsed.count() << " ms" << endl;
+  }
 }
 
 int main(int argc, char* argv[]) {
@@ -20,6 +20,7 @@
 #include <libflatkiss/data/data.hpp>
 #include <libflatkiss/data/loader_action_sprite_mapper.hpp>
 #include <libflatkiss/data/loader_animation_player.hpp>
+#include <libflatkiss/data/loader_behaviour.hpp>
 #include <libflatkiss/data/loader_character_template.hpp>
 #include <libflatkiss/data/loader_level.hpp>
 #include <libflatkiss/data/loader_solid.hpp>
@@ -31,35 +32,56 @@ using std::unordered_map;
 using std::vector;
 
 Data::Data(string const& action_sprite_maps_path, string const& animations_path,
-           string const& characters_path, string const& levels_path,
-           string const& solids_path, string const& spritesets_path,
-           string const& tile_solid_maps_path)
+           string const& behaviours_path, string const& characters_path,
+           string const& levels_path, string const& solids_path,
+           string const& spritesets_path, string const& tile_solid_maps_path)
     : action_sprite_maps_path_{action_sprite_maps_path},
       animations_path_{animations_path},
+      behaviours_path_{behaviours_path},
       characters_path_{characters_path},
       levels_path_{levels_path},
       solids_path_{solids_path},
       spritesets_path_{spritesets_path},
       tile_solid_maps_path_{tile_solid_maps_path} {}
 
-Model Data::load() const {
-  vector<Spriteset> spritesets{LoaderSpriteset::load(spritesets_path_)};
-  unordered_map<int64_t, AnimationPlayer const> animation_players{
-      LoaderAnimationPlayer::load(animations_path_)};
-  unordered_map<int64_t, ActionSpriteMapper const> action_sprite_mappers{
-      LoaderActionSpriteMapper::load(action_sprite_maps_path_)};
-  unordered_map<int64_t, TileSolidMapper const> tile_solid_mappers{
-      LoaderTileSolidMapper::load(tile_solid_maps_path_)};
-  unordered_map<int64_t, Solid const> solids{LoaderSolid::load(solids_path_)};
+Model Data::load(JobSystem& job_system) const {
+  // The templates and the levels depend on these, which depend on nothing.
+  vector<Spriteset> spritesets;
+  unordered_map<int64_t, AnimationPlayer const> animation_players;
+  unordered_map<int64_t, ActionSpriteMapper const> action_sprite_mappers;
+  unordered_map<int64_t, TileSolidMapper const> tile_solid_mappers;
+  unordered_map<int64_t, Solid const> solids;
+  unordered_map<int64_t, Behaviour const> behaviours;
+  JobGroup loaders;
+  job_system.run(loaders, [this, &spritesets]() {
+    spritesets = LoaderSpriteset::load(spritesets_path_);
+  });
+  job_system.run(loaders, [this, &animation_players]() {
+    animation_players = LoaderAnimationPlayer::load(animations_path_);
+  });
+  job_system.run(loaders, [this, &action_sprite_mappers]() {
+    action_sprite_mappers =
+        LoaderActionSpriteMapper::load(action_sprite_maps_path_);
+  });
+  job_system.run(loaders, [this, &tile_solid_mappers]() {
+    tile_solid_mappers = LoaderTileSolidMapper::load(tile_solid_maps_path_);
+  });
+  job_system.run(loaders, [this, &solids]() {
+    solids = LoaderSolid::load(solids_path_);
+  });
+  job_system.run(loaders, [this, &behaviours]() {
+    behaviours = LoaderBehaviour::load(behaviours_path_);
+  });
+  job_system.wait(loaders);
 
   vector<CharacterTemplate> character_templates{LoaderCharacterTemplate::load(
       characters_path_, spritesets, action_sprite_mappers, animation_players,
-      solids)};
+      behaviours, solids)};
   vector<Level> levels{LoaderLevel::load(levels_path_, spritesets,
                                          animation_players, tile_solid_mappers,
                                          character_templates)};
 
-  return Model{
-      action_sprite_mappers, animation_players, levels, solids, spritesets,
-      tile_solid_mappers};
+  return Model{action_sprite_mappers, animation_players, behaviours,
+               character_templates, levels, solids, spritesets,
+               tile_solid_mappers};
 }
@@ -20,6 +20,7 @@
 #ifndef LIBFLATKISS_DATA_DATA_HPP_INCLUDED
 #define LIBFLATKISS_DATA_DATA_HPP_INCLUDED
 
+#include <libflatkiss/job/job.hpp>
 #include <libflatkiss/model/model.hpp>
 #include <string>
 #include <vector>
@@ -28,14 +29,23 @@ class Data {
  public:
   Data(std::string const& action_sprite_maps_path,
              std::string const& animations_path,
+             std::string const& behaviours_path,
              std::string const& characters_path, std::string const& levels_path,
              std::string const& solids_path, std::string const& spritesets_path,
              std::string const& tile_solid_maps_path);
-  Model load() const;
+  /**
+   * @brief Load all the assets.
+   *
+   * The files which do not depend on each other are loaded in parallel.
+   *
+   * @param job_system Job system running the loaders.
+   */
+  Model load(JobSystem& job_system) const;
 
  private:
   std::string const action_sprite_maps_path_;
   std::string const animations_path_;
+  std::string const behaviours_path_;
   std::string const characters_path_;
   std::string const levels_path_;
   std::string const solids_path_;
@@ -0,0 +1,84 @@
+/*
+ * Copyright (C) 2021-2023 Jean-Marie BARAN (jeanmarie.baran@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Refer to 'COPYING.txt' for the full notice.
+ */
+
+#include <fstream>
+#include <libflatkiss/data/loader_behaviour.hpp>
+#include <libflatkiss/data/stream_reader.hpp>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+using std::forward_as_tuple;
+using std::ifstream;
+using std::invalid_argument;
+using std::ios;
+using std::istream;
+using std::move;
+using std::piecewise_construct;
+using std::string;
+using std::to_string;
+using std::unordered_map;
+using std::vector;
+
+unordered_map<int64_t, Behaviour const> LoaderBehaviour::load(
+    string const& file_path) {
+  unordered_map<int64_t, Behaviour const> behaviours_per_index;
+  ifstream stream;
+  stream.open(file_path, ios::in | ios::binary);
+  if (stream.is_open()) {
+    while (stream.peek() != istream::traits_type::eof()) {
+      int64_t behaviour_index{StreamReader::read(stream, 2)};
+      int64_t num_instructions{StreamReader::read(stream, 2)};
+      behaviours_per_index.emplace(
+          piecewise_construct, forward_as_tuple(behaviour_index),
+          forward_as_tuple(move(loadBehaviour(num_instructions, stream))));
+    }
+    stream.close();
+  } else {
+    throw ios::failure("Failed to open file: " + file_path);
+  }
+
+  return behaviours_per_index;
+}
+
+Behaviour LoaderBehaviour::loadBehaviour(int64_t num_instructions,
+                                         ifstream& behaviours_stream) {
+  vector<Behaviour::Instruction> instructions;
+  instructions.reserve(num_instructions);
+  for (int64_t i{0}; i < num_instructions; i++) {
+    int64_t opcode{StreamReader::read(behaviours_stream, 1)};
+    int64_t register_index{StreamReader::read(behaviours_stream, 1)};
+    // The operand is signed.
+    int64_t operand{StreamReader::read(behaviours_stream, 2)};
+    instructions.push_back({opcodeIdentifierToOpcode(opcode),
+                            static_cast<uint8_t>(register_index),
+                            static_cast<int16_t>(operand)});
+  }
+
+  return Behaviour{move(instructions)};
+}
+
+Behaviour::Opcode LoaderBehaviour::opcodeIdentifierToOpcode(
+    uint8_t opcode_identifier) {
+  if (opcode_identifier > static_cast<uint8_t>(Behaviour::Opcode::kWait)) {
+    throw invalid_argument("Unknown opcode identifier: " +
+                           to_string(opcode_identifier));
+  }
+  return static_cast<Behaviour::Opcode>(opcode_identifier);
+}
@@ -39,6 +39,10 @@ LoaderCharacterTemplate::controllerTypeIdentifierToControllerType(
       return ControllerType::kKeyboardController;
     case 1:
       return ControllerType::kStrollController;
+    case 2:
+      return ControllerType::kBytecodeController;
+    case 3:
+      return ControllerType::kScriptedController;
     default:
       throw invalid_argument("Unknown controller type identifier: " +
                              to_string(controller_type_identifier));
@@ -50,6 +54,7 @@ vector<CharacterTemplate> LoaderCharacterTemplate::load(
     unordered_map<int64_t, ActionSpriteMapper const> const&
         action_sprite_mappers,
     unordered_map<int64_t, AnimationPlayer const> const& animation_players,
+    unordered_map<int64_t, Behaviour const> const& behaviours,
     unordered_map<int64_t, Solid const> const& solids) {
   vector<CharacterTemplate> character_templates;
   ifstream stream;
@@ -60,12 +65,18 @@ vector<CharacterTemplate> LoaderCharacterTemplate::load(
       int64_t action_sprite_mapper_index{StreamReader::read(stream, 2)};
       int64_t animations_index{StreamReader::read(stream, 2)};
       int64_t solid_index{StreamReader::read(stream, 2)};
-      int64_t controller_type{StreamReader::read(stream, 1)};
+      ControllerType controller_type{controllerTypeIdentifierToControllerType(
+          StreamReader::read(stream, 1))};
+      int64_t behaviour_index{StreamReader::read(stream, 2)};
+      // The behaviour is only run by the bytecode controller.
+      Behaviour const* behaviour{
+          controller_type == ControllerType::kBytecodeController
+              ? &behaviours.at(behaviour_index)
+              : nullptr};
       character_templates.emplace_back(
           action_sprite_mappers.at(action_sprite_mapper_index),
-          animation_players.at(animations_index),
-          vector<ControllerType>{
-              controllerTypeIdentifierToControllerType(controller_type)},
+          animation_players.at(animations_index), behaviour, behaviour_index,
+          vector<ControllerType>{controller_type},
           spritesets[spriteset_index], solids.at(solid_index));
     }
     stream.close();
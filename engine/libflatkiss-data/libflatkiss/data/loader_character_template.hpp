@@ -37,6 +37,7 @@ class LoaderCharacterTemplate {
           action_sprite_mappers,
       std::unordered_map<int64_t, AnimationPlayer const> const&
           animation_players,
+      std::unordered_map<int64_t, Behaviour const> const& behaviours,
       std::unordered_map<int64_t, Solid const> const& solids);
 
  private:
@@ -21,12 +21,17 @@
 #include <libflatkiss/data/loader_level.hpp>
 #include <libflatkiss/data/stream_reader.hpp>
 #include <libflatkiss/model/level.hpp>
+#include <libflatkiss/model/warp.hpp>
+#include <stdexcept>
+#include <string>
 
 using std::ifstream;
+using std::invalid_argument;
 using std::ios;
 using std::istream;
 using std::streamsize;
 using std::string;
+using std::to_string;
 using std::unordered_map;
 using std::vector;
 
@@ -49,36 +54,61 @@ vector<Level> LoaderLevel::load(
       int64_t animation_player_index{StreamReader::read(stream, 2)};
       int64_t tile_solid_mapper_index{StreamReader::read(stream, 2)};
       int64_t num_characters{StreamReader::read(stream, 2)};
-      vector<Character> characters;
+      int64_t num_warps{StreamReader::read(stream, 2)};
+      vector<int64_t> character_template_indices;
+      vector<Position> character_positions;
       for (int i{0}; i < num_characters; i++) {
         int64_t index{StreamReader::read(stream, 2)};
         int64_t x{StreamReader::read(stream, 2)};
         int64_t y{StreamReader::read(stream, 2)};
-        characters.emplace_back(
-            character_templates[index].spriteset(),
-            character_templates[index].action_sprite_mapper(),
-            character_templates[index].animation_player(),
-            character_templates[index].controllers(),
-            character_templates[index].solid(),
-            Position{x * spritesets[spriteset_index].spritesWidth(),
-                     y * spritesets[spriteset_index].spritesHeight()});
+        character_template_indices.push_back(index);
+        character_positions.emplace_back(
+            x * spritesets[spriteset_index].spritesWidth(),
+            y * spritesets[spriteset_index].spritesHeight());
+      }
+      vector<Warp> warps;
+      for (int64_t i{0}; i < num_warps; i++) {
+        int64_t x{StreamReader::read(stream, 2)};
+        int64_t y{StreamReader::read(stream, 2)};
+        int64_t destination_level_index{StreamReader::read(stream, 2)};
+        int64_t destination_x{StreamReader::read(stream, 2)};
+        int64_t destination_y{StreamReader::read(stream, 2)};
+        warps.emplace_back(TilePosition{x, y}, destination_level_index,
+                           TilePosition{destination_x, destination_y});
       }
       // Two bytes per tile.
-      int64_t const size_in_bytes{width_in_tiles * height_in_tiles * 2};
-      vector<uint16_t> tiles(size_in_bytes, 0);
-      for (int64_t i{0}; i < size_in_bytes; i++) {
+      int64_t const num_tiles{width_in_tiles * height_in_tiles};
+      vector<uint16_t> tiles(num_tiles, 0);
+      for (int64_t i{0}; i < num_tiles; i++) {
         tiles[i] = StreamReader::read(stream, 2);
       }
       levels.emplace_back(move(tiles), width_in_tiles, height_in_tiles,
                           spritesets[spriteset_index],
                           animation_players.at(animation_player_index),
-                          characters,
                           tile_solid_mappers.at(tile_solid_mapper_index));
+      for (int64_t i{0}; i < num_characters; i++) {
+        levels.back().spawnCharacter(
+            character_templates[character_template_indices[i]],
+            character_positions[i]);
+      }
+      for (Warp const& warp : warps) {
+        levels.back().addWarp(warp);
+      }
     }
     stream.close();
   } else {
     throw ios::failure("Failed to open file: " + file_path);
   }
 
+  // A warp may lead to a level loaded after its own, hence checked last.
+  for (Level const& level : levels) {
+    for (Warp const& warp : level.warps()) {
+      if (warp.destinationLevelIndex() >= levels.size()) {
+        throw invalid_argument("Warp to an unknown level: " +
+                               to_string(warp.destinationLevelIndex()));
+      }
+    }
+  }
+
   return levels;
 }
@@ -0,0 +1,33 @@
+/*
+ * Copyright (C) 2021-2023 Jean-Marie BARAN (jeanmarie.baran@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Refer to 'COPYING.txt' for the full notice.
+ */
+
+#include <libflatkiss/job/job_group.hpp>
+
+using std::exception_ptr;
+using std::lock_guard;
+using std::mutex;
+
+bool JobGroup::isDone() const { return num_pending_jobs_ == 0; }
+
+void JobGroup::fail(exception_ptr exception) {
+  lock_guard<mutex> const lock{exception_mutex_};
+  if (!exception_) {
+    exception_ = exception;
+  }
+}
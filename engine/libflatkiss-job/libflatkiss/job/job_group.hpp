@@ -0,0 +1,60 @@
+/*
+ * Copyright (C) 2021-2023 Jean-Marie BARAN (jeanmarie.baran@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Refer to 'COPYING.txt' for the full notice.
+ */
+
+#ifndef LIBFLATKISS_JOB_JOB_GROUP_HPP_INCLUDED
+#define LIBFLATKISS_JOB_JOB_GROUP_HPP_INCLUDED
+
+#include <atomic>
+#include <cstdint>
+#include <exception>
+#include <mutex>
+
+/**
+ * @brief Jobs run together, waited for together (refer to JobSystem::run()
+ * and JobSystem::wait()).
+ *
+ * A group must outlive its jobs: it is waited for before being destroyed.
+ */
+class JobGroup {
+ public:
+  JobGroup() = default;
+  JobGroup(JobGroup const& other) = delete;
+  JobGroup(JobGroup&& other) = delete;
+  JobGroup& operator=(JobGroup const& other) = delete;
+  JobGroup& operator=(JobGroup&& other) = delete;
+  /**
+   * @brief Whether all the jobs of the group are over.
+   */
+  bool isDone() const;
+
+ private:
+  friend class JobSystem;
+
+  std::atomic<int64_t> num_pending_jobs_{0};
+  std::mutex exception_mutex_;
+  // The first exception thrown by a job of the group.
+  std::exception_ptr exception_;
+
+  /**
+   * @brief Keep the exception thrown by a job, unless one was kept already.
+   */
+  void fail(std::exception_ptr exception);
+};
+
+#endif
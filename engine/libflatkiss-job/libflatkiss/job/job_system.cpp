@@ -0,0 +1,154 @@
+/*
+ * Copyright (C) 2021-2023 Jean-Marie BARAN (jeanmarie.baran@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Refer to 'COPYING.txt' for the full notice.
+ */
+
+#include <libflatkiss/job/job_system.hpp>
+#include <stdexcept>
+#include <utility>
+
+using std::current_exception;
+using std::function;
+using std::invalid_argument;
+using std::lock_guard;
+using std::logic_error;
+using std::make_unique;
+using std::move;
+using std::mutex;
+using std::optional;
+using std::thread;
+using std::rethrow_exception;
+using std::unique_lock;
+using std::this_thread::yield;
+
+thread_local JobSystem const* JobSystem::worker_job_system_{nullptr};
+thread_local int64_t JobSystem::worker_queue_index_{0};
+
+JobSystem::JobSystem(int64_t worker_count) {
+  if (worker_count < 0) {
+    throw invalid_argument("The number of workers cannot be negative");
+  }
+
+  for (int64_t i{0}; i <= worker_count; i++) {
+    queues_.push_back(make_unique<WorkQueue>());
+  }
+  for (int64_t i{1}; i <= worker_count; i++) {
+    workers_.emplace_back([this, i]() { work(i); });
+  }
+}
+
+JobSystem::~JobSystem() {
+  {
+    lock_guard<mutex> const lock{sleep_mutex_};
+    stopping_ = true;
+  }
+  wake_up_.notify_all();
+  for (thread& worker : workers_) {
+    worker.join();
+  }
+  // Without workers, the jobs nobody waited for are still there.
+  while (runOne(0)) {
+  }
+}
+
+int64_t JobSystem::queueIndex() const {
+  return worker_job_system_ == this ? worker_queue_index_ : 0;
+}
+
+void JobSystem::run(JobGroup& group, function<void()>&& function) {
+  group.num_pending_jobs_++;
+  queues_[queueIndex()]->push(WorkQueue::Job{move(function), &group});
+  {
+    lock_guard<mutex> const lock{sleep_mutex_};
+    num_queued_jobs_++;
+  }
+  wake_up_.notify_one();
+}
+
+void JobSystem::runInBackground(JobGroup& group,
+                                function<void()>&& function) {
+  if (workers_.empty()) {
+    throw logic_error("Background jobs need at least one worker");
+  }
+
+  group.num_pending_jobs_++;
+  background_queue_.push(WorkQueue::Job{move(function), &group});
+  {
+    lock_guard<mutex> const lock{sleep_mutex_};
+    num_queued_jobs_++;
+  }
+  wake_up_.notify_one();
+}
+
+void JobSystem::runJob(WorkQueue::Job& job) {
+  num_queued_jobs_--;
+  try {
+    job.function();
+  } catch (...) {
+    job.group->fail(current_exception());
+  }
+  // Last, the waiting thread may destroy the group as soon as it is done.
+  job.group->num_pending_jobs_--;
+}
+
+bool JobSystem::runOne(int64_t queue_index) {
+  optional<WorkQueue::Job> job{queues_[queue_index]->pop()};
+  for (int64_t i{1}; !job && i < queues_.size(); i++) {
+    job = queues_[(queue_index + i) % queues_.size()]->steal();
+  }
+  if (!job) {
+    return false;
+  }
+
+  runJob(*job);
+  return true;
+}
+
+void JobSystem::wait(JobGroup& group) {
+  int64_t const queue_index{queueIndex()};
+  while (!group.isDone()) {
+    if (!runOne(queue_index)) {
+      // The last jobs of the group run on other threads.
+      yield();
+    }
+  }
+  if (group.exception_) {
+    rethrow_exception(group.exception_);
+  }
+}
+
+void JobSystem::work(int64_t queue_index) {
+  worker_job_system_ = this;
+  worker_queue_index_ = queue_index;
+  while (true) {
+    if (runOne(queue_index)) {
+      continue;
+    }
+    if (optional<WorkQueue::Job> job{background_queue_.steal()}) {
+      runJob(*job);
+      continue;
+    }
+    unique_lock<mutex> lock{sleep_mutex_};
+    wake_up_.wait(lock,
+                  [this]() { return stopping_ || num_queued_jobs_ > 0; });
+    if (stopping_ && num_queued_jobs_ == 0) {
+      return;
+    }
+  }
+}
+
+int64_t JobSystem::workerCount() const { return workers_.size(); }
@@ -0,0 +1,169 @@
+/*
+ * Copyright (C) 2021-2023 Jean-Marie BARAN (jeanmarie.baran@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Refer to 'COPYING.txt' for the full notice.
+ */
+
+#ifndef LIBFLATKISS_JOB_JOB_SYSTEM_HPP_INCLUDED
+#define LIBFLATKISS_JOB_JOB_SYSTEM_HPP_INCLUDED
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <libflatkiss/job/job_group.hpp>
+#include <libflatkiss/job/work_queue.hpp>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Pool of worker threads shared by everything which runs in parallel
+ * (loading, simulation, rendering).
+ *
+ * Each worker has its own queue of jobs. A worker runs the jobs of its queue
+ * first, then steals from the others when it runs out, so that the work
+ * spreads by itself whatever the split. The threads which are not workers
+ * (e.g. the main thread) push into a queue of their own.
+ *
+ * Waiting for a group (fork/join) runs jobs meanwhile rather than blocking, so
+ * jobs can wait for the jobs they run, and a job system without workers runs
+ * everything on the waiting thread.
+ *
+ * Long jobs which nobody waits for right away (e.g. preloading a level) run in
+ * the background instead: only the workers run them, when they have nothing
+ * else to do, so that they never hold up a thread waiting for a group (e.g.
+ * the main thread in the middle of a frame).
+ */
+class JobSystem {
+ public:
+  /**
+   * @param worker_count Number of worker threads, besides the threads which
+   * wait for jobs. Zero runs all the jobs on the waiting threads.
+   */
+  JobSystem(int64_t worker_count);
+  JobSystem(JobSystem const& other) = delete;
+  JobSystem(JobSystem&& other) = delete;
+  JobSystem& operator=(JobSystem const& other) = delete;
+  JobSystem& operator=(JobSystem&& other) = delete;
+  /**
+   * @brief Run the pending jobs, then stop the workers.
+   */
+  ~JobSystem();
+  /**
+   * @brief Call a function over a range of indices, split into parts run in
+   * parallel, and wait for all of them.
+   *
+   * The range is split in halves until the parts are no larger than the grain,
+   * each half but the last run as a job which splits further: idle workers
+   * steal the largest parts first.
+   *
+   * @param first First index of the range.
+   * @param last Past the last index of the range.
+   * @param grain_size Largest part run in one call.
+   * @param function Called with the first and past the last indices of each
+   * part.
+   */
+  template <typename Function>
+  void parallelFor(int64_t first, int64_t last, int64_t grain_size,
+                   Function const& function) {
+    JobGroup group;
+    try {
+      split(group, first, last, grain_size, function);
+    } catch (...) {
+      // Not rethrown yet, the other parts may still use the group.
+      group.fail(std::current_exception());
+    }
+    wait(group);
+  }
+  /**
+   * @brief Run a function in parallel, as part of a group.
+   *
+   * @param group Group of the job, to wait for (refer to wait()).
+   * @param function The job. What it throws is rethrown by wait().
+   */
+  void run(JobGroup& group, std::function<void()>&& function);
+  /**
+   * @brief Run a function on a worker, when the workers have no other job.
+   *
+   * Waiting for the group does not run the job on the waiting thread, it only
+   * waits for a worker to run it. Needs at least one worker.
+   *
+   * @param group Group of the job, to wait for (refer to wait()).
+   * @param function The job. What it throws is rethrown by wait().
+   */
+  void runInBackground(JobGroup& group, std::function<void()>&& function);
+  /**
+   * @brief Wait for all the jobs of a group, running jobs meanwhile (but not
+   * background ones).
+   *
+   * Rethrows the first exception thrown by a job of the group, once all of
+   * them are over.
+   */
+  void wait(JobGroup& group);
+  int64_t workerCount() const;
+
+ private:
+  // The queue of the threads which are not workers, then one per worker.
+  std::vector<std::unique_ptr<WorkQueue>> queues_;
+  // Jobs run by the workers only, oldest first.
+  WorkQueue background_queue_;
+  std::vector<std::thread> workers_;
+  std::atomic<int64_t> num_queued_jobs_{0};
+  // Guards the sleep of the workers, and stopping_.
+  std::mutex sleep_mutex_;
+  std::condition_variable wake_up_;
+  bool stopping_{false};
+
+  /**
+   * @brief Returns the index of the queue of the calling thread.
+   */
+  int64_t queueIndex() const;
+  /**
+   * @brief Run one job, from the given queue or stolen from another.
+   *
+   * @return bool Whether there was a job to run.
+   */
+  bool runOne(int64_t queue_index);
+  /**
+   * @brief Run a job which was taken from a queue.
+   */
+  void runJob(WorkQueue::Job& job);
+  template <typename Function>
+  void split(JobGroup& group, int64_t first, int64_t last, int64_t grain_size,
+             Function const& function) {
+    while (last - first > grain_size) {
+      int64_t const middle{first + (last - first) / 2};
+      run(group, [this, &group, middle, last, grain_size, &function]() {
+        split(group, middle, last, grain_size, function);
+      });
+      last = middle;
+    }
+    function(first, last);
+  }
+  /**
+   * @brief Body of the worker threads.
+   */
+  void work(int64_t queue_index);
+
+  // The job system of the calling thread, if it is a worker, and its queue.
+  static thread_local JobSystem const* worker_job_system_;
+  static thread_local int64_t worker_queue_index_;
+};
+
+#endif
@@ -0,0 +1,52 @@
+/*
+ * Copyright (C) 2021-2023 Jean-Marie BARAN (jeanmarie.baran@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Refer to 'COPYING.txt' for the full notice.
+ */
+
+#include <libflatkiss/job/work_queue.hpp>
+#include <utility>
+
+using std::lock_guard;
+using std::move;
+using std::mutex;
+using std::nullopt;
+using std::optional;
+
+optional<WorkQueue::Job> WorkQueue::pop() {
+  lock_guard<mutex> const lock{mutex_};
+  if (jobs_.empty()) {
+    return nullopt;
+  }
+  Job job{move(jobs_.back())};
+  jobs_.pop_back();
+  return job;
+}
+
+void WorkQueue::push(Job&& job) {
+  lock_guard<mutex> const lock{mutex_};
+  jobs_.push_back(move(job));
+}
+
+optional<WorkQueue::Job> WorkQueue::steal() {
+  lock_guard<mutex> const lock{mutex_};
+  if (jobs_.empty()) {
+    return nullopt;
+  }
+  Job job{move(jobs_.front())};
+  jobs_.pop_front();
+  return job;
+}
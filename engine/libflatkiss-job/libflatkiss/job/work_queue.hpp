@@ -0,0 +1,58 @@
+/*
+ * Copyright (C) 2021-2023 Jean-Marie BARAN (jeanmarie.baran@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Refer to 'COPYING.txt' for the full notice.
+ */
+
+#ifndef LIBFLATKISS_JOB_WORK_QUEUE_HPP_INCLUDED
+#define LIBFLATKISS_JOB_WORK_QUEUE_HPP_INCLUDED
+
+#include <deque>
+#include <functional>
+#include <libflatkiss/job/job_group.hpp>
+#include <mutex>
+#include <optional>
+
+/**
+ * @brief The jobs pushed by one thread, which the other threads may steal.
+ *
+ * The owner pushes and pops at the back (the most recent job, whose data is
+ * likely still in its cache), the thieves steal at the front (the oldest job,
+ * usually the largest part of a split range).
+ */
+class WorkQueue {
+ public:
+  struct Job {
+    std::function<void()> function;
+    JobGroup* group;
+  };
+
+  /**
+   * @brief Returns the most recent job, if any.
+   */
+  std::optional<Job> pop();
+  void push(Job&& job);
+  /**
+   * @brief Returns the oldest job, if any.
+   */
+  std::optional<Job> steal();
+
+ private:
+  std::mutex mutex_;
+  std::deque<Job> jobs_;
+};
+
+#endif
@@ -0,0 +1,161 @@
+/*
+ * Copyright (C) 2021-2023 Jean-Marie BARAN (jeanmarie.baran@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Refer to 'COPYING.txt' for the full notice.
+ */
+
+#include <libflatkiss/logic/bytecode_character_controller.hpp>
+#include <libflatkiss/logic/random_stream.hpp>
+#include <utility>
+#include <vector>
+
+using std::move;
+using std::vector;
+
+BytecodeCharacterController::BytecodeCharacterController(
+    Character const& character, uint64_t seed)
+    : character_{character}, behaviour_{*character.behaviour()}, seed_{seed} {}
+
+Character const& BytecodeCharacterController::character() const {
+  return character_;
+}
+
+int64_t BytecodeCharacterController::onTick(TickContext const& context) {
+  vector<Behaviour::Instruction> const& instructions{behaviour_.instructions()};
+  if (frame_.clock < 0) {
+    frame_.clock = context.tick;
+  }
+
+  /* Run the script through all the ticks since the last call, summing the
+   * steps. Running past the last instruction halts it. */
+  int64_t delta_x{0};
+  int64_t delta_y{0};
+  bool is_idle{false};
+  int64_t num_instructions{0};
+  while (frame_.clock <= context.tick &&
+         frame_.program_counter < instructions.size()) {
+    Behaviour::Instruction const& instruction{
+        instructions[frame_.program_counter++]};
+    int32_t& value{frame_.registers[instruction.register_index]};
+    switch (instruction.opcode) {
+      case Behaviour::Opcode::kHalt:
+        frame_.program_counter = instructions.size();
+        break;
+      case Behaviour::Opcode::kSet:
+        value = instruction.operand;
+        break;
+      case Behaviour::Opcode::kAdd:
+        value = static_cast<int32_t>(int64_t{value} + instruction.operand);
+        break;
+      case Behaviour::Opcode::kRandom: {
+        // Drawn in order, whenever the script happens to be run.
+        RandomStream random_stream{
+            seed_,
+            (static_cast<uint64_t>(character_.index()) << 32U) |
+                character_.generation(),
+            frame_.num_draws++};
+        value = static_cast<int32_t>(
+            random_stream.between(0, instruction.operand));
+        break;
+      }
+      case Behaviour::Opcode::kFits: {
+        Vector const step{
+            movementTowards(frame_.registers[instruction.operand])};
+        value = context.clearance_map.fits(
+                    character_.solid().boundingBox(),
+                    character_.position() + Vector{delta_x + step.dx(),
+                                                   delta_y + step.dy()})
+                    ? 1
+                    : 0;
+        break;
+      }
+      case Behaviour::Opcode::kJump:
+        frame_.program_counter = instruction.operand;
+        break;
+      case Behaviour::Opcode::kJumpIfZero:
+        if (value == 0) {
+          frame_.program_counter = instruction.operand;
+        }
+        break;
+      case Behaviour::Opcode::kJumpIfNotZero:
+        if (value != 0) {
+          frame_.program_counter = instruction.operand;
+        }
+        break;
+      case Behaviour::Opcode::kMove: {
+        Vector const step{movementTowards(value)};
+        delta_x += step.dx() * kSpeedInPixels;
+        delta_y += step.dy() * kSpeedInPixels;
+        is_idle = false;
+        frame_.clock++;
+        num_instructions = 0;
+        break;
+      }
+      case Behaviour::Opcode::kFace:
+        character_.updateFacingDirection(movementTowards(value), Vector::kZero);
+        break;
+      case Behaviour::Opcode::kWait:
+        is_idle = true;
+        frame_.clock += instruction.operand;
+        num_instructions = 0;
+        break;
+    }
+
+    // A script looping without moving nor waiting is paused until next tick.
+    if (++num_instructions > kMaxInstructionsPerTick) {
+      frame_.clock++;
+      num_instructions = 0;
+    }
+  }
+
+  bool const is_halted{frame_.program_counter >= instructions.size()};
+  if (delta_x != 0 || delta_y != 0) {
+    idle_after_move_ = is_idle || is_halted;
+    context.move_batch.submit(*this, character_.solid(),
+                              character_.position(), Vector{delta_x, delta_y},
+                              0, kSpeedInPixels, true);
+  } else if (is_idle || is_halted) {
+    // Reset the animation as the character is not moving anymore.
+    character_.updateFacingDirection(Vector::kZero, Vector::kZero);
+  }
+  return is_halted ? kWakeOnEvent : frame_.clock;
+}
+
+void BytecodeCharacterController::onMoved(
+    Navigator::MoveIntent const& intent, Navigator::MoveResult const& result) {
+  Position final_position{result.position};
+  character_.updateFacingDirection(intent.desired_displacement,
+                                   final_position - character_.position());
+  character_.moveTo(move(final_position));
+  if (idle_after_move_) {
+    character_.updateFacingDirection(Vector::kZero, Vector::kZero);
+    idle_after_move_ = false;
+  }
+}
+
+Vector BytecodeCharacterController::movementTowards(int64_t direction) {
+  int64_t constexpr kNumDirections{4};
+  switch ((direction % kNumDirections + kNumDirections) % kNumDirections) {
+    case kWest:
+      return Vector{-1, 0};
+    case kSouth:
+      return Vector{0, 1};
+    case kEast:
+      return Vector{1, 0};
+    default:
+      return Vector{0, -1};
+  }
+}
@@ -0,0 +1,81 @@
+/*
+ * Copyright (C) 2021-2023 Jean-Marie BARAN (jeanmarie.baran@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Refer to 'COPYING.txt' for the full notice.
+ */
+
+#ifndef LIBFLATKISS_LOGIC_BYTECODE_CHARACTER_CONTROLLER_HPP_INCLUDED
+#define LIBFLATKISS_LOGIC_BYTECODE_CHARACTER_CONTROLLER_HPP_INCLUDED
+
+#include <array>
+#include <libflatkiss/logic/character_controller.hpp>
+#include <libflatkiss/logic/navigator.hpp>
+#include <libflatkiss/media/media.hpp>
+#include <libflatkiss/model/model.hpp>
+
+/**
+ * @brief Character controller which runs the behaviour of its character.
+ *
+ * The behaviour is bytecode loaded with the assets (refer to Behaviour). The
+ * whole state of the script is a small frame held by the controller, so that
+ * the controllers of this type are ticked as one tight loop over their frames
+ * (refer to CharacterControllerPool).
+ *
+ * Each tick, the script runs until it moves or waits. When the controller is
+ * called late, the script runs through all the ticks it missed, and the steps
+ * of these ticks are made as one move.
+ */
+class BytecodeCharacterController final : public CharacterController {
+ public:
+  /**
+   * @param character The character to control, which must have a behaviour.
+   * @param seed Seed of the random values drawn by the behaviour.
+   */
+  BytecodeCharacterController(Character const& character, uint64_t seed);
+  Character const& character() const override;
+  int64_t onTick(TickContext const& context) override;
+  void onMoved(Navigator::MoveIntent const& intent,
+               Navigator::MoveResult const& result) override;
+
+  static ControllerType constexpr kType{ControllerType::kBytecodeController};
+
+ private:
+  struct Frame {
+    std::array<int32_t, Behaviour::kNumRegisters> registers{};
+    // Tick up to which the behaviour ran, or -1 before it starts.
+    int64_t clock{-1};
+    uint32_t num_draws{0};
+    uint16_t program_counter{0};
+  };
+
+  Character character_;
+  Behaviour const& behaviour_;
+  Frame frame_;
+  // Whether the last move submitted is followed by idle time.
+  bool idle_after_move_{false};
+  uint64_t const seed_;
+  // Instructions run in a row without moving nor waiting, before yielding.
+  static int64_t constexpr kMaxInstructionsPerTick{256};
+  static int64_t constexpr kSpeedInPixels{1};
+
+  /**
+   * @brief Returns the displacement of one step in the direction held by a
+   * register.
+   */
+  static Vector movementTowards(int64_t direction);
+};
+
+#endif
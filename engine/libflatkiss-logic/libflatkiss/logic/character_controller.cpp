@@ -16,3 +16,8 @@
  *
  * Refer to 'COPYING.txt' for the full notice.
  */
+
+#include <libflatkiss/logic/character_controller.hpp>
+
+void CharacterController::onMoved(Navigator::MoveIntent const& intent,
+                                  Navigator::MoveResult const& result) {}
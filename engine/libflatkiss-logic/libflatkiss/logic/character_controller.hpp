@@ -21,19 +21,57 @@
 #define LIBFLATKISS_LOGIC_CHARACTER_CONTROLLER_HPP_INCLUDED
 
 #include <libflatkiss/logic/navigator.hpp>
-#include <libflatkiss/media/media.hpp>
+#include <libflatkiss/logic/tick_context.hpp>
 #include <libflatkiss/model/model.hpp>
 
 class CharacterController {
  public:
   CharacterController() = default;
-  CharacterController(CharacterController const& other) = delete;
+  // Copied for snapshots, by the pool which knows the actual type.
+  CharacterController(CharacterController const& other) = default;
   CharacterController(CharacterController&& other) = default;
   CharacterController& operator=(CharacterController const& other) = delete;
   CharacterController& operator=(CharacterController&& other) = default;
   virtual ~CharacterController() = default;
-  virtual void onTick(int64_t tick, EventHandler const& event_handler,
-                      Navigator const& navigator, Level const& level) = 0;
+  /**
+   * @brief Returns the character driven by the controller.
+   */
+  virtual Character const& character() const = 0;
+  /**
+   * @brief Called for deciding what the character does.
+   *
+   * The controller tells when it must be called next: usually at the next tick,
+   * but a controller with nothing to do can sleep until a later tick, or until
+   * it is woken up (refer to LevelSimulation::wake()). Sleeping controllers
+   * cost nothing.
+   *
+   * Moves are not applied right away: they are submitted to the batch, and
+   * their outcome is given back through onMoved() once the batch is resolved.
+   * The clearance map of the level tells quickly where the character would not
+   * fit, and its flow fields lead characters to shared goals. Paths are not
+   * searched right away either: they are requested to the path request
+   * service and ready on a later tick.
+   *
+   * Far from the observers, the controller may be called later than it asked
+   * (refer to LevelOfDetail). It must then catch up with the ticks it missed,
+   * e.g. by moving further at once.
+   *
+   * @param context The current tick and the services of the level.
+   * @return int64_t The tick at which to call the controller next, or
+   * kWakeOnEvent.
+   */
+  virtual int64_t onTick(TickContext const& context) = 0;
+  /**
+   * @brief Called with the outcome of a move submitted during onTick().
+   *
+   * @param intent The move which was submitted.
+   * @param result Where the navigator allows the character to go.
+   */
+  virtual void onMoved(Navigator::MoveIntent const& intent,
+                       Navigator::MoveResult const& result);
+
+  // Returned by onTick() for sleeping until woken up.
+  static int64_t constexpr kWakeOnEvent{-1};
 };
 
 #endif
@@ -17,30 +17,36 @@
  * Refer to 'COPYING.txt' for the full notice.
  */
 
+#include <libflatkiss/logic/bytecode_character_controller.hpp>
 #include <libflatkiss/logic/character_controller_loader.hpp>
 #include <libflatkiss/logic/keyboard_character_controller.hpp>
+#include <libflatkiss/logic/scripted_character_controller.hpp>
 #include <libflatkiss/logic/stroll_character_controller.hpp>
 #include <stdexcept>
 
 using std::invalid_argument;
-using std::make_unique;
 using std::to_string;
-using std::unique_ptr;
-using std::vector;
 
-void CharacterControllerLoader::load(
-    vector<Character>& characters,
-    vector<unique_ptr<CharacterController>>& into) {
-  for (int64_t i{0}; i < characters.size(); i++) {
-    switch (characters[i].controllers()[0]) {
-      case ControllerType::kKeyboardController:
-        into.push_back(make_unique<KeyboardCharacterController>(characters[i]));
-        break;
-      case ControllerType::kStrollController:
-        into.push_back(make_unique<StrollCharacterController>(characters[i]));
-        break;
-      default:
-        throw invalid_argument("Unknown controller type");
-    }
+void CharacterControllerLoader::load(Character const& character,
+                                     uint64_t seed,
+                                     CharacterControllerPool& into) {
+  switch (character.controllers()[0]) {
+    case ControllerType::kKeyboardController:
+      into.add<KeyboardCharacterController>(character);
+      break;
+    case ControllerType::kStrollController:
+      into.add<StrollCharacterController>(character, seed);
+      break;
+    case ControllerType::kBytecodeController:
+      if (character.behaviour() == nullptr) {
+        throw invalid_argument("The character has no behaviour");
+      }
+      into.add<BytecodeCharacterController>(character, seed);
+      break;
+    case ControllerType::kScriptedController:
+      into.add<ScriptedCharacterController>(character, seed);
+      break;
+    default:
+      throw invalid_argument("Unknown controller type");
   }
 }
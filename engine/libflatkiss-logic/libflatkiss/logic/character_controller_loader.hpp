@@ -20,15 +20,20 @@
 #ifndef LIBFLATKISS_LOGIC_CHARACTER_CONTROLLER_LOADER_HPP_INCLUDED
 #define LIBFLATKISS_LOGIC_CHARACTER_CONTROLLER_LOADER_HPP_INCLUDED
 
-#include <libflatkiss/logic/character_controller.hpp>
+#include <libflatkiss/logic/character_controller_pool.hpp>
 #include <libflatkiss/model/model.hpp>
-#include <memory>
-#include <vector>
 
 class CharacterControllerLoader {
  public:
-  static void load(std::vector<Character>& characters,
-                   std::vector<std::unique_ptr<CharacterController>>& into);
+  /**
+   * @brief Create the controller of the character.
+   *
+   * @param character The character to control.
+   * @param seed Seed of the random values drawn by the controller.
+   * @param into Pool in which the controller is created.
+   */
+  static void load(Character const& character, uint64_t seed,
+                   CharacterControllerPool& into);
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,76 @@
+/*
+ * Copyright (C) 2021-2023 Jean-Marie BARAN (jeanmarie.baran@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Refer to 'COPYING.txt' for the full notice.
+ */
+
+#include <libflatkiss/logic/character_controller_pool.hpp>
+#include <stdexcept>
+
+using std::invalid_argument;
+
+CharacterController& CharacterControllerPool::at(int64_t index) {
+  Slot const& slot{slots_[index]};
+  switch (slot.type) {
+    case ControllerType::kKeyboardController:
+      return *controllers<KeyboardCharacterController>()[slot.index_in_type];
+    case ControllerType::kStrollController:
+      return *controllers<StrollCharacterController>()[slot.index_in_type];
+    case ControllerType::kBytecodeController:
+      return *controllers<BytecodeCharacterController>()[slot.index_in_type];
+    case ControllerType::kScriptedController:
+      return *controllers<ScriptedCharacterController>()[slot.index_in_type];
+    default:
+      throw invalid_argument("Unknown controller type");
+  }
+}
+
+void CharacterControllerPool::copyFrom(CharacterControllerPool const& other) {
+  copyStorages(other.storages_);
+  slots_ = other.slots_;
+}
+
+bool CharacterControllerPool::empty() const { return slots_.empty(); }
+
+int64_t CharacterControllerPool::indexInType(int64_t index) const {
+  return slots_[index].index_in_type;
+}
+
+void CharacterControllerPool::remove(int64_t index) {
+  Slot const& slot{slots_[index]};
+  switch (slot.type) {
+    case ControllerType::kKeyboardController:
+      removeFrom<KeyboardCharacterController>(slot.index_in_type);
+      break;
+    case ControllerType::kStrollController:
+      removeFrom<StrollCharacterController>(slot.index_in_type);
+      break;
+    case ControllerType::kBytecodeController:
+      removeFrom<BytecodeCharacterController>(slot.index_in_type);
+      break;
+    case ControllerType::kScriptedController:
+      removeFrom<ScriptedCharacterController>(slot.index_in_type);
+      break;
+    default:
+      throw invalid_argument("Unknown controller type");
+  }
+}
+
+int64_t CharacterControllerPool::size() const { return slots_.size(); }
+
+ControllerType CharacterControllerPool::type(int64_t index) const {
+  return slots_[index].type;
+}
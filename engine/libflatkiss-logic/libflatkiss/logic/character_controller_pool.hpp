@@ -0,0 +1,161 @@
+/*
+ * Copyright (C) 2021-2023 Jean-Marie BARAN (jeanmarie.baran@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Refer to 'COPYING.txt' for the full notice.
+ */
+
+#ifndef LIBFLATKISS_LOGIC_CHARACTER_CONTROLLER_POOL_HPP_INCLUDED
+#define LIBFLATKISS_LOGIC_CHARACTER_CONTROLLER_POOL_HPP_INCLUDED
+
+#include <libflatkiss/logic/bytecode_character_controller.hpp>
+#include <libflatkiss/logic/character_controller.hpp>
+#include <libflatkiss/logic/keyboard_character_controller.hpp>
+#include <libflatkiss/logic/scripted_character_controller.hpp>
+#include <libflatkiss/logic/stroll_character_controller.hpp>
+#include <libflatkiss/model/model.hpp>
+#include <optional>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Stores the controllers of a level, type by type.
+ *
+ * The controllers of a type are stored contiguously, mostly in the order of
+ * their characters. Going through them type by type is then a tight loop over
+ * adjacent objects of a single (final) class, in which the calls are direct
+ * rather than virtual.
+ *
+ * A controller is identified by the index of its character in the level. When
+ * a controller is removed, its entry is reused by the next controller of the
+ * same type, so that adding controllers does not allocate in the long run. No
+ * controller can be added while references to the controllers are held, as
+ * they may move.
+ */
+class CharacterControllerPool {
+ public:
+  /**
+   * @brief Create a controller of the given type for the character.
+   *
+   * @param character The character to control.
+   * @param arguments The other arguments of the constructor of the controller.
+   */
+  template <typename Controller, typename... Arguments>
+  void add(Character const& character, Arguments&&... arguments) {
+    Storage<Controller>& storage{std::get<Storage<Controller>>(storages_)};
+    int64_t entry{static_cast<int64_t>(storage.controllers.size())};
+    if (storage.free_entries.empty()) {
+      storage.controllers.emplace_back(
+          std::in_place, character, std::forward<Arguments>(arguments)...);
+    } else {
+      entry = storage.free_entries.back();
+      storage.free_entries.pop_back();
+      storage.controllers[entry].emplace(
+          character, std::forward<Arguments>(arguments)...);
+    }
+
+    if (character.index() >= slots_.size()) {
+      slots_.resize(character.index() + 1);
+    }
+    slots_[character.index()] = {Controller::kType, entry};
+  }
+  /**
+   * @brief Returns the controller at the given index, whatever its type.
+   */
+  CharacterController& at(int64_t index);
+  /**
+   * @brief Returns the controllers of the given type, including the empty
+   * entries left by the removed ones.
+   */
+  template <typename Controller>
+  std::vector<std::optional<Controller>>& controllers() {
+    return std::get<Storage<Controller>>(storages_).controllers;
+  }
+  /**
+   * @brief Replace the controllers with copies of those of another pool (e.g.
+   * for a snapshot).
+   *
+   * Does not allocate once the storages are large enough, apart from the
+   * frames of the scripts of the scripted controllers, which are created again
+   * (refer to ScriptedCharacterController) from pools.
+   *
+   * @param other The pool to copy, whose controllers drive characters of the
+   * same level.
+   */
+  void copyFrom(CharacterControllerPool const& other);
+  bool empty() const;
+  /**
+   * @brief Returns the index of a controller among those of its type.
+   */
+  int64_t indexInType(int64_t index) const;
+  /**
+   * @brief Destroy the controller at the given index.
+   */
+  void remove(int64_t index);
+  /**
+   * @brief Returns the number of indices, including those of the removed
+   * controllers.
+   */
+  int64_t size() const;
+  ControllerType type(int64_t index) const;
+
+ private:
+  template <typename Controller>
+  struct Storage {
+    std::vector<std::optional<Controller>> controllers;
+    // Entries of the removed controllers, to be reused.
+    std::vector<int64_t> free_entries;
+  };
+  struct Slot {
+    ControllerType type;
+    int64_t index_in_type;
+  };
+
+  std::tuple<Storage<BytecodeCharacterController>,
+             Storage<KeyboardCharacterController>,
+             Storage<ScriptedCharacterController>,
+             Storage<StrollCharacterController>>
+      storages_;
+  std::vector<Slot> slots_;
+
+  template <typename Controller>
+  static void copyStorage(Storage<Controller> const& from,
+                          Storage<Controller>& to) {
+    static_assert(std::is_copy_constructible_v<Controller>,
+                  "The controllers must be copyable for the snapshots");
+    to.controllers.clear();
+    for (std::optional<Controller> const& controller : from.controllers) {
+      to.controllers.push_back(controller);
+    }
+    to.free_entries.assign(from.free_entries.cbegin(),
+                           from.free_entries.cend());
+  }
+  template <typename... Controllers>
+  void copyStorages(std::tuple<Storage<Controllers>...> const& from) {
+    (copyStorage(std::get<Storage<Controllers>>(from),
+                 std::get<Storage<Controllers>>(storages_)),
+     ...);
+  }
+  template <typename Controller>
+  void removeFrom(int64_t index_in_type) {
+    Storage<Controller>& storage{std::get<Storage<Controller>>(storages_)};
+    storage.controllers[index_in_type].reset();
+    storage.free_entries.push_back(index_in_type);
+  }
+};
+
+#endif
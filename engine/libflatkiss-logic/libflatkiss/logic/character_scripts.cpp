@@ -0,0 +1,149 @@
+/*
+ * Copyright (C) 2021-2023 Jean-Marie BARAN (jeanmarie.baran@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Refer to 'COPYING.txt' for the full notice.
+ */
+
+#include <array>
+#include <libflatkiss/logic/character_scripts.hpp>
+#include <libflatkiss/logic/random_stream.hpp>
+#include <stdexcept>
+#include <string>
+
+using std::array;
+using std::invalid_argument;
+using std::to_string;
+
+Script CharacterScripts::create(int64_t index, Character const& character,
+                                uint64_t seed, int64_t first_command) {
+  switch (index) {
+    case 0:
+      return stroll(character, seed, first_command);
+    case 1:
+      return patrol(first_command);
+    case 2:
+      return rally(first_command);
+    case 3:
+      return wander(character, seed, first_command);
+    default:
+      throw invalid_argument("Unknown script " + to_string(index));
+  }
+}
+
+Script CharacterScripts::patrol(int64_t first_command) {
+  int64_t constexpr kIdleTimeInTicks{60};
+  int64_t constexpr kWalkTimeInTicks{64};
+  int64_t constexpr kNumCommands{4};
+  for (int64_t command{first_command};; command++) {
+    switch (command % kNumCommands) {
+      case 0:
+        co_await Script::walk(kEast, kWalkTimeInTicks);
+        break;
+      case 2:
+        co_await Script::walk(kWest, kWalkTimeInTicks);
+        break;
+      default:
+        co_await Script::idle(kIdleTimeInTicks);
+        break;
+    }
+  }
+}
+
+Script CharacterScripts::rally(int64_t first_command) {
+  int64_t constexpr kIdleTimeInTicks{120};
+  int64_t constexpr kNumCommands{4};
+  Script::Context const& context{co_await Script::context()};
+  // The same for all the characters, so they share the flow fields.
+  Level const& level{context.level()};
+  TilePosition const west{level.widthInTiles() / 4, level.heightInTiles() / 2};
+  TilePosition const east{3 * level.widthInTiles() / 4,
+                          level.heightInTiles() / 2};
+  for (int64_t command{first_command};; command++) {
+    switch (command % kNumCommands) {
+      case 0:
+        co_await Script::gather(west);
+        break;
+      case 2:
+        co_await Script::gather(east);
+        break;
+      default:
+        co_await Script::idle(kIdleTimeInTicks);
+        break;
+    }
+  }
+}
+
+Script CharacterScripts::stroll(Character character, uint64_t seed,
+                                int64_t first_command) {
+  int64_t constexpr kIdleTimeInTicks{250};
+  int64_t constexpr kWalkTimeInTicks{35};
+  array<CardinalDirection, 4> constexpr kDirections{kSouth, kNorth, kWest,
+                                                    kEast};
+  Script::Context const& context{co_await Script::context()};
+  // A walk then an idle time, over and over.
+  for (int64_t command{first_command};; command++) {
+    if (command % 2 == 1) {
+      co_await Script::idle(kIdleTimeInTicks);
+      continue;
+    }
+
+    // Directions in which the character would not fit are skipped.
+    array<CardinalDirection, 4> candidates{kDirections};
+    int64_t num_candidates{0};
+    for (CardinalDirection direction : kDirections) {
+      if (context.fits(character, direction)) {
+        candidates[num_candidates++] = direction;
+      }
+    }
+    if (num_candidates == 0) {
+      candidates = kDirections;
+      num_candidates = kDirections.size();
+    }
+    RandomStream random_stream{
+        seed,
+        (static_cast<uint64_t>(character.index()) << 32U) |
+            character.generation(),
+        static_cast<uint64_t>(context.tick())};
+    co_await Script::walk(
+        candidates[random_stream.between(0, num_candidates - 1)],
+        kWalkTimeInTicks);
+  }
+}
+
+Script CharacterScripts::wander(Character character, uint64_t seed,
+                                int64_t first_command) {
+  int64_t constexpr kIdleTimeInTicks{120};
+  Script::Context const& context{co_await Script::context()};
+  Level const& level{context.level()};
+  for (int64_t command{first_command};; command++) {
+    if (command % 2 == 1) {
+      co_await Script::idle(kIdleTimeInTicks);
+      continue;
+    }
+
+    /* Drawn for the command rather than for the tick, so that the goals do not
+     * depend on when the script starts over. A goal out of reach (e.g. a wall)
+     * only makes the character idle longer. */
+    RandomStream random_stream{
+        seed,
+        (static_cast<uint64_t>(character.index()) << 32U) |
+            character.generation(),
+        static_cast<uint64_t>(command)};
+    int64_t const goal_x{random_stream.between(0, level.widthInTiles() - 1)};
+    int64_t const goal_y{random_stream.between(0, level.heightInTiles() - 1)};
+    co_await Script::walkTo(TilePosition{goal_x, goal_y});
+  }
+}
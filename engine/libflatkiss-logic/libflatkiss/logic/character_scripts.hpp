@@ -0,0 +1,72 @@
+/*
+ * Copyright (C) 2021-2023 Jean-Marie BARAN (jeanmarie.baran@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Refer to 'COPYING.txt' for the full notice.
+ */
+
+#ifndef LIBFLATKISS_LOGIC_CHARACTER_SCRIPTS_HPP_INCLUDED
+#define LIBFLATKISS_LOGIC_CHARACTER_SCRIPTS_HPP_INCLUDED
+
+#include <libflatkiss/logic/script.hpp>
+#include <libflatkiss/model/model.hpp>
+
+/**
+ * @brief The scripts run by the scripted controller, by behaviour index.
+ *
+ * Each script can start from any of its commands, given how many it issued
+ * before. Between two commands, its state is then nothing more than that
+ * number, its character and its seed: this is how a scripted controller is
+ * copied (e.g. for a snapshot), although the frame of a coroutine cannot be.
+ */
+class CharacterScripts {
+ public:
+  /**
+   * @brief Start the script of the given index for a character.
+   *
+   * @param index Index of the script (the behaviour index of the character).
+   * @param character The character driven by the script.
+   * @param seed Seed of the random values drawn by the script.
+   * @param first_command Number of commands the script issued already: it
+   * carries on from the next one.
+   * @return Script The script, suspended before its first instruction.
+   */
+  static Script create(int64_t index, Character const& character,
+                       uint64_t seed, int64_t first_command);
+
+ private:
+  /**
+   * @brief Walks back and forth, east then west.
+   */
+  static Script patrol(int64_t first_command);
+  /**
+   * @brief Gathers at a rally point west of the middle of the level, then at
+   * one east of it, idling at each.
+   */
+  static Script rally(int64_t first_command);
+  /**
+   * @brief Same as StrollCharacterController: idles, then walks a few steps
+   * in a random direction where the character fits.
+   */
+  static Script stroll(Character character, uint64_t seed,
+                       int64_t first_command);
+  /**
+   * @brief Walks to a random tile of the level along a path, then idles.
+   */
+  static Script wander(Character character, uint64_t seed,
+                       int64_t first_command);
+};
+
+#endif
@@ -0,0 +1,270 @@
+/*
+ * Copyright (C) 2021-2023 Jean-Marie BARAN (jeanmarie.baran@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Refer to 'COPYING.txt' for the full notice.
+ */
+
+#include <algorithm>
+#include <libflatkiss/logic/clearance_map.hpp>
+#include <libflatkiss/logic/collider.hpp>
+#include <optional>
+
+using std::max;
+using std::min;
+using std::optional;
+using std::vector;
+
+ClearanceMap::ClearanceMap(TileSolids const& tile_solids)
+    : tile_solids_{tile_solids},
+      cell_width_{max<int64_t>(
+          1, tile_solids.level().spriteset().spritesWidth() /
+                 kCellsPerTileSide)},
+      cell_height_{max<int64_t>(
+          1, tile_solids.level().spriteset().spritesHeight() /
+                 kCellsPerTileSide)},
+      width_in_cells_{(tile_solids.level().widthInTiles() *
+                           tile_solids.level().spriteset().spritesWidth() +
+                       cell_width_ - 1) /
+                      cell_width_},
+      height_in_cells_{(tile_solids.level().heightInTiles() *
+                            tile_solids.level().spriteset().spritesHeight() +
+                        cell_height_ - 1) /
+                       cell_height_},
+      blocked_(width_in_cells_ * height_in_cells_, false),
+      clearances_(width_in_cells_ * height_in_cells_, 0) {
+  computeBlocked(0, 0, width_in_cells_ - 1, height_in_cells_ - 1);
+  computeClearances(0, 0, width_in_cells_ - 1, height_in_cells_ - 1);
+}
+
+int64_t ClearanceMap::cellHeight() const { return cell_height_; }
+
+int64_t ClearanceMap::cellWidth() const { return cell_width_; }
+
+int64_t ClearanceMap::clearanceAt(int64_t i, int64_t j) const {
+  return clearances_[j * width_in_cells_ + i];
+}
+
+void ClearanceMap::computeBlocked(int64_t left, int64_t top, int64_t right,
+                                  int64_t bottom) {
+  for (int64_t j{top}; j <= bottom; j++) {
+    for (int64_t i{left}; i <= right; i++) {
+      blocked_[j * width_in_cells_ + i] = isBlocked(i, j);
+    }
+  }
+}
+
+void ClearanceMap::computeClearances(int64_t left, int64_t top, int64_t right,
+                                     int64_t bottom) {
+  for (int64_t j{bottom}; j >= top; j--) {
+    for (int64_t i{right}; i >= left; i--) {
+      int64_t const index{j * width_in_cells_ + i};
+      if (blocked_[index]) {
+        clearances_[index] = 0;
+        continue;
+      }
+
+      // Cells outside of the level have a clearance of zero.
+      bool const has_right{i + 1 < width_in_cells_};
+      bool const has_bottom{j + 1 < height_in_cells_};
+      int64_t const smallest{
+          has_right && has_bottom
+              ? min({clearanceAt(i + 1, j), clearanceAt(i, j + 1),
+                     clearanceAt(i + 1, j + 1)})
+              : 0};
+      clearances_[index] =
+          static_cast<uint8_t>(min(kMaxClearance, smallest + 1));
+    }
+  }
+}
+
+bool ClearanceMap::fits(PositionedRectangle const& bounding_box,
+                        Position const& position) const {
+  Level const& level{tile_solids_.level()};
+  int64_t const left{position.x() + bounding_box.x()};
+  int64_t const top{position.y() + bounding_box.y()};
+  int64_t const right{left + bounding_box.width()};
+  int64_t const bottom{top + bounding_box.height()};
+  if (left < 0 || top < 0 ||
+      right > level.widthInTiles() * level.spriteset().spritesWidth() ||
+      bottom > level.heightInTiles() * level.spriteset().spritesHeight()) {
+    return false;
+  }
+  if (right <= left || bottom <= top) {
+    return true;
+  }
+
+  int64_t const first_i{left / cell_width_};
+  int64_t const first_j{top / cell_height_};
+  return fitsCells(first_i, first_j, (right - 1) / cell_width_ - first_i + 1,
+                   (bottom - 1) / cell_height_ - first_j + 1);
+}
+
+bool ClearanceMap::fitsCells(int64_t first_i, int64_t first_j, int64_t width,
+                             int64_t height) const {
+  /* Cover the rectangle of cells with squares as large as its smallest side,
+   * placed along its largest side (the last one overlapping the previous one
+   * if needed): each square fits where the clearance of its top left cell is
+   * at least its side. */
+  int64_t const side{min(width, height)};
+  if (width >= height) {
+    for (int64_t offset{0};; offset += side) {
+      offset = min(offset, width - side);
+      if (clearanceAt(first_i + offset, first_j) < side) {
+        return false;
+      }
+      if (offset == width - side) {
+        return true;
+      }
+    }
+  }
+  for (int64_t offset{0};; offset += side) {
+    offset = min(offset, height - side);
+    if (clearanceAt(first_i, first_j + offset) < side) {
+      return false;
+    }
+    if (offset == height - side) {
+      return true;
+    }
+  }
+}
+
+// NOLINTBEGIN(readability-identifier-length)
+void ClearanceMap::fitsOnTiles(PositionedRectangle const& bounding_box,
+                               vector<bool>& tiles_fit) const {
+  Level const& level{tile_solids_.level()};
+  int64_t const width{level.widthInTiles()};
+  int64_t const height{level.heightInTiles()};
+  int64_t const tiles_width{level.spriteset().spritesWidth()};
+  int64_t const tiles_height{level.spriteset().spritesHeight()};
+  tiles_fit.assign(width * height, false);
+  if (bounding_box.width() <= 0 || bounding_box.height() <= 0) {
+    // An empty box fits wherever it is inside of the level (refer to fits()).
+    for (int64_t y{0}; y < height; y++) {
+      for (int64_t x{0}; x < width; x++) {
+        tiles_fit[y * width + x] =
+            fits(bounding_box, Position{x * tiles_width, y * tiles_height});
+      }
+    }
+    return;
+  }
+
+  /* The cells covered by the box only depend on the column of the tile along
+   * one axis, and on its row along the other: they are found once per column
+   * and once per row. */
+  struct Span {
+    int64_t first;
+    int64_t size;
+  };
+  auto const spans{[](int64_t num_tiles, int64_t tile_size, int64_t box_offset,
+                      int64_t box_size, int64_t cell_size) {
+    vector<optional<Span>> spans(num_tiles);
+    for (int64_t t{0}; t < num_tiles; t++) {
+      int64_t const start{t * tile_size + box_offset};
+      int64_t const end{start + box_size};
+      if (start >= 0 && end <= num_tiles * tile_size) {
+        spans[t] = Span{start / cell_size,
+                        (end - 1) / cell_size - start / cell_size + 1};
+      }
+    }
+    return spans;
+  }};
+  vector<optional<Span>> const columns{spans(width, tiles_width,
+                                             bounding_box.x(),
+                                             bounding_box.width(),
+                                             cell_width_)};
+  vector<optional<Span>> const rows{spans(height, tiles_height,
+                                          bounding_box.y(),
+                                          bounding_box.height(), cell_height_)};
+  for (int64_t y{0}; y < height; y++) {
+    if (!rows[y]) {
+      continue;
+    }
+    for (int64_t x{0}; x < width; x++) {
+      if (columns[x]) {
+        tiles_fit[y * width + x] = fitsCells(columns[x]->first, rows[y]->first,
+                                             columns[x]->size, rows[y]->size);
+      }
+    }
+  }
+}
+// NOLINTEND(readability-identifier-length)
+
+bool ClearanceMap::isBlocked(int64_t i, int64_t j) const {
+  Level const& level{tile_solids_.level()};
+  int64_t const tiles_width{level.spriteset().spritesWidth()};
+  int64_t const tiles_height{level.spriteset().spritesHeight()};
+  int64_t const left{i * cell_width_};
+  int64_t const top{j * cell_height_};
+  int64_t const right{min(left + cell_width_,
+                          level.widthInTiles() * tiles_width)};
+  int64_t const bottom{min(top + cell_height_,
+                           level.heightInTiles() * tiles_height)};
+  PositionedRectangle const cell{Position{left, top},
+                                 Rectangle{right - left, bottom - top}};
+
+  // The cell can be over several tiles if the tiles are not a multiple of it.
+  /* Disabling lint for short variables names because they are useful for
+   * math-related things (x, y, ...). */
+  // NOLINTBEGIN(readability-identifier-length)
+  for (int64_t y{top / tiles_height}; y <= (bottom - 1) / tiles_height; y++) {
+    for (int64_t x{left / tiles_width}; x <= (right - 1) / tiles_width; x++) {
+      Solid const* tile_solid{tile_solids_.solidAt(x, y)};
+      if (tile_solid == nullptr) {
+        continue;
+      }
+      Position const tile_position{x * tiles_width, y * tiles_height};
+      for (auto const& rectangle : tile_solid->positionedRectangles()) {
+        /* Not using the collider here: it considers rectangles which only
+         * touch each other as colliding, which would block the cells next to
+         * every wall. */
+        if (tile_position.x() + rectangle.x() < right &&
+            left < tile_position.x() + rectangle.x() + rectangle.width() &&
+            tile_position.y() + rectangle.y() < bottom &&
+            top < tile_position.y() + rectangle.y() + rectangle.height()) {
+          return true;
+        }
+      }
+      for (auto const& ellipse : tile_solid->positionedEllipses()) {
+        if (Collider::collide(cell, tile_position + ellipse)) {
+          return true;
+        }
+      }
+    }
+  }
+  // NOLINTEND(readability-identifier-length)
+
+  return false;
+}
+
+Level const& ClearanceMap::level() const { return tile_solids_.level(); }
+
+void ClearanceMap::onTileChanged(int64_t x, int64_t y) {
+  Level const& level{tile_solids_.level()};
+  int64_t const tiles_width{level.spriteset().spritesWidth()};
+  int64_t const tiles_height{level.spriteset().spritesHeight()};
+  int64_t const left{x * tiles_width / cell_width_};
+  int64_t const top{y * tiles_height / cell_height_};
+  int64_t const right{
+      min(width_in_cells_ - 1, ((x + 1) * tiles_width - 1) / cell_width_)};
+  int64_t const bottom{
+      min(height_in_cells_ - 1, ((y + 1) * tiles_height - 1) / cell_height_)};
+  computeBlocked(left, top, right, bottom);
+
+  /* The clearance of a cell only depends on the cells to its right and below,
+   * and never reaches further than kMaxClearance cells. */
+  computeClearances(max<int64_t>(0, left - kMaxClearance),
+                    max<int64_t>(0, top - kMaxClearance), right, bottom);
+}
@@ -0,0 +1,119 @@
+/*
+ * Copyright (C) 2021-2023 Jean-Marie BARAN (jeanmarie.baran@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Refer to 'COPYING.txt' for the full notice.
+ */
+
+#ifndef LIBFLATKISS_LOGIC_CLEARANCE_MAP_HPP_INCLUDED
+#define LIBFLATKISS_LOGIC_CLEARANCE_MAP_HPP_INCLUDED
+
+#include <libflatkiss/logic/tile_solids.hpp>
+#include <libflatkiss/model/model.hpp>
+#include <vector>
+
+/**
+ * @brief Tells in constant time whether a box fits somewhere in a level.
+ *
+ * The level is divided into cells smaller than the tiles (kCellsPerTileSide
+ * cells along each side of a tile). A cell is blocked when the solid of a tile
+ * overlaps it, or when it is outside of the level. The clearance of a cell is
+ * the side of the largest square of free cells whose top left cell it is. It is
+ * computed once for the whole level, from the bottom right to the top left: a
+ * free cell has a clearance of one plus the smallest clearance among its right,
+ * bottom and bottom right neighbours.
+ *
+ * A box fits where the cells it covers are all free, which a few lookups of the
+ * clearances answer for any size of box. This is conservative: a box which
+ * touches a blocked cell without touching the solid inside it does not fit.
+ * Collisions are still resolved exactly by the Navigator, this map is for
+ * rejecting locations quickly (e.g. during a search for a path).
+ */
+class ClearanceMap {
+ public:
+  /**
+   * @param tile_solids Solids of the level, must outlive the map.
+   */
+  ClearanceMap(TileSolids const& tile_solids);
+  int64_t cellHeight() const;
+  int64_t cellWidth() const;
+  /**
+   * @brief Returns the clearance of a cell, in cells.
+   *
+   * @param i Location of the cell along the horizontal axis, in cells.
+   * @param j Location of the cell along the vertical axis, in cells.
+   */
+  int64_t clearanceAt(int64_t i, int64_t j) const;
+  /**
+   * @brief Whether a box at the given position covers free cells only.
+   *
+   * @param bounding_box The box, relative to the position (e.g. the bounding
+   * box of a solid).
+   * @param position Position of the box in pixels.
+   * @return bool Whether the box fits.
+   */
+  bool fits(PositionedRectangle const& bounding_box,
+            Position const& position) const;
+  /**
+   * @brief Whether a box fits at the top left of each tile of the level.
+   *
+   * Same as fits() for every tile, but the level is looked up only once.
+   *
+   * @param bounding_box The box, relative to the top left of the tiles.
+   * @param tiles_fit Receives whether the box fits, tile by tile and row by
+   * row.
+   */
+  void fitsOnTiles(PositionedRectangle const& bounding_box,
+                   std::vector<bool>& tiles_fit) const;
+  Level const& level() const;
+  /**
+   * @brief Notify the map that a tile of the level was replaced.
+   *
+   * Only the cells of the tile and the clearances which depend on them are
+   * recomputed.
+   *
+   * @param x Location of the tile along the horizontal axis, in tiles.
+   * @param y Location of the tile along the vertical axis, in tiles.
+   */
+  void onTileChanged(int64_t x, int64_t y);
+
+  static int64_t constexpr kCellsPerTileSide{4};
+
+ private:
+  TileSolids const& tile_solids_;
+  int64_t const cell_width_;
+  int64_t const cell_height_;
+  int64_t const width_in_cells_;
+  int64_t const height_in_cells_;
+  std::vector<bool> blocked_;
+  std::vector<uint8_t> clearances_;
+  /* Clearances are capped so that they fit in a byte. This is way bigger than
+   * any character, and bounds the area to update when a tile changes. */
+  static int64_t constexpr kMaxClearance{255};
+
+  void computeBlocked(int64_t left, int64_t top, int64_t right,
+                      int64_t bottom);
+  void computeClearances(int64_t left, int64_t top, int64_t right,
+                         int64_t bottom);
+  /**
+   * @brief Whether a rectangle of cells (inside of the level, not empty) is
+   * free.
+   */
+  bool fitsCells(int64_t first_i, int64_t first_j, int64_t width,
+                 int64_t height) const;
+  bool isBlocked(int64_t i, int64_t j) const;
+};
+
+#endif
@@ -261,27 +261,35 @@ bool Collider::collide(PositionedEllipse const& e, Position const& p) {
 
 bool Collider::collide(PositionedSolid const& solid1,
                        PositionedSolid const& solid2) {
-  for (auto const& pos_ell1 : solid1.positionedEllipses()) {
-    for (auto const& pos_ell2 : solid2.positionedEllipses()) {
-      if (collide(pos_ell1, pos_ell2)) {
+  return collide(solid1.solid(), solid1.position(), solid2.solid(),
+                 solid2.position());
+}
+
+bool Collider::collide(Solid const& solid1, Position const& position1,
+                       Solid const& solid2, Position const& position2) {
+  for (auto const& ell1 : solid1.positionedEllipses()) {
+    PositionedEllipse const pos_ell1{position1 + ell1};
+    for (auto const& ell2 : solid2.positionedEllipses()) {
+      if (collide(pos_ell1, position2 + ell2)) {
         return true;
       }
     }
-    for (auto const& pos_rect2 : solid2.positionedRectangles()) {
-      if (collide(pos_rect2, pos_ell1)) {
+    for (auto const& rect2 : solid2.positionedRectangles()) {
+      if (collide(position2 + rect2, pos_ell1)) {
         return true;
       }
     }
   }
 
-  for (auto const& pos_rect1 : solid1.positionedRectangles()) {
-    for (auto const& pos_ell2 : solid2.positionedEllipses()) {
-      if (collide(pos_rect1, pos_ell2)) {
+  for (auto const& rect1 : solid1.positionedRectangles()) {
+    PositionedRectangle const pos_rect1{position1 + rect1};
+    for (auto const& ell2 : solid2.positionedEllipses()) {
+      if (collide(pos_rect1, position2 + ell2)) {
         return true;
       }
     }
-    for (auto const& pos_rect2 : solid2.positionedRectangles()) {
-      if (collide(pos_rect1, pos_rect2)) {
+    for (auto const& rect2 : solid2.positionedRectangles()) {
+      if (collide(pos_rect1, position2 + rect2)) {
         return true;
       }
     }
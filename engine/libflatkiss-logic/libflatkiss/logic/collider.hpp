@@ -23,6 +23,7 @@
 #include <libflatkiss/model/positioned_ellipse.hpp>
 #include <libflatkiss/model/positioned_rectangle.hpp>
 #include <libflatkiss/model/positioned_solid.hpp>
+#include <libflatkiss/model/solid.hpp>
 
 /**
  * @brief Collides things.
@@ -39,6 +40,20 @@ class Collider {
                       PositionedRectangle const& rectangle2);
   static bool collide(PositionedSolid const& solid1,
                       PositionedSolid const& solid2);
+  /**
+   * @brief Collide two solids placed at the given positions.
+   *
+   * Same as colliding two positioned solids, but the shapes are moved on the
+   * fly instead of being copied, so this does not allocate.
+   *
+   * @param solid1 First solid.
+   * @param position1 Position of the first solid.
+   * @param solid2 Second solid.
+   * @param position2 Position of the second solid.
+   * @return bool Whether the two solids collide.
+   */
+  static bool collide(Solid const& solid1, Position const& position1,
+                      Solid const& solid2, Position const& position2);
 
  private:
   /** The resolution is used in the ellipse to ellispe collision detection. The
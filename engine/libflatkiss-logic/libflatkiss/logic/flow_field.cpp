@@ -0,0 +1,95 @@
+/*
+ * Copyright (C) 2021-2023 Jean-Marie BARAN (jeanmarie.baran@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Refer to 'COPYING.txt' for the full notice.
+ */
+
+#include <array>
+#include <libflatkiss/logic/flow_field.hpp>
+
+using std::array;
+using std::vector;
+
+FlowField::FlowField(Solid const& solid, TilePosition const& goal,
+                     ClearanceMap const& clearance_map)
+    : goal_{goal},
+      width_{clearance_map.level().widthInTiles()},
+      distances_(width_ * clearance_map.level().heightInTiles(), -1),
+      directions_(distances_.size(), kNoDirection) {
+  int64_t const height{clearance_map.level().heightInTiles()};
+  /* The search looks at each tile from up to four neighbours: whether the
+   * solid fits on the tiles is found once for all of them beforehand, as
+   * PathFinder::isWalkable() would. */
+  vector<bool> walkable;
+  clearance_map.fitsOnTiles(solid.boundingBox(), walkable);
+  if (!walkable[goal.y() * width_ + goal.x()]) {
+    return;
+  }
+
+  /* Each tile reached from a neighbour points back to that neighbour, which is
+   * one step closer to the goal. The direction is the opposite of the step of
+   * the search. */
+  struct Step {
+    int64_t dx;
+    int64_t dy;
+    CardinalDirection back;
+  };
+  array<Step, 4> constexpr kSteps{{{-1, 0, kEast},
+                                   {1, 0, kWest},
+                                   {0, -1, kSouth},
+                                   {0, 1, kNorth}}};
+
+  vector<int64_t> queue;
+  queue.reserve(distances_.size());
+  queue.push_back(goal.y() * width_ + goal.x());
+  distances_[queue.front()] = 0;
+  for (int64_t head{0}; head < queue.size(); head++) {
+    int64_t const current{queue[head]};
+    int64_t const x{current % width_};
+    int64_t const y{current / width_};
+    for (Step const& step : kSteps) {
+      int64_t const next_x{x + step.dx};
+      int64_t const next_y{y + step.dy};
+      if (next_x < 0 || next_x >= width_ || next_y < 0 || next_y >= height) {
+        continue;
+      }
+      int64_t const next{next_y * width_ + next_x};
+      if (distances_[next] != -1 || !walkable[next]) {
+        continue;
+      }
+      distances_[next] = distances_[current] + 1;
+      directions_[next] = step.back;
+      queue.push_back(next);
+    }
+  }
+}
+
+bool FlowField::directionAt(int64_t x, int64_t y,
+                            CardinalDirection& direction) const {
+  uint8_t const value{directions_[y * width_ + x]};
+  if (value == kNoDirection) {
+    return false;
+  }
+
+  direction = static_cast<CardinalDirection>(value);
+  return true;
+}
+
+int64_t FlowField::distanceAt(int64_t x, int64_t y) const {
+  return distances_[y * width_ + x];
+}
+
+TilePosition const& FlowField::goal() const { return goal_; }
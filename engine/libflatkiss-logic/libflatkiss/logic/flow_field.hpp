@@ -0,0 +1,71 @@
+/*
+ * Copyright (C) 2021-2023 Jean-Marie BARAN (jeanmarie.baran@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Refer to 'COPYING.txt' for the full notice.
+ */
+
+#ifndef LIBFLATKISS_LOGIC_FLOW_FIELD_HPP_INCLUDED
+#define LIBFLATKISS_LOGIC_FLOW_FIELD_HPP_INCLUDED
+
+#include <libflatkiss/logic/clearance_map.hpp>
+#include <libflatkiss/model/model.hpp>
+#include <vector>
+
+/**
+ * @brief Directions to follow from every tile of a level to reach a goal.
+ *
+ * The field is computed once with a breadth-first search starting from the
+ * goal (moves along the cardinal directions all cost the same, so this is
+ * Dijkstra's algorithm). Each tile then knows its distance to the goal and the
+ * direction towards the next tile of a shortest path. Any number of characters
+ * heading to the same goal can sample the field in constant time, instead of
+ * each of them searching its own path.
+ *
+ * Like PathFinder, a field is computed for a given solid placed at the top left
+ * of the tiles.
+ */
+class FlowField {
+ public:
+  FlowField(Solid const& solid, TilePosition const& goal,
+            ClearanceMap const& clearance_map);
+  /**
+   * @brief Returns the direction to follow from the given tile.
+   *
+   * @param x Location of the tile along the horizontal axis, in tiles.
+   * @param y Location of the tile along the vertical axis, in tiles.
+   * @param direction Receives the direction towards the next tile.
+   * @return bool False if the tile is the goal or the goal cannot be reached
+   * from it, in which case direction is left untouched.
+   */
+  bool directionAt(int64_t x, int64_t y, CardinalDirection& direction) const;
+  /**
+   * @brief Returns the number of steps from the given tile to the goal, or -1
+   * if the goal cannot be reached from it.
+   */
+  int64_t distanceAt(int64_t x, int64_t y) const;
+  TilePosition const& goal() const;
+
+ private:
+  TilePosition const goal_;
+  int64_t const width_;
+  // 32 bits are plenty for distances in tiles and halve the size of the field.
+  std::vector<int32_t> distances_;
+  // CardinalDirection of each tile, or kNoDirection.
+  std::vector<uint8_t> directions_;
+  static uint8_t constexpr kNoDirection{4};
+};
+
+#endif
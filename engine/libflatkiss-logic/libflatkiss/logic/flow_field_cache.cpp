@@ -0,0 +1,60 @@
+/*
+ * Copyright (C) 2021-2023 Jean-Marie BARAN (jeanmarie.baran@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Refer to 'COPYING.txt' for the full notice.
+ */
+
+#include <libflatkiss/logic/flow_field_cache.hpp>
+#include <stdexcept>
+
+using std::invalid_argument;
+using std::make_shared;
+using std::shared_ptr;
+
+FlowFieldCache::FlowFieldCache(ClearanceMap const& clearance_map,
+                               int64_t capacity)
+    : clearance_map_{clearance_map}, capacity_{capacity} {
+  if (capacity_ <= 0) {
+    throw invalid_argument("Capacity of a flow field cache must be positive");
+  }
+}
+
+void FlowFieldCache::clear() {
+  flow_fields_.clear();
+  keys_.clear();
+}
+
+shared_ptr<FlowField const> FlowFieldCache::flowField(
+    Solid const& solid, TilePosition const& goal) {
+  PositionedRectangle const& bounding_box{solid.boundingBox()};
+  Key const key{bounding_box.x(), bounding_box.y(), bounding_box.width(),
+                bounding_box.height(),
+                goal.y() * clearance_map_.level().widthInTiles() + goal.x()};
+  auto const found{flow_fields_.find(key)};
+  if (found != flow_fields_.end()) {
+    return found->second;
+  }
+
+  if (keys_.size() == capacity_) {
+    flow_fields_.erase(keys_.front());
+    keys_.pop_front();
+  }
+  keys_.push_back(key);
+  return flow_fields_
+      .try_emplace(key, make_shared<FlowField const>(solid, goal,
+                                                     clearance_map_))
+      .first->second;
+}
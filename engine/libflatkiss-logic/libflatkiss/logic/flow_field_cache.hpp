@@ -0,0 +1,74 @@
+/*
+ * Copyright (C) 2021-2023 Jean-Marie BARAN (jeanmarie.baran@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Refer to 'COPYING.txt' for the full notice.
+ */
+
+#ifndef LIBFLATKISS_LOGIC_FLOW_FIELD_CACHE_HPP_INCLUDED
+#define LIBFLATKISS_LOGIC_FLOW_FIELD_CACHE_HPP_INCLUDED
+
+#include <array>
+#include <deque>
+#include <libflatkiss/logic/clearance_map.hpp>
+#include <libflatkiss/logic/flow_field.hpp>
+#include <libflatkiss/model/model.hpp>
+#include <map>
+#include <memory>
+
+/**
+ * @brief Shares flow fields by goal tile.
+ *
+ * The first request for a goal computes its field, the following ones return
+ * the same field, so the cost does not depend on how many characters follow
+ * it. Fields are kept apart by size of solid, like the path finders (refer to
+ * PathRequestService). When the cache is full the oldest field is dropped.
+ */
+class FlowFieldCache {
+ public:
+  /**
+   * @param clearance_map Clearances of the level, must outlive the cache.
+   * @param capacity Maximum number of fields kept at once.
+   */
+  FlowFieldCache(ClearanceMap const& clearance_map, int64_t capacity);
+  /**
+   * @brief Drop all the fields, for instance after tiles of the level changed.
+   */
+  void clear();
+  /**
+   * @brief Returns the field leading to the given goal, computing it if needed.
+   *
+   * A field dropped from the cache lives on as long as it is held, but it no
+   * longer follows the changes of tiles: hold it for a lookup, not across
+   * ticks.
+   *
+   * @param solid The solid which follows the field.
+   * @param goal Tile to reach.
+   */
+  std::shared_ptr<FlowField const> flowField(Solid const& solid,
+                                             TilePosition const& goal);
+
+ private:
+  // Bounding box of the solid (x, y, width, height) and index of the goal tile.
+  using Key = std::array<int64_t, 5>;
+
+  ClearanceMap const& clearance_map_;
+  int64_t const capacity_;
+  std::map<Key, std::shared_ptr<FlowField const>> flow_fields_;
+  // Keys in the order their fields were computed.
+  std::deque<Key> keys_;
+};
+
+#endif
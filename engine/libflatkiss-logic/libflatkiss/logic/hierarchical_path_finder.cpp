@@ -0,0 +1,665 @@
+/*
+ * Copyright (C) 2021-2023 Jean-Marie BARAN (jeanmarie.baran@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Refer to 'COPYING.txt' for the full notice.
+ */
+
+#include <algorithm>
+#include <array>
+#include <functional>
+#include <libflatkiss/logic/hierarchical_path_finder.hpp>
+#include <libflatkiss/logic/path_finder.hpp>
+#include <limits>
+#include <set>
+#include <stdexcept>
+
+using std::abs;
+using std::array;
+using std::erase;
+using std::fill;
+using std::greater;
+using std::logic_error;
+using std::max;
+using std::min;
+using std::numeric_limits;
+using std::pair;
+using std::pop_heap;
+using std::push_heap;
+using std::reverse;
+using std::set;
+using std::tuple;
+using std::vector;
+
+HierarchicalPathFinder::HierarchicalPathFinder(
+    Solid const& solid, ClearanceMap const& clearance_map,
+    PathCache& path_cache)
+    : solid_{solid},
+      clearance_map_{clearance_map},
+      path_cache_{path_cache},
+      size_class_{max(
+          (solid.boundingBox().width() + clearance_map.cellWidth() - 1) /
+              clearance_map.cellWidth(),
+          (solid.boundingBox().height() + clearance_map.cellHeight() - 1) /
+              clearance_map.cellHeight())},
+      width_{clearance_map.level().widthInTiles()},
+      height_{clearance_map.level().heightInTiles()},
+      clusters_per_row_{(width_ + kClusterSize - 1) / kClusterSize},
+      clusters_per_column_{(height_ + kClusterSize - 1) / kClusterSize},
+      walkable_(width_ * height_, false),
+      clusters_(clusters_per_row_ * clusters_per_column_),
+      cluster_distances_(kClusterSize * kClusterSize, -1),
+      cluster_parents_(kClusterSize * kClusterSize, -1) {
+  cluster_queue_.reserve(kClusterSize * kClusterSize);
+  for (int64_t y{0}; y < height_; y++) {
+    for (int64_t x{0}; x < width_; x++) {
+      walkable_[y * width_ + x] =
+          PathFinder::isWalkable(solid_, x, y, clearance_map_);
+    }
+  }
+  for (int64_t cluster{0}; cluster < clusters_.size(); cluster++) {
+    buildBorders(cluster);
+  }
+  for (int64_t cluster{0}; cluster < clusters_.size(); cluster++) {
+    buildEdges(cluster);
+  }
+  computeLandmarks();
+}
+
+void HierarchicalPathFinder::addEntrance(int64_t x1, int64_t y1, int64_t x2,
+                                         int64_t y2, vector<int64_t>& border) {
+  int64_t const node1{addNode(x1, y1)};
+  int64_t const node2{addNode(x2, y2)};
+  nodes_[node1].partner = node2;
+  nodes_[node2].partner = node1;
+  border.push_back(node1);
+  border.push_back(node2);
+}
+
+int64_t HierarchicalPathFinder::addNode(int64_t x, int64_t y) {
+  int64_t node_id{static_cast<int64_t>(nodes_.size())};
+  if (free_nodes_.empty()) {
+    nodes_.emplace_back();
+  } else {
+    node_id = free_nodes_.back();
+    free_nodes_.pop_back();
+  }
+
+  Node& node{nodes_[node_id]};
+  node.x = x;
+  node.y = y;
+  node.cluster = clusterAt(x, y);
+  node.partner = -1;
+  node.edges.clear();
+  clusters_[node.cluster].nodes.push_back(node_id);
+  return node_id;
+}
+
+void HierarchicalPathFinder::buildBorders(int64_t cluster) {
+  rebuildBorder(clusters_[cluster].right_border, cluster, true);
+  rebuildBorder(clusters_[cluster].bottom_border, cluster, false);
+}
+
+void HierarchicalPathFinder::buildEdges(int64_t cluster) {
+  for (int64_t node_id : clusters_[cluster].nodes) {
+    nodes_[node_id].edges.clear();
+  }
+
+  for (int64_t node_id : clusters_[cluster].nodes) {
+    exploreCluster(nodes_[node_id].x, nodes_[node_id].y, -1);
+    for (int64_t other_id : clusters_[cluster].nodes) {
+      int64_t const distance{cluster_distances_[indexInCluster(
+          nodes_[other_id].x, nodes_[other_id].y)]};
+      if (other_id != node_id && distance != -1) {
+        nodes_[node_id].edges.emplace_back(other_id, distance);
+      }
+    }
+  }
+}
+
+int64_t HierarchicalPathFinder::clusterAt(int64_t x, int64_t y) const {
+  return (y / kClusterSize) * clusters_per_row_ + x / kClusterSize;
+}
+
+void HierarchicalPathFinder::computeLandmarks() {
+  landmarks_outdated_ = false;
+  landmark_distances_.assign(nodes_.size() * kNumLandmarks, -1);
+
+  /* The landmarks are spread evenly along the edges of the level, clockwise
+   * from the top left corner: far from each other and from most goals, they
+   * bound many distances closely. */
+  int64_t const perimeter{2 * (width_ - 1) + 2 * (height_ - 1)};
+  vector<pair<int64_t, int64_t>> queue;
+  for (int64_t landmark{0}; landmark < kNumLandmarks; landmark++) {
+    int64_t const along{landmark * perimeter / kNumLandmarks};
+    TilePosition spot{0, 0};
+    if (along < width_ - 1) {
+      spot = TilePosition{along, 0};
+    } else if (along < width_ - 1 + height_ - 1) {
+      spot = TilePosition{width_ - 1, along - (width_ - 1)};
+    } else if (along < 2 * (width_ - 1) + height_ - 1) {
+      spot = TilePosition{2 * (width_ - 1) + height_ - 1 - along, height_ - 1};
+    } else {
+      spot = TilePosition{0, perimeter - along};
+    }
+
+    /* The landmark is the node closest to its spot. Ties are broken by
+     * location, so that the landmarks do not depend on the numbering of the
+     * nodes. */
+    int64_t landmark_node{-1};
+    tuple<int64_t, int64_t, int64_t> closest;
+    for (Cluster const& cluster : clusters_) {
+      for (int64_t node_id : cluster.nodes) {
+        Node const& node{nodes_[node_id]};
+        tuple<int64_t, int64_t, int64_t> const distance{
+            abs(spot.x() - node.x) + abs(spot.y() - node.y),
+            node.y, node.x};
+        if (landmark_node == -1 || distance < closest) {
+          landmark_node = node_id;
+          closest = distance;
+        }
+      }
+    }
+    if (landmark_node == -1) {
+      // No node at all.
+      return;
+    }
+
+    // Dijkstra from the landmark, the queue is lazily purged.
+    landmark_distances_[landmark_node * kNumLandmarks + landmark] = 0;
+    queue.clear();
+    queue.emplace_back(0, landmark_node);
+    while (!queue.empty()) {
+      auto [distance, node_id]{queue.front()};
+      pop_heap(queue.begin(), queue.end(), greater<>{});
+      queue.pop_back();
+      if (distance != landmark_distances_[node_id * kNumLandmarks + landmark]) {
+        continue;
+      }
+
+      auto relax{[&](int64_t next_id, int64_t next_distance) {
+        int64_t& known{landmark_distances_[next_id * kNumLandmarks + landmark]};
+        if (known == -1 || next_distance < known) {
+          known = next_distance;
+          queue.emplace_back(next_distance, next_id);
+          push_heap(queue.begin(), queue.end(), greater<>{});
+        }
+      }};
+      Node const& node{nodes_[node_id]};
+      relax(node.partner, distance + 1);
+      for (auto [next_id, edge_distance] : node.edges) {
+        relax(next_id, distance + edge_distance);
+      }
+    }
+  }
+}
+
+void HierarchicalPathFinder::exploreCluster(int64_t x, int64_t y,
+                                            int64_t until) {
+  int64_t const left{(x / kClusterSize) * kClusterSize};
+  int64_t const top{(y / kClusterSize) * kClusterSize};
+  int64_t const right{min(width_, left + kClusterSize)};
+  int64_t const bottom{min(height_, top + kClusterSize)};
+
+  for (int64_t reached : cluster_queue_) {
+    cluster_distances_[reached] = -1;
+  }
+  cluster_queue_.clear();
+  cluster_queue_.push_back(indexInCluster(x, y));
+  cluster_distances_[cluster_queue_.front()] = 0;
+  cluster_parents_[cluster_queue_.front()] = -1;
+  for (int64_t head{0}; head < cluster_queue_.size() &&
+                        (until == -1 || cluster_distances_[until] == -1);
+       head++) {
+    int64_t const current{cluster_queue_[head]};
+    int64_t const current_x{left + current % kClusterSize};
+    int64_t const current_y{top + current / kClusterSize};
+    for (auto [dx, dy] : array<pair<int64_t, int64_t>, 4>{
+             {{-1, 0}, {1, 0}, {0, -1}, {0, 1}}}) {
+      int64_t const next_x{current_x + dx};
+      int64_t const next_y{current_y + dy};
+      if (next_x < left || next_x >= right || next_y < top ||
+          next_y >= bottom || !isWalkable(next_x, next_y)) {
+        continue;
+      }
+      int64_t const next{indexInCluster(next_x, next_y)};
+      if (cluster_distances_[next] == -1) {
+        cluster_distances_[next] = cluster_distances_[current] + 1;
+        cluster_parents_[next] = current;
+        cluster_queue_.push_back(next);
+      }
+    }
+  }
+}
+
+HierarchicalPathFinder::SearchStatus HierarchicalPathFinder::beginSearch(
+    TilePosition const& start, TilePosition const& goal,
+    vector<TilePosition>& waypoints) {
+  waypoints.clear();
+  searching_ = false;
+  if (!isInLevel(start) || !isInLevel(goal) ||
+      !isWalkable(start.x(), start.y()) || !isWalkable(goal.x(), goal.y())) {
+    return SearchStatus::kNotFound;
+  }
+
+  if (landmarks_outdated_) {
+    computeLandmarks();
+  }
+  if (costs_.size() < nodes_.size()) {
+    costs_.resize(nodes_.size());
+    parents_.resize(nodes_.size());
+    generations_.resize(nodes_.size(), 0);
+    goal_distances_.resize(nodes_.size());
+    goal_generations_.resize(nodes_.size(), 0);
+  }
+  generation_++;
+  if (generation_ == 0) {
+    fill(generations_.begin(), generations_.end(), 0);
+    fill(goal_generations_.begin(), goal_generations_.end(), 0);
+    generation_ = 1;
+  }
+  search_start_ = start;
+  search_goal_ = goal;
+
+  // Link the goal to the nodes of its cluster.
+  exploreCluster(goal.x(), goal.y(), -1);
+  search_goal_cluster_ = clusterAt(goal.x(), goal.y());
+  for (int64_t node_id : clusters_[search_goal_cluster_].nodes) {
+    int64_t const distance{cluster_distances_[indexInCluster(
+        nodes_[node_id].x, nodes_[node_id].y)]};
+    if (distance != -1) {
+      goal_distances_[node_id] = distance;
+      goal_generations_[node_id] = generation_;
+    }
+  }
+  // The goal is reached from the landmarks through the nodes of its cluster.
+  goal_landmark_distances_.fill(-1);
+  for (int64_t node_id : clusters_[search_goal_cluster_].nodes) {
+    if (goal_generations_[node_id] != generation_) {
+      continue;
+    }
+    for (int64_t landmark{0}; landmark < kNumLandmarks; landmark++) {
+      int64_t const distance{
+          landmark_distances_[node_id * kNumLandmarks + landmark]};
+      int64_t& goal_distance{goal_landmark_distances_[landmark]};
+      if (distance != -1 &&
+          (goal_distance == -1 ||
+           distance + goal_distances_[node_id] < goal_distance)) {
+        goal_distance = distance + goal_distances_[node_id];
+      }
+    }
+  }
+
+  /* Link the start to the nodes of its cluster. If the goal is in the same
+   * cluster, going straight to it is a first candidate. */
+  exploreCluster(start.x(), start.y(), -1);
+  search_start_cluster_ = clusterAt(start.x(), start.y());
+  best_cost_ = -1;
+  best_last_node_ = -1;
+  if (search_start_cluster_ == search_goal_cluster_) {
+    best_cost_ = cluster_distances_[indexInCluster(goal.x(), goal.y())];
+  }
+
+  /* Clusters differ, so the path goes through at least one entrance: another
+   * character may already have found a route. */
+  if (search_start_cluster_ != search_goal_cluster_ &&
+      path_cache_.find(search_start_cluster_, search_goal_cluster_,
+                       size_class_, cached_waypoints_) &&
+      isCachedRouteUsable(search_start_cluster_)) {
+    waypoints.push_back(start);
+    waypoints.insert(waypoints.end(), cached_waypoints_.begin(),
+                     cached_waypoints_.end());
+    waypoints.push_back(goal);
+    return SearchStatus::kFound;
+  }
+
+  open_.clear();
+  for (int64_t node_id : clusters_[search_start_cluster_].nodes) {
+    int64_t const distance{cluster_distances_[indexInCluster(
+        nodes_[node_id].x, nodes_[node_id].y)]};
+    if (distance != -1) {
+      costs_[node_id] = distance;
+      parents_[node_id] = -1;
+      generations_[node_id] = generation_;
+      open_.emplace_back(distance + heuristic(node_id), heuristic(node_id),
+                         node_id);
+      push_heap(open_.begin(), open_.end(), greater<>{});
+    }
+  }
+
+  searching_ = true;
+  return SearchStatus::kInProgress;
+}
+
+HierarchicalPathFinder::SearchStatus HierarchicalPathFinder::continueSearch(
+    int64_t max_expansions, vector<TilePosition>& waypoints) {
+  waypoints.clear();
+  if (!searching_) {
+    throw logic_error("No search in progress");
+  }
+
+  // A* on the abstract graph, the open list is lazily purged.
+  for (int64_t expansions{0}; !open_.empty(); expansions++) {
+    if (expansions == max_expansions) {
+      return SearchStatus::kInProgress;
+    }
+
+    auto [estimate, node_heuristic, node_id]{open_.front()};
+    pop_heap(open_.begin(), open_.end(), greater<>{});
+    open_.pop_back();
+    if (best_cost_ != -1 && estimate >= best_cost_) {
+      break;
+    }
+    Node const& node{nodes_[node_id]};
+    int64_t const cost{costs_[node_id]};
+    if (estimate != cost + node_heuristic) {
+      // Outdated entry, the node was reached with a lower cost since.
+      continue;
+    }
+
+    if (goal_generations_[node_id] == generation_ &&
+        (best_cost_ == -1 || cost + goal_distances_[node_id] < best_cost_)) {
+      best_cost_ = cost + goal_distances_[node_id];
+      best_last_node_ = node_id;
+    }
+
+    auto relax{[&](int64_t next_id, int64_t next_cost) {
+      if (generations_[next_id] != generation_ || next_cost < costs_[next_id]) {
+        generations_[next_id] = generation_;
+        costs_[next_id] = next_cost;
+        parents_[next_id] = node_id;
+        int64_t const next_heuristic{heuristic(next_id)};
+        open_.emplace_back(next_cost + next_heuristic, next_heuristic,
+                           next_id);
+        push_heap(open_.begin(), open_.end(), greater<>{});
+      }
+    }};
+    relax(node.partner, cost + 1);
+    for (auto [next_id, distance] : node.edges) {
+      relax(next_id, cost + distance);
+    }
+  }
+
+  searching_ = false;
+  if (best_cost_ == -1) {
+    return SearchStatus::kNotFound;
+  }
+
+  waypoints.push_back(search_goal_);
+  for (int64_t node_id{best_last_node_}; node_id != -1;
+       node_id = parents_[node_id]) {
+    waypoints.emplace_back(nodes_[node_id].x, nodes_[node_id].y);
+  }
+  waypoints.push_back(search_start_);
+  reverse(waypoints.begin(), waypoints.end());
+
+  if (search_start_cluster_ != search_goal_cluster_) {
+    cached_waypoints_.assign(waypoints.begin() + 1, waypoints.end() - 1);
+    crossed_clusters_.clear();
+    for (TilePosition const& waypoint : cached_waypoints_) {
+      int64_t const cluster{clusterAt(waypoint.x(), waypoint.y())};
+      if (crossed_clusters_.empty() || crossed_clusters_.back() != cluster) {
+        crossed_clusters_.push_back(cluster);
+      }
+    }
+    path_cache_.store(search_start_cluster_, search_goal_cluster_,
+                      size_class_, cached_waypoints_, crossed_clusters_);
+  }
+  return SearchStatus::kFound;
+}
+
+bool HierarchicalPathFinder::findAbstractPath(TilePosition const& start,
+                                              TilePosition const& goal,
+                                              vector<TilePosition>& waypoints) {
+  SearchStatus status{beginSearch(start, goal, waypoints)};
+  if (status == SearchStatus::kInProgress) {
+    status = continueSearch(numeric_limits<int64_t>::max(), waypoints);
+  }
+
+  return status == SearchStatus::kFound;
+}
+
+bool HierarchicalPathFinder::findPath(TilePosition const& start,
+                                      TilePosition const& goal,
+                                      vector<TilePosition>& path) {
+  vector<TilePosition> waypoints;
+  path.clear();
+  if (!findAbstractPath(start, goal, waypoints)) {
+    return false;
+  }
+
+  path.push_back(start);
+  for (int64_t i{1}; i < waypoints.size(); i++) {
+    if (!refine(waypoints[i - 1], waypoints[i], path)) {
+      path.clear();
+      return false;
+    }
+  }
+
+  return true;
+}
+
+int64_t HierarchicalPathFinder::heuristic(int64_t node_id) const {
+  int64_t estimate{abs(search_goal_.x() - nodes_[node_id].x) +
+                   abs(search_goal_.y() - nodes_[node_id].y)};
+  for (int64_t landmark{0}; landmark < kNumLandmarks; landmark++) {
+    int64_t const distance{
+        landmark_distances_[node_id * kNumLandmarks + landmark]};
+    int64_t const goal_distance{goal_landmark_distances_[landmark]};
+    if (distance != -1 && goal_distance != -1) {
+      estimate = max(estimate, abs(goal_distance - distance));
+    }
+  }
+  return estimate;
+}
+
+int64_t HierarchicalPathFinder::indexInCluster(int64_t x, int64_t y) const {
+  return (y % kClusterSize) * kClusterSize + x % kClusterSize;
+}
+
+bool HierarchicalPathFinder::isCachedRouteUsable(int64_t start_cluster) const {
+  /* The clusters the route goes through did not change (the cache checks it),
+   * but the route may have been found for a solid of another shape, or for a
+   * start or goal on the other side of a wall inside their cluster. */
+  for (TilePosition const& waypoint : cached_waypoints_) {
+    if (!isWalkable(waypoint.x(), waypoint.y())) {
+      return false;
+    }
+  }
+
+  TilePosition const& first{cached_waypoints_.front()};
+  if (clusterAt(first.x(), first.y()) != start_cluster ||
+      cluster_distances_[indexInCluster(first.x(), first.y())] == -1) {
+    return false;
+  }
+
+  TilePosition const& last{cached_waypoints_.back()};
+  for (int64_t node_id : clusters_[search_goal_cluster_].nodes) {
+    if (nodes_[node_id].x == last.x() && nodes_[node_id].y == last.y()) {
+      return goal_generations_[node_id] == generation_;
+    }
+  }
+  return false;
+}
+
+bool HierarchicalPathFinder::isInLevel(TilePosition const& tile) const {
+  return tile.x() >= 0 && tile.x() < width_ && tile.y() >= 0 &&
+         tile.y() < height_;
+}
+
+bool HierarchicalPathFinder::isSearching() const { return searching_; }
+
+bool HierarchicalPathFinder::isWalkable(int64_t x, int64_t y) const {
+  return walkable_[y * width_ + x];
+}
+
+void HierarchicalPathFinder::onTileChanged(int64_t x, int64_t y) {
+  /* The tile matters for every location where the solid overlaps it. Find how
+   * far the solid can reach from the tile it stands on. */
+  Level const& level{clearance_map_.level()};
+  PositionedRectangle const& bounding_box{solid_.boundingBox()};
+  int64_t const reach_x{
+      (abs(bounding_box.x()) + bounding_box.width()) /
+          level.spriteset().spritesWidth() +
+      1};
+  int64_t const reach_y{
+      (abs(bounding_box.y()) + bounding_box.height()) /
+          level.spriteset().spritesHeight() +
+      1};
+
+  set<int64_t> changed_clusters;
+  // The graph may change under a search in progress, drop it.
+  searching_ = false;
+  for (int64_t j{max<int64_t>(0, y - reach_y)};
+       j <= min(height_ - 1, y + reach_y); j++) {
+    for (int64_t i{max<int64_t>(0, x - reach_x)};
+         i <= min(width_ - 1, x + reach_x); i++) {
+      bool const walkable{PathFinder::isWalkable(solid_, i, j, clearance_map_)};
+      if (walkable != walkable_[j * width_ + i]) {
+        walkable_[j * width_ + i] = walkable;
+        changed_clusters.insert(clusterAt(i, j));
+      }
+    }
+  }
+
+  /* The borders of a changed cluster are rebuilt, which changes the nodes of
+   * the neighbour clusters too: their edges must be recomputed as well. */
+  set<int64_t> clusters_to_connect;
+  for (int64_t cluster : changed_clusters) {
+    int64_t const cluster_x{cluster % clusters_per_row_};
+    int64_t const cluster_y{cluster / clusters_per_row_};
+    buildBorders(cluster);
+    clusters_to_connect.insert(cluster);
+    if (cluster_x > 0) {
+      rebuildBorder(clusters_[cluster - 1].right_border, cluster - 1, true);
+      clusters_to_connect.insert(cluster - 1);
+    }
+    if (cluster_y > 0) {
+      rebuildBorder(clusters_[cluster - clusters_per_row_].bottom_border,
+                    cluster - clusters_per_row_, false);
+      clusters_to_connect.insert(cluster - clusters_per_row_);
+    }
+    if (cluster_x < clusters_per_row_ - 1) {
+      clusters_to_connect.insert(cluster + 1);
+    }
+    if (cluster_y < clusters_per_column_ - 1) {
+      clusters_to_connect.insert(cluster + clusters_per_row_);
+    }
+  }
+  for (int64_t cluster : clusters_to_connect) {
+    buildEdges(cluster);
+    path_cache_.invalidate(cluster);
+  }
+  // Distances may have changed anywhere, they are computed again when needed.
+  if (!changed_clusters.empty()) {
+    landmarks_outdated_ = true;
+  }
+}
+
+void HierarchicalPathFinder::rebuildBorder(vector<int64_t>& border,
+                                           int64_t cluster, bool right) {
+  removeNodes(border);
+
+  int64_t const cluster_x{cluster % clusters_per_row_};
+  int64_t const cluster_y{cluster / clusters_per_row_};
+  if ((right && cluster_x == clusters_per_row_ - 1) ||
+      (!right && cluster_y == clusters_per_column_ - 1)) {
+    // No neighbour on that side.
+    return;
+  }
+
+  /* Walk along the border. Each run of locations walkable on both sides makes
+   * up an entrance, with a pair of nodes in its middle. */
+  int64_t const length{
+      right ? min(kClusterSize, height_ - cluster_y * kClusterSize)
+            : min(kClusterSize, width_ - cluster_x * kClusterSize)};
+  auto inside{[&](int64_t step) {
+    return right ? TilePosition{(cluster_x + 1) * kClusterSize - 1,
+                                cluster_y * kClusterSize + step}
+                 : TilePosition{cluster_x * kClusterSize + step,
+                                (cluster_y + 1) * kClusterSize - 1};
+  }};
+  int64_t run_start{-1};
+  for (int64_t step{0}; step <= length; step++) {
+    bool open{false};
+    if (step < length) {
+      TilePosition const tile{inside(step)};
+      open = isWalkable(tile.x(), tile.y()) &&
+             (right ? isWalkable(tile.x() + 1, tile.y())
+                    : isWalkable(tile.x(), tile.y() + 1));
+    }
+    if (open && run_start == -1) {
+      run_start = step;
+    } else if (!open && run_start != -1) {
+      TilePosition const middle{inside((run_start + step - 1) / 2)};
+      if (right) {
+        addEntrance(middle.x(), middle.y(), middle.x() + 1, middle.y(),
+                    border);
+      } else {
+        addEntrance(middle.x(), middle.y(), middle.x(), middle.y() + 1,
+                    border);
+      }
+      run_start = -1;
+    }
+  }
+}
+
+bool HierarchicalPathFinder::refine(TilePosition const& from,
+                                    TilePosition const& to,
+                                    vector<TilePosition>& path) {
+  if (!isInLevel(from) || !isInLevel(to)) {
+    return false;
+  }
+  if (abs(to.x() - from.x()) + abs(to.y() - from.y()) == 1 &&
+      clusterAt(from.x(), from.y()) != clusterAt(to.x(), to.y())) {
+    // Crossing a border.
+    if (!isWalkable(to.x(), to.y())) {
+      return false;
+    }
+    path.push_back(to);
+    return true;
+  }
+
+  if (clusterAt(from.x(), from.y()) != clusterAt(to.x(), to.y()) ||
+      !isWalkable(from.x(), from.y()) || !isWalkable(to.x(), to.y())) {
+    return false;
+  }
+
+  /* Explore from the destination, so that following the parents from the
+   * origin gives the tiles in order. */
+  int64_t current{indexInCluster(from.x(), from.y())};
+  exploreCluster(to.x(), to.y(), current);
+  if (cluster_distances_[current] == -1) {
+    return false;
+  }
+  int64_t const left{(from.x() / kClusterSize) * kClusterSize};
+  int64_t const top{(from.y() / kClusterSize) * kClusterSize};
+  for (current = cluster_parents_[current]; current != -1;
+       current = cluster_parents_[current]) {
+    path.emplace_back(left + current % kClusterSize,
+                      top + current / kClusterSize);
+  }
+
+  return true;
+}
+
+void HierarchicalPathFinder::removeNodes(vector<int64_t>& node_ids) {
+  for (int64_t node_id : node_ids) {
+    erase(clusters_[nodes_[node_id].cluster].nodes, node_id);
+    nodes_[node_id].edges.clear();
+    free_nodes_.push_back(node_id);
+  }
+  node_ids.clear();
+}
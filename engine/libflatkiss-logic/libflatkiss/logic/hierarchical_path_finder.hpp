@@ -0,0 +1,266 @@
+/*
+ * Copyright (C) 2021-2023 Jean-Marie BARAN (jeanmarie.baran@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Refer to 'COPYING.txt' for the full notice.
+ */
+
+#ifndef LIBFLATKISS_LOGIC_HIERARCHICAL_PATH_FINDER_HPP_INCLUDED
+#define LIBFLATKISS_LOGIC_HIERARCHICAL_PATH_FINDER_HPP_INCLUDED
+
+#include <array>
+#include <libflatkiss/logic/clearance_map.hpp>
+#include <libflatkiss/logic/path_cache.hpp>
+#include <libflatkiss/model/model.hpp>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Finds paths in large levels using hierarchical path finding (HPA*).
+ *
+ * The level is split into square clusters of tiles. Where two neighbour
+ * clusters can be crossed from one to the other, an entrance is placed: a pair
+ * of nodes, one on each side of the border. Inside each cluster the cost of
+ * going from any entrance node to any other is computed when the path finder is
+ * built. Together the nodes and the costs make up an abstract graph, much
+ * smaller than the level, on which the search for a path actually runs.
+ *
+ * A search returns waypoints: the start, the entrances to go through, and the
+ * goal. Two successive waypoints are either in the same cluster or on each side
+ * of a border, so the path between them is cheap to compute with refine(),
+ * which callers can do lazily when they reach a waypoint.
+ *
+ * The path finder works for a given solid (the walkable tiles depend on its
+ * size). When a tile of the level changes, onTileChanged() only recomputes the
+ * clusters around it.
+ *
+ * The search of the abstract graph is guided by landmarks: a few nodes spread
+ * along the edges of the level, whose distances to every node are computed
+ * when the graph is built (and again before the next search once a tile
+ * changed). By the triangle inequality, the difference of the distances of a
+ * landmark to a node and to the goal is a lower bound of the distance between
+ * them, much closer than the Manhattan distance once walls make the paths
+ * wind. The paths found are as short as without landmarks, with fewer nodes
+ * expanded.
+ *
+ * Routes between clusters are looked up in a path cache before searching the
+ * abstract graph, and stored there afterwards. The cache can be shared by the
+ * path finders of all the solids of a level, routes are kept apart by class of
+ * size.
+ */
+class HierarchicalPathFinder {
+ public:
+  enum class SearchStatus {
+    kInProgress,
+    kFound,
+    kNotFound,
+  };
+
+  /**
+   * @brief Build the abstract graph of the level for the given solid.
+   *
+   * @param solid The solid which follows the paths.
+   * @param clearance_map Clearances of the level, must outlive the path finder.
+   * @param path_cache Cache of routes, must outlive the path finder.
+   */
+  HierarchicalPathFinder(Solid const& solid, ClearanceMap const& clearance_map,
+                         PathCache& path_cache);
+  /**
+   * @brief Start searching for the waypoints of a path, refer to
+   * findAbstractPath().
+   *
+   * The search is then carried on with continueSearch(), so that it can be
+   * spread over several calls. There is a single search in progress at a time:
+   * starting a search drops the previous one.
+   *
+   * @return SearchStatus kInProgress unless the answer is already known (e.g.
+   * the route was in the cache), in which case waypoints receives it.
+   */
+  SearchStatus beginSearch(TilePosition const& start, TilePosition const& goal,
+                           std::vector<TilePosition>& waypoints);
+  /**
+   * @brief Carry on with the search in progress.
+   *
+   * @param max_expansions Maximum number of nodes to expand before returning.
+   * @param waypoints Receives the waypoints when the search ends with a path.
+   * @return SearchStatus Whether the search is over, and its outcome.
+   */
+  SearchStatus continueSearch(int64_t max_expansions,
+                              std::vector<TilePosition>& waypoints);
+  /**
+   * @brief Find the waypoints of a path from the start tile to the goal tile.
+   *
+   * @param start Tile where the path starts.
+   * @param goal Tile where the path ends.
+   * @param waypoints Receives the waypoints from the start to the goal, both
+   * included. Cleared first. Left empty when there is no path.
+   * @return bool Whether a path was found, false when the start or the goal
+   * is out of the level.
+   */
+  bool findAbstractPath(TilePosition const& start, TilePosition const& goal,
+                        std::vector<TilePosition>& waypoints);
+  /**
+   * @brief Find the full path from the start tile to the goal tile.
+   *
+   * This is findAbstractPath() followed by the refinement of every segment.
+   *
+   * @param path Receives the tiles of the path, both ends included.
+   * @return bool Whether a path was found.
+   */
+  bool findPath(TilePosition const& start, TilePosition const& goal,
+                std::vector<TilePosition>& path);
+  /**
+   * @brief Whether a search was begun and is not over yet.
+   */
+  bool isSearching() const;
+  /**
+   * @brief Notify the path finder that a tile of the level was replaced.
+   *
+   * The clearance map must have been notified first. This drops the search in
+   * progress, if any.
+   *
+   * @param x Location of the tile along the horizontal axis, in tiles.
+   * @param y Location of the tile along the vertical axis, in tiles.
+   */
+  void onTileChanged(int64_t x, int64_t y);
+  /**
+   * @brief Compute the tiles between two successive waypoints.
+   *
+   * @param from The first waypoint.
+   * @param to The next waypoint.
+   * @param path The tiles after `from` up to `to` included are appended to it.
+   * @return bool False if the waypoints are not connected anymore (a tile
+   * changed since the waypoints were computed).
+   */
+  bool refine(TilePosition const& from, TilePosition const& to,
+              std::vector<TilePosition>& path);
+  /**
+   * @brief Returns the cluster containing the given tile.
+   *
+   * Clusters are numbered from the top left of the level, row by row.
+   */
+  int64_t clusterAt(int64_t x, int64_t y) const;
+
+  // Side of a cluster in tiles.
+  static int64_t constexpr kClusterSize{16};
+  // Number of landmarks guiding the searches, refer to the class.
+  static int64_t constexpr kNumLandmarks{16};
+
+ private:
+  struct Node {
+    int64_t x{0};
+    int64_t y{0};
+    int64_t cluster{-1};
+    // Node on the other side of the border.
+    int64_t partner{-1};
+    // Nodes of the same cluster which can be reached, with their costs.
+    std::vector<std::pair<int64_t, int64_t>> edges;
+  };
+
+  struct Cluster {
+    std::vector<int64_t> nodes;
+    // Nodes of the entrances with the cluster to the right, on both sides.
+    std::vector<int64_t> right_border;
+    // Nodes of the entrances with the cluster below, on both sides.
+    std::vector<int64_t> bottom_border;
+  };
+
+  Solid const solid_;
+  ClearanceMap const& clearance_map_;
+  PathCache& path_cache_;
+  // Size of the solid in cells of the clearance map, along its largest side.
+  int64_t const size_class_;
+  int64_t const width_;
+  int64_t const height_;
+  int64_t const clusters_per_row_;
+  int64_t const clusters_per_column_;
+  std::vector<bool> walkable_;
+  std::vector<Cluster> clusters_;
+  std::vector<Node> nodes_;
+  std::vector<int64_t> free_nodes_;
+  /* Distance from each landmark to each node (-1 when not connected), the
+   * landmarks of a node next to each other. */
+  std::vector<int64_t> landmark_distances_;
+  // Whether the graph changed since the distances were computed.
+  bool landmarks_outdated_{true};
+
+  // Scratch memory for the searches, kept between queries.
+  std::vector<int64_t> cluster_distances_;
+  std::vector<int64_t> cluster_parents_;
+  std::vector<int64_t> cluster_queue_;
+  std::vector<int64_t> costs_;
+  std::vector<int64_t> parents_;
+  std::vector<uint32_t> generations_;
+  uint32_t generation_{0};
+  /* Estimated cost, heuristic and node: among the nodes with the same estimate,
+   * the closest to the goal is expanded first. */
+  std::vector<std::tuple<int64_t, int64_t, int64_t>> open_;
+  // Distance from each node to the goal, valid where stamped by generation_.
+  std::vector<int64_t> goal_distances_;
+  std::vector<uint32_t> goal_generations_;
+  // Distance from each landmark to the goal (-1 when not connected).
+  std::array<int64_t, kNumLandmarks> goal_landmark_distances_{};
+  std::vector<TilePosition> cached_waypoints_;
+  std::vector<int64_t> crossed_clusters_;
+
+  // State of the search in progress.
+  bool searching_{false};
+  TilePosition search_start_{0, 0};
+  TilePosition search_goal_{0, 0};
+  int64_t search_start_cluster_{-1};
+  int64_t search_goal_cluster_{-1};
+  int64_t best_cost_{-1};
+  int64_t best_last_node_{-1};
+
+  void addEntrance(int64_t x1, int64_t y1, int64_t x2, int64_t y2,
+                   std::vector<int64_t>& border);
+  int64_t addNode(int64_t x, int64_t y);
+  void buildBorders(int64_t cluster);
+  void buildEdges(int64_t cluster);
+  /**
+   * @brief Pick the landmarks and compute their distances to every node.
+   */
+  void computeLandmarks();
+  /**
+   * @brief Breadth-first search from a tile restricted to its cluster.
+   *
+   * Fills cluster_distances_ (-1 when not reachable) and cluster_parents_,
+   * both indexed by the location in the cluster. Only the locations reached by
+   * the previous exploration are reset.
+   *
+   * @param until Location in the cluster at which to stop once reached, or -1
+   * to explore the whole cluster.
+   */
+  void exploreCluster(int64_t x, int64_t y, int64_t until);
+  /**
+   * @brief Estimated cost from a node to the goal of the search in progress,
+   * never more than the actual cost.
+   */
+  int64_t heuristic(int64_t node_id) const;
+  int64_t indexInCluster(int64_t x, int64_t y) const;
+  /**
+   * @brief Whether the cached route can be followed between the start and the
+   * goal, given the links computed for them by findAbstractPath().
+   */
+  bool isCachedRouteUsable(int64_t start_cluster) const;
+  bool isInLevel(TilePosition const& tile) const;
+  bool isWalkable(int64_t x, int64_t y) const;
+  void rebuildBorder(std::vector<int64_t>& border, int64_t cluster,
+                     bool right);
+  void removeNodes(std::vector<int64_t>& node_ids);
+};
+
+#endif
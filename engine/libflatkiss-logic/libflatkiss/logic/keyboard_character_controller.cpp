@@ -25,42 +25,51 @@ using std::min;
 using std::move;
 using std::vector;
 
-KeyboardCharacterController::KeyboardCharacterController(Character& character)
+KeyboardCharacterController::KeyboardCharacterController(
+    Character const& character)
     : character_{character},
-      max_sidestep_distance_{character.positionedSolid().boundingBox().width() /
-                             2} {}
+      max_sidestep_distance_{character.solid().boundingBox().width() / 2} {}
 
 Character const& KeyboardCharacterController::character() const {
   return character_;
 }
 
-void KeyboardCharacterController::onTick(int64_t tick,
-                                         EventHandler const& event_handler,
-                                         Navigator const& navigator,
-                                         Level const& level) {
+int64_t KeyboardCharacterController::onTick(TickContext const& context) {
+  // Move as far as during all the ticks since the last call.
+  int64_t const speed{kSpeedInPixels * (context.tick - last_tick_)};
+  last_tick_ = context.tick;
+
   int64_t delta_x{0};
   int64_t delta_y{0};
-  if (event_handler.isKeyPressed(Key::kUp)) {
-    delta_y -= kSpeedInPixels;
+  if (context.event_handler.isKeyPressed(Key::kUp)) {
+    delta_y -= speed;
   }
-  if (event_handler.isKeyPressed(Key::kDown)) {
-    delta_y += kSpeedInPixels;
+  if (context.event_handler.isKeyPressed(Key::kDown)) {
+    delta_y += speed;
   }
-  if (event_handler.isKeyPressed(Key::kLeft)) {
-    delta_x -= kSpeedInPixels;
+  if (context.event_handler.isKeyPressed(Key::kLeft)) {
+    delta_x -= speed;
   }
-  if (event_handler.isKeyPressed(Key::kRight)) {
-    delta_x += kSpeedInPixels;
+  if (context.event_handler.isKeyPressed(Key::kRight)) {
+    delta_x += speed;
   }
-  Vector desired_displacement{delta_x, delta_y};
 
   /* Each tick, increase the sidestep lookup distance by one. This causes the
    * character to slow down when side-stepping (compared to looking up the
    * maximum distance right away). */
   sidestep_distance_ = min(max_sidestep_distance_, sidestep_distance_ + 1);
-  auto [side_stepped, final_position]{
-      navigator.moveBy(character_.positionedSolid(), desired_displacement,
-                       level, sidestep_distance_, kSpeedInPixels, true)};
+  context.move_batch.submit(*this, character_.solid(), character_.position(),
+                            Vector{delta_x, delta_y}, sidestep_distance_,
+                            kSpeedInPixels, true);
+
+  // The keys are read at every tick.
+  return context.tick + 1;
+}
+
+void KeyboardCharacterController::onMoved(Navigator::MoveIntent const& intent,
+                                          Navigator::MoveResult const& result) {
+  Vector const& desired_displacement{intent.desired_displacement};
+  Position final_position{result.position};
   if (final_position != character_.position()) {
     /* In case of side-stepping, this resets the lookup from start, causing the
      * slow down to be gradual with the distance to the final side-step. When
@@ -70,7 +79,7 @@ void KeyboardCharacterController::onTick(int64_t tick,
 
   character_.updateFacingDirection(
       // When side-stepping, do as if the character were not changing direction.
-      desired_displacement, side_stepped
+      desired_displacement, result.has_side_stepped
                                 ? desired_displacement
                                 : final_position - character_.position());
   character_.moveTo(move(final_position));
@@ -27,18 +27,22 @@
 #include <memory>
 #include <vector>
 
-class KeyboardCharacterController : public CharacterController {
+class KeyboardCharacterController final : public CharacterController {
  public:
-  KeyboardCharacterController(Character& character);
-  Character const& character() const;
-  void onTick(int64_t tick, EventHandler const& event_handler,
-              Navigator const& navigator, Level const& level);
+  KeyboardCharacterController(Character const& character);
+  Character const& character() const override;
+  int64_t onTick(TickContext const& context) override;
+  void onMoved(Navigator::MoveIntent const& intent,
+               Navigator::MoveResult const& result) override;
+
+  static ControllerType constexpr kType{ControllerType::kKeyboardController};
 
  private:
-  Character& character_;
+  Character character_;
   static int64_t constexpr kSpeedInPixels{1};
   int64_t const max_sidestep_distance_;
   int64_t sidestep_distance_{0};
+  int64_t last_tick_{0};
 };
 
 #endif
@@ -0,0 +1,43 @@
+/*
+ * Copyright (C) 2021-2023 Jean-Marie BARAN (jeanmarie.baran@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Refer to 'COPYING.txt' for the full notice.
+ */
+
+#ifndef LIBFLATKISS_LOGIC_LEVEL_OF_DETAIL_HPP_INCLUDED
+#define LIBFLATKISS_LOGIC_LEVEL_OF_DETAIL_HPP_INCLUDED
+
+#include <cstdint>
+
+/**
+ * @brief How finely characters are simulated, depending on how far they are
+ * from the closest observer of their level.
+ *
+ * Distances are measured in pixels from the area of the observer (zero inside
+ * of it). Up to the near distance, characters are simulated at every tick.
+ * Farther, their controllers are called only once every reduced interval and
+ * catch up with the ticks they missed by moving further at once. Beyond the
+ * far distance, they are called once every coarse interval and their moves
+ * skip the navigator: they only go where the clearance map says they fit.
+ */
+struct LevelOfDetail {
+  int64_t near_distance;
+  int64_t far_distance;
+  int64_t reduced_tick_interval;
+  int64_t coarse_tick_interval;
+};
+
+#endif
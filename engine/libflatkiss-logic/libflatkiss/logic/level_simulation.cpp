@@ -0,0 +1,308 @@
+/*
+ * Copyright (C) 2021-2023 Jean-Marie BARAN (jeanmarie.baran@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Refer to 'COPYING.txt' for the full notice.
+ */
+
+#include <algorithm>
+#include <libflatkiss/logic/character_controller_loader.hpp>
+#include <libflatkiss/logic/level_simulation.hpp>
+#include <limits>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+using std::erase_if;
+using std::find_if;
+using std::invalid_argument;
+using std::max;
+using std::min;
+using std::numeric_limits;
+using std::optional;
+using std::pair;
+using std::sort;
+using std::to_string;
+using std::unordered_map;
+using std::vector;
+
+LevelSimulation::LevelSimulation(
+    Level& level, unordered_map<int64_t, Solid const> const& solids,
+    LevelOfDetail const& level_of_detail, uint64_t seed)
+    : level_{level},
+      tile_solids_{level, solids},
+      clearance_map_{tile_solids_},
+      flow_fields_{clearance_map_, kFlowFieldCacheCapacity},
+      path_cache_{kPathCacheCapacity},
+      path_requests_{clearance_map_, path_cache_},
+      level_of_detail_{level_of_detail},
+      seed_{seed} {
+  // All the controllers start active.
+  wake_ticks_.resize(level.numCharacterSlots(), kWaitingForEvent);
+  for (int64_t i{0}; i < level.numCharacterSlots(); i++) {
+    if (level.isCharacterAlive(i)) {
+      activate(level.character(i));
+    }
+  }
+}
+
+void LevelSimulation::activate(Character const& character) {
+  CharacterControllerLoader::load(character, seed_, character_controllers_);
+  if (character.index() >= wake_ticks_.size()) {
+    wake_ticks_.resize(character.index() + 1, kWaitingForEvent);
+  }
+  wake_ticks_[character.index()] = kWaitingForEvent;
+  wake(character.index());
+}
+
+int64_t LevelSimulation::addObserver(PositionedRectangle const& area) {
+  observers_.emplace(next_observer_, area);
+  return next_observer_++;
+}
+
+CharacterControllerPool& LevelSimulation::characterControllers() {
+  return character_controllers_;
+}
+
+ClearanceMap& LevelSimulation::clearanceMap() { return clearance_map_; }
+
+void LevelSimulation::despawn(Character const& character) {
+  if (!character.isAlive()) {
+    throw invalid_argument("The character is not alive");
+  }
+
+  // Its timers are now stale, they will be ignored.
+  wake_ticks_[character.index()] = kWaitingForEvent;
+  character_controllers_.remove(character.index());
+  level_.despawnCharacter(character);
+}
+
+// NOLINTBEGIN(readability-identifier-length)
+int64_t LevelSimulation::distanceToObservers(Position const& position) const {
+  int64_t distance{numeric_limits<int64_t>::max()};
+  for (auto const& [observer, area] : observers_) {
+    int64_t const dx{
+        max({area.x() - position.x(), int64_t{0},
+             position.x() - (area.x() + area.rectangle().width())})};
+    int64_t const dy{
+        max({area.y() - position.y(), int64_t{0},
+             position.y() - (area.y() + area.rectangle().height())})};
+    distance = min(distance, max(dx, dy));
+  }
+  return distance;
+}
+// NOLINTEND(readability-identifier-length)
+
+FlowFieldCache& LevelSimulation::flowFields() { return flow_fields_; }
+
+int64_t LevelSimulation::idleTicks() const {
+  if (!next_active_controllers_.empty() || path_requests_.queueDepth() > 0) {
+    return 0;
+  }
+  return wake_timers_.idleTicks();
+}
+
+bool LevelSimulation::isObserved() const { return !observers_.empty(); }
+
+Level& LevelSimulation::level() { return level_; }
+
+PathRequestService& LevelSimulation::pathRequests() { return path_requests_; }
+
+void LevelSimulation::preload(Solid const& solid) {
+  path_requests_.pathFinder(solid);
+  for (int64_t i{0}; i < level_.numCharacterSlots(); i++) {
+    if (level_.isCharacterAlive(i)) {
+      path_requests_.pathFinder(level_.characterTemplate(i).solid());
+    }
+  }
+}
+
+Character LevelSimulation::spawn(CharacterTemplate const& character_template,
+                                 Position const& position) {
+  Character character{level_.spawnCharacter(character_template, position)};
+  activate(character);
+  return character;
+}
+
+void LevelSimulation::moveObserver(int64_t observer, Position const& position) {
+  auto const observer_it{observers_.find(observer)};
+  if (observer_it == observers_.end()) {
+    throw invalid_argument("Unknown observer " + to_string(observer));
+  }
+  observer_it->second.x(position.x());
+  observer_it->second.y(position.y());
+}
+
+void LevelSimulation::removeObserver(int64_t observer) {
+  if (observers_.erase(observer) == 0) {
+    throw invalid_argument("Unknown observer " + to_string(observer));
+  }
+}
+
+void LevelSimulation::restore(Snapshot const& snapshot) {
+  changed_tiles_.clear();
+  level_.restore(snapshot.level_, changed_tiles_);
+  for (TilePosition const& tile_position : changed_tiles_) {
+    clearance_map_.onTileChanged(tile_position.x(), tile_position.y());
+    path_requests_.onTileChanged(tile_position.x(), tile_position.y());
+  }
+  if (!changed_tiles_.empty()) {
+    flow_fields_.clear();
+  }
+  character_controllers_.copyFrom(snapshot.character_controllers_);
+  /* After the path finders caught up with the tiles, which invalidated routes
+   * that are valid again. */
+  path_cache_.restore(snapshot.path_cache_);
+  path_requests_.restore(snapshot.path_requests_);
+  ticks_ = snapshot.ticks_;
+  wake_timers_ = snapshot.wake_timers_;
+  wake_ticks_ = snapshot.wake_ticks_;
+  next_active_controllers_ = snapshot.next_active_controllers_;
+}
+
+void LevelSimulation::save(Snapshot& snapshot) const {
+  level_.save(snapshot.level_);
+  snapshot.character_controllers_.copyFrom(character_controllers_);
+  path_cache_.save(snapshot.path_cache_);
+  path_requests_.save(snapshot.path_requests_);
+  snapshot.ticks_ = ticks_;
+  snapshot.wake_timers_ = wake_timers_;
+  snapshot.wake_ticks_ = wake_ticks_;
+  snapshot.next_active_controllers_ = next_active_controllers_;
+}
+
+void LevelSimulation::skip(int64_t num_ticks) {
+  if (num_ticks > idleTicks()) {
+    throw invalid_argument("Cannot skip ticks which are not idle");
+  }
+  wake_timers_.skip(num_ticks);
+  ticks_ += num_ticks;
+}
+
+void LevelSimulation::tick(EventHandler const& event_handler,
+                           Navigator const& navigator,
+                           int64_t path_budget_expansions) {
+  ticks_++;
+  active_controllers_.swap(next_active_controllers_);
+  next_active_controllers_.clear();
+  wake_timers_.advance(active_controllers_);
+
+  /* Drop the stale timers and the duplicates, and keep the order of the
+   * controllers so that runs are reproducible. */
+  erase_if(active_controllers_, [this](int64_t controller_index) {
+    if (wake_ticks_[controller_index] != ticks_) {
+      return true;
+    }
+    wake_ticks_[controller_index] = kWaitingForEvent;
+    return false;
+  });
+  /* Group the controllers by type, so that each type is ticked in one loop
+   * (refer to CharacterControllerPool). */
+  sort(active_controllers_.begin(), active_controllers_.end(),
+       [this](int64_t first, int64_t second) {
+         return pair{character_controllers_.type(first), first} <
+                pair{character_controllers_.type(second), second};
+       });
+
+  TickContext const context{ticks_, event_handler, move_batch_, level_,
+                            clearance_map_, flow_fields_, path_requests_};
+  auto first{active_controllers_.cbegin()};
+  while (first != active_controllers_.cend()) {
+    ControllerType const type{character_controllers_.type(*first)};
+    auto const last{find_if(first, active_controllers_.cend(),
+                            [this, type](int64_t controller_index) {
+                              return character_controllers_.type(
+                                         controller_index) != type;
+                            })};
+    switch (type) {
+      case ControllerType::kKeyboardController:
+        tickControllers(
+            character_controllers_.controllers<KeyboardCharacterController>(),
+            first, last, context);
+        break;
+      case ControllerType::kStrollController:
+        tickControllers(
+            character_controllers_.controllers<StrollCharacterController>(),
+            first, last, context);
+        break;
+      case ControllerType::kBytecodeController:
+        tickControllers(
+            character_controllers_.controllers<BytecodeCharacterController>(),
+            first, last, context);
+        break;
+      case ControllerType::kScriptedController:
+        tickControllers(
+            character_controllers_.controllers<ScriptedCharacterController>(),
+            first, last, context);
+        break;
+    }
+    first = last;
+  }
+  move_batch_.coarse(false);
+  move_batch_.resolve(navigator, tile_solids_, clearance_map_);
+  path_requests_.process(ticks_, path_budget_expansions);
+}
+
+template <typename Controller>
+void LevelSimulation::tickControllers(
+    vector<optional<Controller>>& controllers,
+    vector<int64_t>::const_iterator first,
+    vector<int64_t>::const_iterator last, TickContext const& context) {
+  for (auto it{first}; it != last; it++) {
+    int64_t const controller_index{*it};
+    Controller& controller{
+        *controllers[character_controllers_.indexInType(controller_index)]};
+
+    // The farther from the observers, the less often and the less finely.
+    int64_t const distance{
+        distanceToObservers(controller.character().position())};
+    int64_t tick_interval{1};
+    if (distance > level_of_detail_.far_distance) {
+      tick_interval = level_of_detail_.coarse_tick_interval;
+    } else if (distance > level_of_detail_.near_distance) {
+      tick_interval = level_of_detail_.reduced_tick_interval;
+    }
+    move_batch_.coarse(distance > level_of_detail_.far_distance);
+
+    int64_t const next_tick{controller.onTick(context)};
+    schedule(controller_index, next_tick == CharacterController::kWakeOnEvent
+                                   ? next_tick
+                                   : max(next_tick, ticks_ + tick_interval));
+  }
+}
+
+void LevelSimulation::schedule(int64_t controller_index, int64_t next_tick) {
+  if (next_tick == CharacterController::kWakeOnEvent) {
+    return;
+  }
+
+  if (next_tick <= ticks_ + 1) {
+    wake_ticks_[controller_index] = ticks_ + 1;
+    next_active_controllers_.push_back(controller_index);
+  } else {
+    wake_ticks_[controller_index] = next_tick;
+    wake_timers_.schedule(controller_index, next_tick);
+  }
+}
+
+int64_t LevelSimulation::ticks() const { return ticks_; }
+
+void LevelSimulation::wake(int64_t controller_index) {
+  if (wake_ticks_[controller_index] != ticks_ + 1) {
+    wake_ticks_[controller_index] = ticks_ + 1;
+    next_active_controllers_.push_back(controller_index);
+  }
+}
@@ -0,0 +1,261 @@
+/*
+ * Copyright (C) 2021-2023 Jean-Marie BARAN (jeanmarie.baran@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Refer to 'COPYING.txt' for the full notice.
+ */
+
+#ifndef LIBFLATKISS_LOGIC_LEVEL_SIMULATION_HPP_INCLUDED
+#define LIBFLATKISS_LOGIC_LEVEL_SIMULATION_HPP_INCLUDED
+
+#include <libflatkiss/logic/character_controller.hpp>
+#include <libflatkiss/logic/character_controller_pool.hpp>
+#include <libflatkiss/logic/clearance_map.hpp>
+#include <libflatkiss/logic/flow_field_cache.hpp>
+#include <libflatkiss/logic/level_of_detail.hpp>
+#include <libflatkiss/logic/move_batch.hpp>
+#include <libflatkiss/logic/navigator.hpp>
+#include <libflatkiss/logic/path_cache.hpp>
+#include <libflatkiss/logic/path_request_service.hpp>
+#include <libflatkiss/logic/tick_context.hpp>
+#include <libflatkiss/logic/tile_solids.hpp>
+#include <libflatkiss/logic/timer_wheel.hpp>
+#include <libflatkiss/media/media.hpp>
+#include <libflatkiss/model/model.hpp>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief Everything needed to simulate one level, apart from the others.
+ *
+ * A simulation owns the controllers of the characters of its level, and the
+ * structures they use to move around it (clearance map, flow fields, path
+ * requests, move batch). Two simulations share nothing that they modify, so
+ * they can be ticked at the same time on different threads.
+ *
+ * A simulation keeps its own count of ticks, advanced each time it is ticked:
+ * a level ticked less often than the others simply lives slower.
+ *
+ * Only the active controllers are ticked. A controller tells at each tick when
+ * it must be ticked next (refer to CharacterController::onTick()): the
+ * sleeping ones wait in a timer wheel, or until they are woken up.
+ *
+ * Characters far from the observers of the level are simulated less finely
+ * (refer to LevelOfDetail), so that the cost of a level grows with what is
+ * observed of it rather than with its population.
+ *
+ * The state of a simulation (with that of its level) can be saved in a
+ * snapshot and restored later, e.g. to roll back or rewind. Restoring a
+ * snapshot is a matter of copies into storages which are already large
+ * enough, so it can be done every frame.
+ */
+class LevelSimulation {
+ public:
+  /**
+   * @brief The state of a simulation and of its level at some tick (refer to
+   * save()).
+   */
+  class Snapshot {
+   private:
+    friend class LevelSimulation;
+
+    Level::Snapshot level_;
+    CharacterControllerPool character_controllers_;
+    PathCache::Snapshot path_cache_;
+    PathRequestService::Snapshot path_requests_;
+    int64_t ticks_{0};
+    TimerWheel wake_timers_;
+    std::vector<int64_t> wake_ticks_;
+    std::vector<int64_t> next_active_controllers_;
+  };
+
+  /**
+   * @param level The level to simulate.
+   * @param solids All the solids, by index.
+   * @param level_of_detail How finely characters are simulated depending on
+   * their distance to the observers.
+   * @param seed Seed of all the random values drawn in the level.
+   */
+  LevelSimulation(Level& level,
+                  std::unordered_map<int64_t, Solid const> const& solids,
+                  LevelOfDetail const& level_of_detail, uint64_t seed);
+  LevelSimulation(LevelSimulation const& other) = delete;
+  LevelSimulation(LevelSimulation&& other) = delete;
+  LevelSimulation& operator=(LevelSimulation const& other) = delete;
+  LevelSimulation& operator=(LevelSimulation&& other) = delete;
+  /**
+   * @brief Declare that something (e.g. the viewport) looks at the level.
+   *
+   * @param area Area of the level which is looked at, in pixels.
+   * @return int64_t Identifier of the observer.
+   */
+  int64_t addObserver(PositionedRectangle const& area);
+  CharacterControllerPool& characterControllers();
+  ClearanceMap& clearanceMap();
+  FlowFieldCache& flowFields();
+  /**
+   * @brief Returns how many of the next ticks would change nothing: no
+   * controller is due, and no path request is pending.
+   *
+   * They can be skipped (refer to skip()), e.g. while the characters are idle.
+   */
+  int64_t idleTicks() const;
+  /**
+   * @brief Remove a character and its controller from the level.
+   *
+   * Not to be called while the simulation is ticked.
+   */
+  void despawn(Character const& character);
+  /**
+   * @brief Whether the level has at least one observer.
+   */
+  bool isObserved() const;
+  Level& level();
+  /**
+   * @brief Move the area looked at by an observer.
+   *
+   * @param observer Identifier of the observer.
+   * @param position New position of the area, in pixels.
+   */
+  void moveObserver(int64_t observer, Position const& position);
+  PathRequestService& pathRequests();
+  /**
+   * @brief Build ahead what the simulation builds on demand: the path finders
+   * of the solids of its characters, and of the given one.
+   *
+   * Meant to run in the background before the level is observed (e.g. when a
+   * character is about to arrive in it), so that the first ticks do not stall.
+   * Not to be called while the simulation is ticked.
+   *
+   * @param solid Solid of a character about to arrive in the level.
+   */
+  void preload(Solid const& solid);
+  void removeObserver(int64_t observer);
+  /**
+   * @brief Bring the simulation and its level back to a snapshot.
+   *
+   * The observers are left as they are. Not to be called while the simulation
+   * is ticked.
+   *
+   * @param snapshot A snapshot saved from this simulation.
+   */
+  void restore(Snapshot const& snapshot);
+  /**
+   * @brief Save the state of the simulation and of its level: characters,
+   * tiles, controllers, timers, path cache and path requests.
+   *
+   * The flow fields are not saved, they hold nothing that could not be found
+   * again. Saving into the same snapshot again reuses its storage (refer to
+   * CharacterControllerPool::copyFrom()).
+   *
+   * @param snapshot Receives the state, overwritten.
+   */
+  void save(Snapshot& snapshot) const;
+  /**
+   * @brief Advance the simulation by several ticks at once, as if ticked that
+   * many times.
+   *
+   * @param num_ticks Number of ticks, at most idleTicks().
+   */
+  void skip(int64_t num_ticks);
+  /**
+   * @brief Add a character to the level, with its controller.
+   *
+   * The controller is ticked from the next tick on. Not to be called while the
+   * simulation is ticked.
+   *
+   * @param character_template Template of the character.
+   * @param position Initial position of the character.
+   * @return Character The new character.
+   */
+  Character spawn(CharacterTemplate const& character_template,
+                  Position const& position);
+  /**
+   * @brief Advance the simulation by one tick.
+   *
+   * @param event_handler Source of the user inputs.
+   * @param navigator Navigator resolving the moves.
+   * @param path_budget_expansions Number of nodes the path requests may
+   * expand (refer to PathRequestService::process()).
+   */
+  void tick(EventHandler const& event_handler, Navigator const& navigator,
+            int64_t path_budget_expansions);
+  /**
+   * @brief Returns the number of times the simulation was ticked.
+   */
+  int64_t ticks() const;
+  /**
+   * @brief Make a sleeping controller active again from the next tick.
+   *
+   * @param controller_index Index of the controller in characterControllers().
+   */
+  void wake(int64_t controller_index);
+
+ private:
+  Level& level_;
+  TileSolids const tile_solids_;
+  ClearanceMap clearance_map_;
+  FlowFieldCache flow_fields_;
+  PathCache path_cache_;
+  PathRequestService path_requests_;
+  MoveBatch move_batch_;
+  CharacterControllerPool character_controllers_;
+  LevelOfDetail const level_of_detail_;
+  uint64_t const seed_;
+  std::unordered_map<int64_t, PositionedRectangle> observers_;
+  int64_t next_observer_{0};
+  int64_t ticks_{0};
+  // Controllers sleeping until a given tick.
+  TimerWheel wake_timers_;
+  /* The tick at which each controller is expected next, or kWaitingForEvent.
+   * A timer whose tick does not match is stale (the controller was woken up
+   * before) and is ignored. */
+  std::vector<int64_t> wake_ticks_;
+  // Controllers to tick at the current tick, and at the next one.
+  std::vector<int64_t> active_controllers_;
+  std::vector<int64_t> next_active_controllers_;
+  // Tiles which differ after a restore, kept to reuse its storage.
+  std::vector<TilePosition> changed_tiles_;
+  static int64_t constexpr kWaitingForEvent{-1};
+
+  /**
+   * @brief Create the controller of a character and tick it at the next tick.
+   */
+  void activate(Character const& character);
+  /**
+   * @brief Returns the distance from a position to the closest observed area,
+   * in pixels.
+   */
+  int64_t distanceToObservers(Position const& position) const;
+  void schedule(int64_t controller_index, int64_t next_tick);
+  /**
+   * @brief Tick the given active controllers, all of the same type.
+   *
+   * @param controllers All the controllers of the type.
+   * @param first First of the indices of the controllers to tick.
+   * @param last Past the last of the indices of the controllers to tick.
+   * @param context What the controllers are given at this tick.
+   */
+  template <typename Controller>
+  void tickControllers(std::vector<std::optional<Controller>>& controllers,
+                       std::vector<int64_t>::const_iterator first,
+                       std::vector<int64_t>::const_iterator last,
+                       TickContext const& context);
+  static int64_t constexpr kFlowFieldCacheCapacity{16};
+  static int64_t constexpr kPathCacheCapacity{1024};
+};
+
+#endif
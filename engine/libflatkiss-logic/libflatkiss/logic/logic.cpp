@@ -17,19 +17,184 @@
  * Refer to 'COPYING.txt' for the full notice.
  */
 
+#include <algorithm>
+#include <chrono>
 #include <libflatkiss/logic/logic.hpp>
+#include <limits>
 
-using std::move;
-using std::unique_ptr;
+using std::make_unique;
+using std::min;
+using std::numeric_limits;
+using std::chrono::duration;
+using std::chrono::steady_clock;
+using std::unordered_map;
 using std::vector;
 
-Logic::Logic(
-    std::vector<unique_ptr<CharacterController>>&& character_controllers,
-    Navigator const& navigator)
-    : character_controllers_{move(character_controllers)}, navigator_{navigator} {}
+Logic::Logic(vector<Level>& levels,
+             unordered_map<int64_t, Solid const> const& solids,
+             int64_t path_budget_expansions, int64_t dormant_tick_interval,
+             LevelOfDetail const& level_of_detail, uint64_t seed,
+             JobSystem& job_system)
+    : navigator_{solids},
+      path_budget_expansions_{path_budget_expansions},
+      dormant_tick_interval_{dormant_tick_interval},
+      job_system_{job_system},
+      preloads_(levels.size()),
+      preloaded_(levels.size(), false) {
+  /* The simulations are set up in parallel (e.g. their clearance maps). Each
+   * level draws from its own seed. */
+  simulations_.resize(levels.size());
+  job_system_.parallelFor(
+      0, static_cast<int64_t>(levels.size()), 1,
+      [this, &levels, &solids, &level_of_detail, seed](int64_t first,
+                                                       int64_t last) {
+        for (int64_t i{first}; i < last; i++) {
+          simulations_[i] = make_unique<LevelSimulation>(
+              levels[i], solids, level_of_detail, RandomStream::mix(seed, i));
+        }
+      });
+}
+
+Logic::~Logic() {
+  // The preloads still running use the simulations.
+  for (JobGroup& preload : preloads_) {
+    try {
+      job_system_.wait(preload);
+    } catch (...) {
+      // The simulation is destroyed anyway.
+    }
+  }
+}
+
+double Logic::fastForward(int64_t first_tick, int64_t num_ticks) {
+  EventHandler const event_handler;
+  auto const start{steady_clock::now()};
+
+  int64_t const end_tick{first_tick + num_ticks};
+  int64_t tick{first_tick};
+  while (tick < end_tick) {
+    int64_t num_idle_ticks{end_tick - tick};
+    for (auto const& simulation : simulations_) {
+      num_idle_ticks = min(num_idle_ticks, idleTicks(*simulation, tick));
+    }
+    if (num_idle_ticks == 0) {
+      this->tick(tick, event_handler);
+      tick++;
+      continue;
+    }
+    for (auto& simulation : simulations_) {
+      simulation->skip(numDueTicks(*simulation, tick, tick + num_idle_ticks));
+    }
+    tick += num_idle_ticks;
+  }
+
+  duration<double> const elapsed{steady_clock::now() - start};
+  return static_cast<double>(num_ticks) / elapsed.count();
+}
 
-vector<unique_ptr<CharacterController>>& Logic::characterControllers() {
-  return character_controllers_;
+int64_t Logic::floorDiv(int64_t dividend, int64_t divisor) {
+  int64_t const quotient{dividend / divisor};
+  return (dividend % divisor != 0 && (dividend < 0) != (divisor < 0))
+             ? quotient - 1
+             : quotient;
+}
+
+int64_t Logic::idleTicks(LevelSimulation const& simulation,
+                         int64_t tick) const {
+  if (simulation.isObserved()) {
+    return simulation.idleTicks();
+  }
+  if (dormant_tick_interval_ == 0) {
+    return numeric_limits<int64_t>::max();
+  }
+  // Up to the tick at which the simulation is due once more than it can skip.
+  int64_t const first_due_tick{
+      (floorDiv(tick - 1, dormant_tick_interval_) + 1) *
+      dormant_tick_interval_};
+  return first_due_tick + simulation.idleTicks() * dormant_tick_interval_ -
+         tick;
+}
+
+bool Logic::isDue(LevelSimulation const& simulation, int64_t tick) const {
+  return simulation.isObserved() ||
+         (dormant_tick_interval_ > 0 && tick % dormant_tick_interval_ == 0);
 }
 
 Navigator const& Logic::navigator() const { return navigator_; }
+
+int64_t Logic::numDueTicks(LevelSimulation const& simulation, int64_t first,
+                           int64_t last) const {
+  if (simulation.isObserved()) {
+    return last - first;
+  }
+  if (dormant_tick_interval_ == 0) {
+    return 0;
+  }
+  /* The multiples of the interval in the range. Rounding down, so that tick 0
+   * (which is due) is counted when the range starts at it. */
+  return floorDiv(last - 1, dormant_tick_interval_) -
+         floorDiv(first - 1, dormant_tick_interval_);
+}
+
+void Logic::preload(int64_t level_index, Solid const& solid) {
+  if (preloaded_[level_index] || job_system_.workerCount() == 0) {
+    return;
+  }
+  preloaded_[level_index] = true;
+  LevelSimulation* simulation{simulations_[level_index].get()};
+  job_system_.runInBackground(preloads_[level_index], [simulation, &solid]() {
+    simulation->preload(solid);
+  });
+}
+
+LevelSimulation& Logic::simulation(int64_t level_index) {
+  return *simulations_[level_index];
+}
+
+uint64_t Logic::stateHash() const {
+  uint64_t state_hash{0};
+  for (auto const& simulation : simulations_) {
+    state_hash = RandomStream::mix(state_hash, simulation->level().stateHash());
+  }
+  return state_hash;
+}
+
+void Logic::tick(int64_t tick, EventHandler const& event_handler) {
+  due_simulations_.clear();
+  for (int64_t i{0}; i < simulations_.size(); i++) {
+    if (isDue(*simulations_[i], tick)) {
+      // Only once its preload is over, if any.
+      job_system_.wait(preloads_[i]);
+      due_simulations_.push_back(simulations_[i].get());
+    }
+  }
+
+  // The simulations share nothing they modify.
+  JobGroup simulations;
+  for (LevelSimulation* simulation : due_simulations_) {
+    job_system_.run(simulations, [this, simulation, &event_handler]() {
+      simulation->tick(event_handler, navigator_,
+                       path_budget_expansions_);
+    });
+  }
+  // Rethrows what a simulation may have thrown.
+  job_system_.wait(simulations);
+}
+
+Character Logic::warp(int64_t level_index, Character const& character,
+                      Warp const& warp) {
+  int64_t const destination_index{warp.destinationLevelIndex()};
+  preload(destination_index, character.solid());
+  job_system_.wait(preloads_[destination_index]);
+
+  LevelSimulation& source{*simulations_[level_index]};
+  LevelSimulation& destination{*simulations_[destination_index]};
+  CharacterTemplate const& character_template{
+      source.level().characterTemplate(character.index())};
+  source.despawn(character);
+  Spriteset const& spriteset{destination.level().spriteset()};
+  return destination.spawn(
+      character_template,
+      Position{warp.destination().x() * spriteset.spritesWidth(),
+               warp.destination().y() * spriteset.spritesHeight()});
+}
@@ -20,25 +20,160 @@
 #ifndef LIBFLATKISS_LOGIC_LOGIC_HPP_INCLUDED
 #define LIBFLATKISS_LOGIC_LOGIC_HPP_INCLUDED
 
+#include <libflatkiss/job/job.hpp>
+#include <libflatkiss/logic/bytecode_character_controller.hpp>
 #include <libflatkiss/logic/character_controller.hpp>
 #include <libflatkiss/logic/character_controller_loader.hpp>
+#include <libflatkiss/logic/character_scripts.hpp>
+#include <libflatkiss/logic/clearance_map.hpp>
+#include <libflatkiss/logic/flow_field.hpp>
+#include <libflatkiss/logic/flow_field_cache.hpp>
+#include <libflatkiss/logic/hierarchical_path_finder.hpp>
 #include <libflatkiss/logic/keyboard_character_controller.hpp>
+#include <libflatkiss/logic/level_of_detail.hpp>
+#include <libflatkiss/logic/level_simulation.hpp>
+#include <libflatkiss/logic/move_batch.hpp>
 #include <libflatkiss/logic/navigator.hpp>
+#include <libflatkiss/logic/path_cache.hpp>
+#include <libflatkiss/logic/path_finder.hpp>
+#include <libflatkiss/logic/path_request_service.hpp>
+#include <libflatkiss/logic/random_stream.hpp>
+#include <libflatkiss/logic/script.hpp>
+#include <libflatkiss/logic/script_frame_allocator.hpp>
+#include <libflatkiss/logic/scripted_character_controller.hpp>
 #include <libflatkiss/logic/stroll_character_controller.hpp>
 #include <memory>
+#include <unordered_map>
 #include <vector>
 
+/**
+ * @brief Runs the simulations of all the levels.
+ *
+ * There is one simulation per level. Levels with observers are ticked at each
+ * tick. The others are dormant: they are ticked once every few ticks, or not
+ * at all. When several simulations are due at the same tick, they run on
+ * separate threads.
+ *
+ * A level can be preloaded in the background before a character warps into it
+ * (refer to LevelSimulation::preload()), so that switching to it costs nothing
+ * more than moving the character.
+ */
 class Logic {
  public:
-  Logic(std::vector<std::unique_ptr<CharacterController>>&&
-            character_controllers,
-        Navigator const& navigator);
+  /**
+   * @param levels The levels, one simulation is created for each of them.
+   * @param solids All the solids, by index.
+   * @param path_budget_expansions Number of nodes the path requests of each
+   * level may expand at each tick (refer to PathRequestService::process()).
+   * @param dormant_tick_interval Levels without observers are ticked once every
+   * that many ticks, or never if zero.
+   * @param level_of_detail How finely characters are simulated depending on
+   * their distance to the observers.
+   * @param seed Seed of all the random values drawn in the world. The same
+   * seed and the same inputs always lead to the same world.
+   * @param job_system Job system running the simulations of the levels.
+   */
+  Logic(std::vector<Level>& levels,
+        std::unordered_map<int64_t, Solid const> const& solids,
+        int64_t path_budget_expansions, int64_t dormant_tick_interval,
+        LevelOfDetail const& level_of_detail, uint64_t seed,
+        JobSystem& job_system);
+  Logic(Logic const& other) = delete;
+  Logic(Logic&& other) = delete;
+  Logic& operator=(Logic const& other) = delete;
+  Logic& operator=(Logic&& other) = delete;
+  ~Logic();
+  /**
+   * @brief Run many ticks as fast as possible, without inputs.
+   *
+   * The result is the same as calling tick() for each of them with no key
+   * pressed, but the ticks at which nothing happens in any level (e.g. while
+   * all the characters are idle) are skipped at once rather than run.
+   *
+   * @param first_tick The first tick to run.
+   * @param num_ticks Number of ticks to run.
+   * @return double The number of ticks run per second.
+   */
+  double fastForward(int64_t first_tick, int64_t num_ticks);
   Navigator const& navigator() const;  // FIXME: Delete.
-  std::vector<std::unique_ptr<CharacterController>>& characterControllers();
+  /**
+   * @brief Start preloading a level on the job system, unless it was preloaded
+   * already.
+   *
+   * The preload runs in the background on a worker (refer to
+   * JobSystem::runInBackground()), so it needs at least one: without workers,
+   * nothing is preloaded and the level builds what it needs on demand. The
+   * simulation of the level is not ticked until the preload is over.
+   *
+   * @param level_index Index of the level.
+   * @param solid Solid of the character about to arrive in the level, must
+   * outlive the preload.
+   */
+  void preload(int64_t level_index, Solid const& solid);
+  /**
+   * @brief Returns the simulation of the level at the given index.
+   */
+  LevelSimulation& simulation(int64_t level_index);
+  /**
+   * @brief Returns a hash of the state of all the levels (refer to
+   * Level::stateHash()).
+   */
+  uint64_t stateHash() const;
+  /**
+   * @brief Advance the simulations which are due by one tick.
+   *
+   * @param tick The current tick.
+   * @param event_handler Source of the user inputs.
+   */
+  void tick(int64_t tick, EventHandler const& event_handler);
+  /**
+   * @brief Move a character through a warp, to the level it leads to.
+   *
+   * Waits for the preload of the destination, running it now if it was not
+   * started. Not to be called while the simulations are ticked.
+   *
+   * @param level_index Index of the level of the character.
+   * @param character The character, despawned from its level.
+   * @param warp The warp taken, in the level of the character.
+   * @return Character The character spawned in the destination level.
+   */
+  Character warp(int64_t level_index, Character const& character,
+                 Warp const& warp);
 
  private:
-  std::vector<std::unique_ptr<CharacterController>> character_controllers_;
   Navigator const navigator_;
+  int64_t const path_budget_expansions_;
+  int64_t const dormant_tick_interval_;
+  JobSystem& job_system_;
+  std::vector<std::unique_ptr<LevelSimulation>> simulations_;
+  // One group per level, for its preload.
+  std::vector<JobGroup> preloads_;
+  std::vector<bool> preloaded_;
+  // Simulations due at the current tick.
+  std::vector<LevelSimulation*> due_simulations_;
+
+  /**
+   * @brief Division rounding towards negative infinity, unlike `/` which
+   * rounds towards zero.
+   */
+  static int64_t floorDiv(int64_t dividend, int64_t divisor);
+  /**
+   * @brief Whether a simulation is ticked at the given tick.
+   */
+  bool isDue(LevelSimulation const& simulation, int64_t tick) const;
+  /**
+   * @brief Returns how many ticks of the world, from the given one, would
+   * change nothing in a simulation.
+   */
+  int64_t idleTicks(LevelSimulation const& simulation, int64_t tick) const;
+  /**
+   * @brief Returns how many times a simulation is due in a range of ticks.
+   *
+   * @param first First tick of the range.
+   * @param last Past the last tick of the range.
+   */
+  int64_t numDueTicks(LevelSimulation const& simulation, int64_t first,
+                      int64_t last) const;
 };
 
 #endif
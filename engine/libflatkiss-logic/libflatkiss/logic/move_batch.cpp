@@ -0,0 +1,93 @@
+/*
+ * Copyright (C) 2021-2023 Jean-Marie BARAN (jeanmarie.baran@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Refer to 'COPYING.txt' for the full notice.
+ */
+
+#include <algorithm>
+#include <cstdlib>
+#include <libflatkiss/logic/character_controller.hpp>
+#include <libflatkiss/logic/move_batch.hpp>
+
+using std::abs;
+using std::max;
+
+void MoveBatch::coarse(bool coarse) { coarse_ = coarse; }
+
+void MoveBatch::submit(CharacterController& requester, Solid const& solid,
+                       Position const& position,
+                       Vector const& desired_displacement,
+                       int64_t sidestep_distance, int64_t sidestep_speed,
+                       bool allow_slide) {
+  if (coarse_) {
+    coarse_intents_.push_back({solid, position, desired_displacement,
+                               sidestep_distance, sidestep_speed, allow_slide});
+    coarse_requesters_.push_back(&requester);
+  } else {
+    intents_.push_back({solid, position, desired_displacement,
+                        sidestep_distance, sidestep_speed, allow_slide});
+    requesters_.push_back(&requester);
+  }
+}
+
+void MoveBatch::resolve(Navigator const& navigator,
+                        TileSolids const& tile_solids,
+                        ClearanceMap const& clearance_map) {
+  navigator.moveAll(intents_, tile_solids, results_);
+  for (int64_t i{0}; i < results_.size(); i++) {
+    requesters_[i]->onMoved(intents_[i], results_[i]);
+  }
+  intents_.clear();
+  requesters_.clear();
+  results_.clear();
+
+  for (int64_t i{0}; i < coarse_intents_.size(); i++) {
+    Navigator::MoveIntent const& intent{coarse_intents_[i]};
+    coarse_requesters_[i]->onMoved(
+        intent,
+        Navigator::MoveResult{false, resolveCoarse(intent, clearance_map)});
+  }
+  coarse_intents_.clear();
+  coarse_requesters_.clear();
+}
+
+// NOLINTBEGIN(readability-identifier-length)
+Position MoveBatch::resolveCoarse(Navigator::MoveIntent const& intent,
+                                  ClearanceMap const& clearance_map) {
+  Vector const& displacement{intent.desired_displacement};
+  int64_t const steps{max((abs(displacement.dx()) + clearance_map.cellWidth() -
+                           1) / clearance_map.cellWidth(),
+                          (abs(displacement.dy()) + clearance_map.cellHeight() -
+                           1) / clearance_map.cellHeight())};
+
+  /* Steps are at most one cell long, so that the character cannot go through
+   * an obstacle. */
+  int64_t dx{0};
+  int64_t dy{0};
+  for (int64_t step{1}; step <= steps; step++) {
+    int64_t const next_dx{displacement.dx() * step / steps};
+    int64_t const next_dy{displacement.dy() * step / steps};
+    if (!clearance_map.fits(intent.solid.boundingBox(),
+                            intent.position + Vector{next_dx, next_dy})) {
+      break;
+    }
+    dx = next_dx;
+    dy = next_dy;
+  }
+
+  return intent.position + Vector{dx, dy};
+}
+// NOLINTEND(readability-identifier-length)
@@ -0,0 +1,83 @@
+/*
+ * Copyright (C) 2021-2023 Jean-Marie BARAN (jeanmarie.baran@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Refer to 'COPYING.txt' for the full notice.
+ */
+
+#ifndef LIBFLATKISS_LOGIC_MOVE_BATCH_HPP_INCLUDED
+#define LIBFLATKISS_LOGIC_MOVE_BATCH_HPP_INCLUDED
+
+#include <libflatkiss/logic/clearance_map.hpp>
+#include <libflatkiss/logic/navigator.hpp>
+#include <libflatkiss/model/model.hpp>
+#include <vector>
+
+// Forward declaration to break the cycle MoveBatch / CharacterController.
+class CharacterController;
+
+/**
+ * @brief Collects the moves the controllers want to make during a tick.
+ *
+ * Instead of moving their character right away, the controllers submit an
+ * intent. Once all the controllers have been ticked, the batch is resolved by
+ * the navigator in one go and each controller is notified of the outcome of its
+ * move through CharacterController::onMoved().
+ */
+class MoveBatch {
+ public:
+  /**
+   * @brief Whether the moves submitted from now on are coarse.
+   */
+  void coarse(bool coarse);
+  /**
+   * @brief Register a move to be resolved with the rest of the batch.
+   *
+   * The parameters are the same as Navigator::moveBy().
+   *
+   * @param requester Controller to notify once the move is resolved.
+   */
+  void submit(CharacterController& requester, Solid const& solid,
+              Position const& position, Vector const& desired_displacement,
+              int64_t sidestep_distance, int64_t sidestep_speed,
+              bool allow_slide);
+  /**
+   * @brief Resolve all the submitted moves, notify their requesters and empty
+   * the batch.
+   *
+   * @param navigator Navigator resolving the moves.
+   * @param tile_solids Solids of the tiles of the level in which all the
+   * moves happen.
+   * @param clearance_map Clearance map of the level, for the coarse moves.
+   */
+  void resolve(Navigator const& navigator, TileSolids const& tile_solids,
+               ClearanceMap const& clearance_map);
+
+ private:
+  bool coarse_{false};
+  std::vector<Navigator::MoveIntent> intents_;
+  std::vector<CharacterController*> requesters_;
+  std::vector<Navigator::MoveResult> results_;
+  std::vector<Navigator::MoveIntent> coarse_intents_;
+  std::vector<CharacterController*> coarse_requesters_;
+
+  /**
+   * @brief Returns where a coarse move leads.
+   */
+  static Position resolveCoarse(Navigator::MoveIntent const& intent,
+                                ClearanceMap const& clearance_map);
+};
+
+#endif
@@ -27,6 +27,7 @@ using std::array;
 using std::logic_error;
 using std::max;
 using std::unordered_map;
+using std::vector;
 
 Navigator::Navigator(unordered_map<int64_t, Solid const> const& solids)
     : solids_{solids} {}
@@ -44,54 +45,21 @@ int64_t Navigator::clampToBounds(int64_t object_position, int64_t object_size,
   return object_position;
 }
 
-Position Navigator::clampToBounds(PositionedSolid const& positioned_solid,
+Position Navigator::clampToBounds(Solid const& solid, Position const& position,
                                   Level const& level) {
+  PositionedRectangle const& bounding_box{solid.boundingBox()};
   return Position{
-      clampToBounds(positioned_solid.absoluteBoundingBox().x(),
-                    positioned_solid.boundingBox().width(),
+      clampToBounds(position.x() + bounding_box.x(), bounding_box.width(),
                     level.widthInTiles() * level.spriteset().spritesWidth()) -
-          positioned_solid.boundingBox().x(),
-      clampToBounds(positioned_solid.absoluteBoundingBox().y(),
-                    positioned_solid.boundingBox().height(),
+          bounding_box.x(),
+      clampToBounds(position.y() + bounding_box.y(), bounding_box.height(),
                     level.heightInTiles() * level.spriteset().spritesHeight()) -
-          positioned_solid.boundingBox().y()};
-}
-
-bool Navigator::collidesWithTiles(PositionedSolid const& positioned_solid,
-                                  Level const& level) const {
-  /* Disabling lint for short variables names because they are useful for
-   * math-related things (x, y, ...). */
-  // NOLINTBEGIN(readability-identifier-length)
-  for (int64_t y(positioned_solid.absoluteBoundingBox().y() /
-                 level.spriteset().spritesHeight());
-       y <= (positioned_solid.absoluteBoundingBox().y() +
-             positioned_solid.boundingBox().height() - 1) /
-                level.spriteset().spritesHeight();
-       y++) {
-    for (int64_t x(positioned_solid.absoluteBoundingBox().x() /
-                   level.spriteset().spritesWidth());
-         x <= (positioned_solid.absoluteBoundingBox().x() +
-               positioned_solid.boundingBox().width() - 1) /
-                  level.spriteset().spritesWidth();
-         x++) {
-      uint16_t tile_index(level.tileIndex(x, y));
-      if (solidCollidesWithTileAtPosition(
-              positioned_solid, tile_index,
-              Position{x * level.spriteset().spritesWidth(),
-                       y * level.spriteset().spritesHeight()},
-              level)) {
-        return true;
-      }
-    }
-  }
-  // NOLINTEND(readability-identifier-length)
-
-  return false;
+          bounding_box.y()};
 }
 
 Position Navigator::findNearestPositionToDestination(
-    PositionedSolid const& positioned_solid, Position const& destination,
-    Level const& level) const {
+    Solid const& solid, Position const& position, Position const& destination,
+    TileSolids const& tile_solids) {
   /* Decompose the displacement in steps. Each step is a point. Because the
    * components of the displacement can be different, first find the greatest of
    * the two. This is the number of steps. Then move step by step (point by
@@ -100,18 +68,17 @@ Position Navigator::findNearestPositionToDestination(
    * not collide. Note that this implementation find the nearest position on the
    * line between the source and the destination. It will not return the actual
    * nearest position when it is outside of that line. */
-  Vector displacement{destination - positioned_solid.position()};
+  Vector displacement{destination - position};
   int64_t max_displacement{max(abs(displacement.dx()), abs(displacement.dy()))};
   for (int64_t step{1}; step <= max_displacement; step++) {
     Vector partial_displacement{(step * displacement.dx()) / max_displacement,
                                 (step * displacement.dy()) / max_displacement};
-    if (collidesWithTiles(positioned_solid + partial_displacement, level)) {
+    if (tile_solids.collide(solid, position + partial_displacement)) {
       /* Return the last step for which the position does not collide (for the
        * first step this is the original position). */
-      return Position{positioned_solid.x() +
-                          ((step - 1) * displacement.dx()) / max_displacement,
-                      positioned_solid.y() +
-                          ((step - 1) * displacement.dy()) / max_displacement};
+      return Position{
+          position.x() + ((step - 1) * displacement.dx()) / max_displacement,
+          position.y() + ((step - 1) * displacement.dy()) / max_displacement};
     }
   }
 
@@ -124,52 +91,87 @@ Navigator::MoveResult Navigator::moveBy(PositionedSolid const& positioned_solid,
                                         int64_t sidestep_distance,
                                         int64_t sidestep_speed,
                                         bool allow_slide) const {
+  return moveBy(positioned_solid.solid(), positioned_solid.position(),
+                desired_displacement, TileSolids{level, solids_},
+                sidestep_distance, sidestep_speed, allow_slide);
+}
+
+Navigator::MoveResult Navigator::moveBy(Solid const& solid,
+                                        Position const& position,
+                                        Vector const& desired_displacement,
+                                        TileSolids const& tile_solids,
+                                        int64_t sidestep_distance,
+                                        int64_t sidestep_speed,
+                                        bool allow_slide) {
   /* First collide with the bounds of the level. Compute the resulting
    * (potential) destination. */
-  Position destination{
-      clampToBounds(positioned_solid + desired_displacement, level)};
+  Position destination{clampToBounds(solid, position + desired_displacement,
+                                     tile_solids.level())};
 
   /* Secondly, if the destination is the same as the current position, nothing
    * to do. */
-  if (positioned_solid.position() == destination) {
-    return {false, positioned_solid.position()};
+  if (position == destination) {
+    return {false, position};
   }
 
   // If there is a collision with a tile...
-  if (collidesWithTiles(PositionedSolid{destination, positioned_solid.solid()},
-                        level)) {
+  if (tile_solids.collide(solid, destination)) {
     // Either stick to the tile.
-    Position nearest_position{
-        findNearestPositionToDestination(positioned_solid, destination, level)};
-    if (positioned_solid.position() != nearest_position) {
+    Position nearest_position{findNearestPositionToDestination(
+        solid, position, destination, tile_solids)};
+    if (position != nearest_position) {
       return {false, nearest_position};
     }
 
     // Or slide along it if allowed.
     if (allow_slide) {
-      Position slided{slide(positioned_solid, desired_displacement, level)};
-      if (slided != positioned_solid.position()) {
+      Position slided{
+          slide(solid, position, desired_displacement, tile_solids)};
+      if (slided != position) {
         return {false, slided};
       }
     }
 
     // Or side-step for bypassing it if allowed.
     if (sidestep_distance > 0) {
-      Position side_stepped{sideStep(positioned_solid, desired_displacement,
-                                     level, sidestep_distance, sidestep_speed)};
-      if (side_stepped != positioned_solid.position()) {
+      Position side_stepped{sideStep(solid, position, desired_displacement,
+                                     tile_solids, sidestep_distance,
+                                     sidestep_speed)};
+      if (side_stepped != position) {
         return {true, side_stepped};
       }
     }
 
     // It is not possible to get to a nearer position.
-    return {false, positioned_solid.position()};
+    return {false, position};
   }
 
   // But if there is no collision, just go to the final destination.
   return {false, destination};
 }
 
+void Navigator::moveAll(vector<MoveIntent> const& intents,
+                        TileSolids const& tile_solids,
+                        vector<MoveResult>& results) const {
+  results.clear();
+  for (MoveIntent const& intent : intents) {
+    // Nothing can stand in the way of a move which sweeps no solid tile.
+    Position const destination{clampToBounds(
+        intent.solid, intent.position + intent.desired_displacement,
+        tile_solids.level())};
+    if (!tile_solids.hasSolid(tile_solids.tileRange(
+            intent.solid, intent.position, destination))) {
+      results.push_back({false, destination});
+      continue;
+    }
+
+    results.push_back(moveBy(intent.solid, intent.position,
+                             intent.desired_displacement, tile_solids,
+                             intent.sidestep_distance, intent.sidestep_speed,
+                             intent.allow_slide));
+  }
+}
+
 /* Side-stepping works by applying the same desired displacement but from a
  * different position. The position is chosen orthogonally to the desired
  * displacement, and according to the side-step lookup distance. This position
@@ -179,121 +181,100 @@ Navigator::MoveResult Navigator::moveBy(PositionedSolid const& positioned_solid,
  * is different than the initial parallax position), then the solid is moved
  * toward the initial parallax position. Note that side-stepping is only
  * possible when moving along an axis (not diagonally). */
-Position Navigator::sideStep(PositionedSolid const& positioned_solid,
+Position Navigator::sideStep(Solid const& solid, Position const& position,
                              Vector const& desired_displacement,
-                             Level const& level, int64_t sidestep_distance,
-                             int64_t sidestep_speed) const {
+                             TileSolids const& tile_solids,
+                             int64_t sidestep_distance,
+                             int64_t sidestep_speed) {
   if (desired_displacement.dx() == 0) {
-    Position side_stepped{sideStepX(positioned_solid, desired_displacement,
-                                    level, sidestep_distance, sidestep_speed)};
-    if (side_stepped != positioned_solid.position()) {
+    Position side_stepped{sideStepX(solid, position, desired_displacement,
+                                    tile_solids, sidestep_distance,
+                                    sidestep_speed)};
+    if (side_stepped != position) {
       return side_stepped;
     }
   }
 
   if (desired_displacement.dy() == 0) {
-    Position side_stepped{sideStepY(positioned_solid, desired_displacement,
-                                    level, sidestep_distance, sidestep_speed)};
-    if (side_stepped != positioned_solid.position()) {
+    Position side_stepped{sideStepY(solid, position, desired_displacement,
+                                    tile_solids, sidestep_distance,
+                                    sidestep_speed)};
+    if (side_stepped != position) {
       return side_stepped;
     }
   }
 
-  return positioned_solid.position();
+  return position;
 }
 
-Position Navigator::sideStepX(PositionedSolid const& positioned_solid,
+Position Navigator::sideStepX(Solid const& solid, Position const& position,
                               Vector const& desired_displacement,
-                              Level const& level, int64_t sidestep_distance,
-                              int64_t sidestep_speed) const {
+                              TileSolids const& tile_solids,
+                              int64_t sidestep_distance,
+                              int64_t sidestep_speed) {
   for (int64_t direction : array{-1, 1}) {
     Position parallax{clampToBounds(
-        positioned_solid + Vector{sidestep_distance * direction, 0}, level)};
-    if (!collidesWithTiles(PositionedSolid{parallax, positioned_solid.solid()},
-                           level)) {
-      Position parallax_final{
-          moveBy(PositionedSolid{parallax, positioned_solid.solid()},
-                 desired_displacement, level, 0, 0, false)
-              .position};
+        solid, position + Vector{sidestep_distance * direction, 0},
+        tile_solids.level())};
+    if (!tile_solids.collide(solid, parallax)) {
+      Position parallax_final{moveBy(solid, parallax, desired_displacement,
+                                     tile_solids, 0, 0, false)
+                                  .position};
       if (parallax_final != parallax) {
-        Position side_stepped{positioned_solid.x() + sidestep_speed * direction,
-                              positioned_solid.y()};
-        if (!collidesWithTiles(
-                PositionedSolid{side_stepped, positioned_solid.solid()},
-                level)) {
+        Position side_stepped{position.x() + sidestep_speed * direction,
+                              position.y()};
+        if (!tile_solids.collide(solid, side_stepped)) {
           return side_stepped;
         }
       }
     }
   }
 
-  return positioned_solid.position();
+  return position;
 }
 
-Position Navigator::sideStepY(PositionedSolid const& positioned_solid,
+Position Navigator::sideStepY(Solid const& solid, Position const& position,
                               Vector const& desired_displacement,
-                              Level const& level, int64_t sidestep_distance,
-                              int64_t sidestep_speed) const {
+                              TileSolids const& tile_solids,
+                              int64_t sidestep_distance,
+                              int64_t sidestep_speed) {
   for (int64_t direction : array{-1, 1}) {
     Position parallax{clampToBounds(
-        positioned_solid + Vector{0, sidestep_distance * direction}, level)};
-    if (!collidesWithTiles(PositionedSolid{parallax, positioned_solid.solid()},
-                           level)) {
-      Position parallax_final{
-          moveBy(PositionedSolid{parallax, positioned_solid.solid()},
-                 desired_displacement, level, 0, 0, false)
-              .position};
+        solid, position + Vector{0, sidestep_distance * direction},
+        tile_solids.level())};
+    if (!tile_solids.collide(solid, parallax)) {
+      Position parallax_final{moveBy(solid, parallax, desired_displacement,
+                                     tile_solids, 0, 0, false)
+                                  .position};
       if (parallax_final != parallax) {
-        Position side_stepped{
-            positioned_solid.x(),
-            positioned_solid.y() + sidestep_speed * direction};
-        if (!collidesWithTiles(
-                PositionedSolid{side_stepped, positioned_solid.solid()},
-                level)) {
+        Position side_stepped{position.x(),
+                              position.y() + sidestep_speed * direction};
+        if (!tile_solids.collide(solid, side_stepped)) {
           return side_stepped;
         }
       }
     }
   }
 
-  return positioned_solid.position();
+  return position;
 }
 
-Position Navigator::slide(PositionedSolid const& positioned_solid,
+Position Navigator::slide(Solid const& solid, Position const& position,
                           Vector const& desired_displacement,
-                          Level const& level) const {
+                          TileSolids const& tile_solids) {
   for (Vector const& sliding_displacement : array{
            // Try to slide against the obstacle along the X axis.
            Vector{desired_displacement.dx(), 0},
            // Or slide along the Y axis.
            Vector{0, desired_displacement.dy()},
        }) {
-    Position slided{
-        moveBy(positioned_solid, sliding_displacement, level, 0, 0, false)
-            .position};
-    if (slided != positioned_solid.position()) {
+    Position slided{moveBy(solid, position, sliding_displacement, tile_solids,
+                           0, 0, false)
+                        .position};
+    if (slided != position) {
       return slided;
     }
   }
 
-  return positioned_solid.position();
-}
-
-bool Navigator::solidCollidesWithTileAtPosition(
-    PositionedSolid const& positioned_solid, uint16_t tile_index,
-    Position const& position, Level const& level) const {
-  if (level.tileSolidMapper().contains(tile_index)) {
-    return Collider::collide(
-        positioned_solid,
-        solidForTileIndexAtPosition(tile_index, position, level));
-  }
-
-  return false;
-}
-
-PositionedSolid Navigator::solidForTileIndexAtPosition(
-    uint16_t tile_index, Position const& position, Level const& level) const {
-  return PositionedSolid{
-      position,
-      solids_.at(level.tileSolidMapper().solidIndexForTileIndex(tile_index))};
+  return position;
 }
@@ -21,6 +21,7 @@
 #define LIBFLATKISS_LOGIC_NAVIGATOR_HPP_INCLUDED
 
 #include <libflatkiss/logic/collider.hpp>
+#include <libflatkiss/logic/tile_solids.hpp>
 #include <libflatkiss/model/model.hpp>
 #include <vector>
 
@@ -34,6 +35,20 @@ class Navigator {
     Position position;
   };
 
+  /**
+   * @brief A move to be resolved as part of a batch, refer to moveAll().
+   *
+   * The fields match the parameters of moveBy().
+   */
+  struct MoveIntent {
+    Solid const& solid;
+    Position position;
+    Vector desired_displacement;
+    int64_t sidestep_distance;
+    int64_t sidestep_speed;
+    bool allow_slide;
+  };
+
   Navigator(std::unordered_map<int64_t, Solid const> const& solids);
   /**
    * @brief Try to move a solid according to the provided movement.
@@ -64,6 +79,24 @@ class Navigator {
                     Vector const& desired_displacement, Level const& level,
                     int64_t sidestep_distance, int64_t sidestep_speed,
                     bool allow_slide) const;
+  /**
+   * @brief Same as moveBy() but for many solids of the same level at once.
+   *
+   * The solids of the tiles are resolved once for the level, and shared by all
+   * the batches (refer to TileSolids). The tiles swept by each move are worked
+   * out once: when none of them has a solid, the move is not checked any
+   * further. The moves are independent from each other: the solids do not
+   * collide together.
+   *
+   * @param intents The moves to resolve.
+   * @param tile_solids Solids of the tiles of the level in which the solids
+   * are moving.
+   * @param results Where the results are written, in the same order as the
+   * intents. Cleared first, so that the same vector can be reused each tick.
+   */
+  void moveAll(std::vector<MoveIntent> const& intents,
+               TileSolids const& tile_solids,
+               std::vector<MoveResult>& results) const;
 
  private:
   std::unordered_map<int64_t, Solid const> const& solids_;
@@ -81,31 +114,31 @@ class Navigator {
    */
   static int64_t clampToBounds(int64_t object_position, int64_t object_size,
                                int64_t upper_bound);
-  static Position clampToBounds(PositionedSolid const& positioned_solid,
+  static Position clampToBounds(Solid const& solid, Position const& position,
                                 Level const& level);
-  bool collidesWithTiles(PositionedSolid const& positioned_solid,
-                         Level const& level) const;
-  Position findNearestPositionToDestination(
-      PositionedSolid const& positioned_solid, Position const& destination,
-      Level const& level) const;
-  Position sideStep(PositionedSolid const& positioned_solid,
-                    Vector const& desired_displacement, Level const& level,
-                    int64_t sidestep_distance, int64_t sidestep_speed) const;
-  Position sideStepX(PositionedSolid const& positioned_solid,
-                     Vector const& desired_displacement, Level const& level,
-                     int64_t sidestep_distance, int64_t sidestep_speed) const;
-  Position sideStepY(PositionedSolid const& positioned_solid,
-                     Vector const& desired_displacement, Level const& level,
-                     int64_t sidestep_distance, int64_t sidestep_speed) const;
-  Position slide(PositionedSolid const& positioned_solid,
-                 Vector const& desired_displacement, Level const& level) const;
-  bool solidCollidesWithTileAtPosition(PositionedSolid const& positioned_solid,
-                                       uint16_t tile_index,
-                                       Position const& position,
-                                       Level const& level) const;
-  PositionedSolid solidForTileIndexAtPosition(uint16_t tile_index,
-                                              Position const& position,
-                                              Level const& level) const;
+  static Position findNearestPositionToDestination(
+      Solid const& solid, Position const& position,
+      Position const& destination, TileSolids const& tile_solids);
+  static MoveResult moveBy(Solid const& solid, Position const& position,
+                           Vector const& desired_displacement,
+                           TileSolids const& tile_solids,
+                           int64_t sidestep_distance, int64_t sidestep_speed,
+                           bool allow_slide);
+  static Position sideStep(Solid const& solid, Position const& position,
+                           Vector const& desired_displacement,
+                           TileSolids const& tile_solids,
+                           int64_t sidestep_distance, int64_t sidestep_speed);
+  static Position sideStepX(Solid const& solid, Position const& position,
+                            Vector const& desired_displacement,
+                            TileSolids const& tile_solids,
+                            int64_t sidestep_distance, int64_t sidestep_speed);
+  static Position sideStepY(Solid const& solid, Position const& position,
+                            Vector const& desired_displacement,
+                            TileSolids const& tile_solids,
+                            int64_t sidestep_distance, int64_t sidestep_speed);
+  static Position slide(Solid const& solid, Position const& position,
+                        Vector const& desired_displacement,
+                        TileSolids const& tile_solids);
 };
 
 #endif
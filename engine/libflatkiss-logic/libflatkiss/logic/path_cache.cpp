@@ -0,0 +1,130 @@
+/*
+ * Copyright (C) 2021-2023 Jean-Marie BARAN (jeanmarie.baran@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Refer to 'COPYING.txt' for the full notice.
+ */
+
+#include <functional>
+#include <libflatkiss/logic/path_cache.hpp>
+#include <stdexcept>
+
+using std::hash;
+using std::invalid_argument;
+using std::size_t;
+using std::vector;
+
+PathCache::PathCache(int64_t capacity) : capacity_{capacity} {
+  if (capacity_ <= 0) {
+    throw invalid_argument("Capacity of a path cache must be positive");
+  }
+}
+
+bool PathCache::find(int64_t start_cluster, int64_t goal_cluster,
+                     int64_t size_class, vector<TilePosition>& waypoints) {
+  waypoints.clear();
+  lookups_++;
+  auto const found{
+      routes_by_key_.find(Key{start_cluster, goal_cluster, size_class})};
+  if (found == routes_by_key_.end()) {
+    return false;
+  }
+
+  auto const route{found->second};
+  for (auto const& [cluster, cluster_version] : route->cluster_versions) {
+    if (version(cluster) != cluster_version) {
+      routes_by_key_.erase(found);
+      routes_.erase(route);
+      return false;
+    }
+  }
+
+  // Move the route to the front, it is now the most recently used.
+  routes_.splice(routes_.begin(), routes_, route);
+  waypoints = route->waypoints;
+  hits_++;
+  return true;
+}
+
+int64_t PathCache::hits() const { return hits_; }
+
+double PathCache::hitRate() const {
+  return lookups_ == 0 ? 0 : static_cast<double>(hits_) / lookups_;
+}
+
+void PathCache::invalidate(int64_t cluster) {
+  if (cluster >= cluster_versions_.size()) {
+    cluster_versions_.resize(cluster + 1, 0);
+  }
+  cluster_versions_[cluster]++;
+}
+
+int64_t PathCache::lookups() const { return lookups_; }
+
+void PathCache::restore(Snapshot const& snapshot) {
+  routes_ = snapshot.routes_;
+  routes_by_key_.clear();
+  for (auto route{routes_.begin()}; route != routes_.end(); route++) {
+    routes_by_key_.emplace(route->key, route);
+  }
+  cluster_versions_ = snapshot.cluster_versions_;
+  hits_ = snapshot.hits_;
+  lookups_ = snapshot.lookups_;
+}
+
+void PathCache::save(Snapshot& snapshot) const {
+  snapshot.routes_ = routes_;
+  snapshot.cluster_versions_ = cluster_versions_;
+  snapshot.hits_ = hits_;
+  snapshot.lookups_ = lookups_;
+}
+
+void PathCache::store(int64_t start_cluster, int64_t goal_cluster,
+                      int64_t size_class, vector<TilePosition> const& waypoints,
+                      vector<int64_t> const& clusters) {
+  Key const key{start_cluster, goal_cluster, size_class};
+  auto const found{routes_by_key_.find(key)};
+  if (found != routes_by_key_.end()) {
+    routes_.erase(found->second);
+    routes_by_key_.erase(found);
+  } else if (routes_.size() == capacity_) {
+    routes_by_key_.erase(routes_.back().key);
+    routes_.pop_back();
+  }
+
+  routes_.push_front(Route{key, waypoints, {}});
+  for (int64_t cluster : clusters) {
+    routes_.front().cluster_versions.emplace_back(cluster, version(cluster));
+  }
+  routes_by_key_.emplace(key, routes_.begin());
+}
+
+uint64_t PathCache::version(int64_t cluster) const {
+  return cluster < cluster_versions_.size() ? cluster_versions_[cluster] : 0;
+}
+
+bool PathCache::Key::operator==(Key const& other) const {
+  return start_cluster == other.start_cluster &&
+         goal_cluster == other.goal_cluster && size_class == other.size_class;
+}
+
+size_t PathCache::KeyHash::operator()(Key const& key) const {
+  size_t seed{hash<int64_t>{}(key.start_cluster)};
+  seed ^= hash<int64_t>{}(key.goal_cluster) + 0x9e3779b9 + (seed << 6) +
+          (seed >> 2);
+  seed ^= hash<int64_t>{}(key.size_class) + 0x9e3779b9 + (seed << 6) +
+          (seed >> 2);
+  return seed;
+}
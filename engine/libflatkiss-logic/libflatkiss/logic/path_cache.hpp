@@ -0,0 +1,146 @@
+/*
+ * Copyright (C) 2021-2023 Jean-Marie BARAN (jeanmarie.baran@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Refer to 'COPYING.txt' for the full notice.
+ */
+
+#ifndef LIBFLATKISS_LOGIC_PATH_CACHE_HPP_INCLUDED
+#define LIBFLATKISS_LOGIC_PATH_CACHE_HPP_INCLUDED
+
+#include <cstddef>
+#include <libflatkiss/model/model.hpp>
+#include <list>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Routes between clusters of a level, shared by all the characters.
+ *
+ * A route is the list of the waypoints (entrances between clusters, refer to
+ * HierarchicalPathFinder) leading from a cluster to another, for a given class
+ * of size of characters. Characters going between the same regions of the
+ * level reuse the same route, so the cost of path finding depends on the
+ * number of distinct routes rather than on the number of characters.
+ *
+ * The cache is bounded: when it is full, the least recently used route is
+ * dropped. Each cluster has a version, bumped when the cluster changes. A
+ * route remembers the versions of the clusters it goes through and is dropped
+ * when looked up if one of them changed since.
+ *
+ * Which routes are cached changes the waypoints a search returns, so the cache
+ * is part of the snapshots of a level simulation: a rewound simulation then
+ * finds the same paths again.
+ */
+class PathCache {
+ private:
+  struct Key {
+    int64_t start_cluster;
+    int64_t goal_cluster;
+    int64_t size_class;
+
+    bool operator==(Key const& other) const;
+  };
+
+  struct KeyHash {
+    std::size_t operator()(Key const& key) const;
+  };
+
+  struct Route {
+    Key key;
+    std::vector<TilePosition> waypoints;
+    // Clusters the route goes through, with their versions when it was stored.
+    std::vector<std::pair<int64_t, uint64_t>> cluster_versions;
+  };
+
+ public:
+  /**
+   * @brief The routes and the versions of the clusters at some point (refer to
+   * save()).
+   */
+  class Snapshot {
+   private:
+    friend class PathCache;
+
+    std::list<Route> routes_;
+    std::vector<uint64_t> cluster_versions_;
+    int64_t hits_{0};
+    int64_t lookups_{0};
+  };
+
+  /**
+   * @param capacity Maximum number of routes kept at once.
+   */
+  PathCache(int64_t capacity);
+  /**
+   * @brief Look up the route between two clusters.
+   *
+   * Every call counts as a lookup, and as a hit when a route is returned (even
+   * if the caller then finds it does not apply).
+   *
+   * @param start_cluster Cluster where the route starts.
+   * @param goal_cluster Cluster where the route ends.
+   * @param size_class Class of size of the character following the route.
+   * @param waypoints Receives the waypoints of the route if found. Cleared
+   * first.
+   * @return bool Whether a valid route was found.
+   */
+  bool find(int64_t start_cluster, int64_t goal_cluster, int64_t size_class,
+            std::vector<TilePosition>& waypoints);
+  int64_t hits() const;
+  /**
+   * @brief Returns the ratio of lookups which were hits, zero if none.
+   */
+  double hitRate() const;
+  /**
+   * @brief Bump the version of a cluster, invalidating the routes through it.
+   */
+  void invalidate(int64_t cluster);
+  int64_t lookups() const;
+  /**
+   * @brief Bring the cache back to a snapshot.
+   *
+   * @param snapshot A snapshot saved from a cache of the same level.
+   */
+  void restore(Snapshot const& snapshot);
+  /**
+   * @brief Save the routes and the versions of the clusters.
+   *
+   * @param snapshot Receives the state, overwritten.
+   */
+  void save(Snapshot& snapshot) const;
+  /**
+   * @brief Store the route between two clusters, replacing the previous one.
+   *
+   * @param clusters Clusters the route goes through.
+   */
+  void store(int64_t start_cluster, int64_t goal_cluster, int64_t size_class,
+             std::vector<TilePosition> const& waypoints,
+             std::vector<int64_t> const& clusters);
+
+ private:
+  int64_t const capacity_;
+  // Most recently used first.
+  std::list<Route> routes_;
+  std::unordered_map<Key, std::list<Route>::iterator, KeyHash> routes_by_key_;
+  std::vector<uint64_t> cluster_versions_;
+  int64_t hits_{0};
+  int64_t lookups_{0};
+
+  uint64_t version(int64_t cluster) const;
+};
+
+#endif
@@ -0,0 +1,218 @@
+/*
+ * Copyright (C) 2021-2023 Jean-Marie BARAN (jeanmarie.baran@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Refer to 'COPYING.txt' for the full notice.
+ */
+
+#include <algorithm>
+#include <array>
+#include <libflatkiss/logic/path_finder.hpp>
+#include <utility>
+
+using std::abs;
+using std::array;
+using std::pair;
+using std::reverse;
+using std::swap;
+using std::vector;
+
+void PathFinder::beginQuery(int64_t num_nodes) {
+  if (nodes_.size() < num_nodes) {
+    nodes_.resize(num_nodes);
+    open_.reserve(num_nodes);
+  }
+  open_.clear();
+
+  generation_++;
+  if (generation_ == 0) {
+    /* The counter wrapped around: some nodes could have a generation matching
+     * a future query. Reset all of them once (this happens every 4 billion
+     * queries). */
+    for (Node& node : nodes_) {
+      node.generation = 0;
+    }
+    generation_ = 1;
+  }
+}
+
+int64_t PathFinder::distance(int64_t x1, int64_t y1, int64_t x2, int64_t y2) {
+  // Manhattan distance, exact when moving along the cardinal directions only.
+  return abs(x2 - x1) + abs(y2 - y1);
+}
+
+bool PathFinder::findPath(Solid const& solid, TilePosition const& start,
+                          TilePosition const& goal,
+                          ClearanceMap const& clearance_map,
+                          vector<TilePosition>& path) {
+  path.clear();
+  Level const& level{clearance_map.level()};
+  if (!isInLevel(start, level) || !isInLevel(goal, level)) {
+    return false;
+  }
+  int64_t const width{level.widthInTiles()};
+  beginQuery(width * level.heightInTiles());
+
+  int64_t const start_index{start.y() * width + start.x()};
+  int64_t const goal_index{goal.y() * width + goal.x()};
+  if (!touch(start_index, solid, clearance_map).walkable ||
+      !touch(goal_index, solid, clearance_map).walkable) {
+    return false;
+  }
+
+  Node& start_node{nodes_[start_index]};
+  start_node.estimate = distance(start.x(), start.y(), goal.x(), goal.y());
+  pushOpen(start_index);
+
+  while (!open_.empty()) {
+    int64_t const current_index{popOpen()};
+    if (current_index == goal_index) {
+      // Walk the parents back to the start, then put them in order.
+      for (int64_t index{goal_index}; index != -1;
+           index = nodes_[index].parent) {
+        path.emplace_back(index % width, index / width);
+      }
+      reverse(path.begin(), path.end());
+      return true;
+    }
+
+    Node& current{nodes_[current_index]};
+    current.closed = true;
+    int64_t const x{current_index % width};
+    int64_t const y{current_index / width};
+    for (auto [dx, dy] : array<pair<int64_t, int64_t>, 4>{
+             {{-1, 0}, {1, 0}, {0, -1}, {0, 1}}}) {
+      int64_t const neighbour_x{x + dx};
+      int64_t const neighbour_y{y + dy};
+      if (neighbour_x < 0 || neighbour_x >= width || neighbour_y < 0 ||
+          neighbour_y >= level.heightInTiles()) {
+        continue;
+      }
+
+      int64_t const neighbour_index{neighbour_y * width + neighbour_x};
+      Node& neighbour{touch(neighbour_index, solid, clearance_map)};
+      if (!neighbour.walkable || neighbour.closed) {
+        continue;
+      }
+
+      int64_t const cost{nodes_[current_index].cost + 1};
+      if (neighbour.heap_index != -1 && cost >= neighbour.cost) {
+        continue;
+      }
+
+      neighbour.parent = current_index;
+      neighbour.cost = cost;
+      neighbour.estimate =
+          cost + distance(neighbour_x, neighbour_y, goal.x(), goal.y());
+      if (neighbour.heap_index == -1) {
+        pushOpen(neighbour_index);
+      } else {
+        siftUp(neighbour.heap_index);
+      }
+    }
+  }
+
+  return false;
+}
+
+bool PathFinder::isBefore(int64_t node_index1, int64_t node_index2) const {
+  Node const& node1{nodes_[node_index1]};
+  Node const& node2{nodes_[node_index2]};
+  if (node1.estimate != node2.estimate) {
+    return node1.estimate < node2.estimate;
+  }
+
+  // On ties, favour the node nearest to the goal (fewer nodes get expanded).
+  return node1.cost > node2.cost;
+}
+
+bool PathFinder::isInLevel(TilePosition const& tile, Level const& level) {
+  return tile.x() >= 0 && tile.x() < level.widthInTiles() && tile.y() >= 0 &&
+         tile.y() < level.heightInTiles();
+}
+
+bool PathFinder::isWalkable(Solid const& solid, int64_t x, int64_t y,
+                            ClearanceMap const& clearance_map) {
+  Level const& level{clearance_map.level()};
+  return clearance_map.fits(
+      solid.boundingBox(), Position{x * level.spriteset().spritesWidth(),
+                                    y * level.spriteset().spritesHeight()});
+}
+
+int64_t PathFinder::popOpen() {
+  int64_t const node_index{open_.front()};
+  swapOpen(0, static_cast<int64_t>(open_.size()) - 1);
+  open_.pop_back();
+  nodes_[node_index].heap_index = -1;
+  if (!open_.empty()) {
+    siftDown(0);
+  }
+
+  return node_index;
+}
+
+void PathFinder::pushOpen(int64_t node_index) {
+  open_.push_back(node_index);
+  nodes_[node_index].heap_index = static_cast<int64_t>(open_.size()) - 1;
+  siftUp(nodes_[node_index].heap_index);
+}
+
+void PathFinder::siftDown(int64_t heap_index) {
+  int64_t const size{static_cast<int64_t>(open_.size())};
+  while (true) {
+    int64_t smallest{heap_index};
+    for (int64_t child : {2 * heap_index + 1, 2 * heap_index + 2}) {
+      if (child < size && isBefore(open_[child], open_[smallest])) {
+        smallest = child;
+      }
+    }
+    if (smallest == heap_index) {
+      return;
+    }
+    swapOpen(heap_index, smallest);
+    heap_index = smallest;
+  }
+}
+
+void PathFinder::siftUp(int64_t heap_index) {
+  while (heap_index > 0) {
+    int64_t const parent{(heap_index - 1) / 2};
+    if (!isBefore(open_[heap_index], open_[parent])) {
+      return;
+    }
+    swapOpen(heap_index, parent);
+    heap_index = parent;
+  }
+}
+
+void PathFinder::swapOpen(int64_t heap_index1, int64_t heap_index2) {
+  swap(open_[heap_index1], open_[heap_index2]);
+  nodes_[open_[heap_index1]].heap_index = heap_index1;
+  nodes_[open_[heap_index2]].heap_index = heap_index2;
+}
+
+PathFinder::Node& PathFinder::touch(int64_t node_index, Solid const& solid,
+                                    ClearanceMap const& clearance_map) {
+  Node& node{nodes_[node_index]};
+  if (node.generation != generation_) {
+    int64_t const width{clearance_map.level().widthInTiles()};
+    node = Node{};
+    node.generation = generation_;
+    node.walkable = isWalkable(solid, node_index % width, node_index / width,
+                               clearance_map);
+  }
+
+  return node;
+}
@@ -0,0 +1,103 @@
+/*
+ * Copyright (C) 2021-2023 Jean-Marie BARAN (jeanmarie.baran@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Refer to 'COPYING.txt' for the full notice.
+ */
+
+#ifndef LIBFLATKISS_LOGIC_PATH_FINDER_HPP_INCLUDED
+#define LIBFLATKISS_LOGIC_PATH_FINDER_HPP_INCLUDED
+
+#include <libflatkiss/logic/clearance_map.hpp>
+#include <libflatkiss/model/model.hpp>
+#include <vector>
+
+/**
+ * @brief Finds paths between tiles of a level using A*.
+ *
+ * A solid can stand on a tile when, placed at the top left of that tile, its
+ * bounding box fits in the clearance map of the level. The search moves along
+ * the four cardinal directions.
+ *
+ * The nodes of the search are kept from one query to the next. Instead of
+ * clearing them, each query bumps a generation counter and a node is reset the
+ * first time a query touches it. The open list is a binary heap of node indices
+ * in which each node knows its own slot, so that lowering its cost does not
+ * require a search. Once the path finder has seen a level of a given size,
+ * queries on it do not allocate anymore (provided the vector receiving the path
+ * is reused too).
+ */
+class PathFinder {
+ public:
+  /**
+   * @brief Find a path from the start tile to the goal tile.
+   *
+   * @param solid The solid which follows the path.
+   * @param start Tile where the path starts.
+   * @param goal Tile where the path ends.
+   * @param clearance_map Clearances of the level in which to search.
+   * @param path Receives the tiles of the path from the start to the goal,
+   * both included. Cleared first. Left empty when there is no path.
+   * @return bool Whether a path was found, false when the start or the goal
+   * is out of the level.
+   */
+  bool findPath(Solid const& solid, TilePosition const& start,
+                TilePosition const& goal, ClearanceMap const& clearance_map,
+                std::vector<TilePosition>& path);
+  /**
+   * @brief Whether the solid can stand on the given tile.
+   *
+   * @param solid The solid to place at the top left of the tile.
+   * @param x Location of the tile along the horizontal axis, in tiles.
+   * @param y Location of the tile along the vertical axis, in tiles.
+   * @param clearance_map Clearances of the level.
+   * @return bool Whether the solid fits there.
+   */
+  static bool isWalkable(Solid const& solid, int64_t x, int64_t y,
+                         ClearanceMap const& clearance_map);
+
+ private:
+  struct Node {
+    // The query which last touched the node. Stale nodes must be reset.
+    uint32_t generation{0};
+    bool walkable{false};
+    bool closed{false};
+    // Index of the node in the open heap, -1 when not in it.
+    int64_t heap_index{-1};
+    int64_t parent{-1};
+    // Cost from the start.
+    int64_t cost{0};
+    // Cost from the start plus the estimated remaining cost to the goal.
+    int64_t estimate{0};
+  };
+
+  std::vector<Node> nodes_;
+  std::vector<int64_t> open_;
+  uint32_t generation_{0};
+
+  void beginQuery(int64_t num_nodes);
+  static int64_t distance(int64_t x1, int64_t y1, int64_t x2, int64_t y2);
+  bool isBefore(int64_t node_index1, int64_t node_index2) const;
+  static bool isInLevel(TilePosition const& tile, Level const& level);
+  int64_t popOpen();
+  void pushOpen(int64_t node_index);
+  void siftDown(int64_t heap_index);
+  void siftUp(int64_t heap_index);
+  void swapOpen(int64_t heap_index1, int64_t heap_index2);
+  Node& touch(int64_t node_index, Solid const& solid,
+              ClearanceMap const& clearance_map);
+};
+
+#endif
@@ -0,0 +1,247 @@
+/*
+ * Copyright (C) 2021-2023 Jean-Marie BARAN (jeanmarie.baran@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Refer to 'COPYING.txt' for the full notice.
+ */
+
+#include <algorithm>
+#include <libflatkiss/logic/path_request_service.hpp>
+
+using std::make_unique;
+using std::max;
+using std::pop_heap;
+using std::push_heap;
+using std::vector;
+
+PathRequestService::PathRequestService(ClearanceMap const& clearance_map,
+                                       PathCache& path_cache)
+    : clearance_map_{clearance_map}, path_cache_{path_cache} {}
+
+double PathRequestService::averageLatencyInTicks() const {
+  return completed_requests_ == 0
+             ? 0
+             : static_cast<double>(total_latency_in_ticks_) /
+                   completed_requests_;
+}
+
+void PathRequestService::cancel(int64_t handle) {
+  auto const found{requests_.find(handle)};
+  if (found == requests_.end()) {
+    return;
+  }
+
+  if (found->second.status == Status::kPending) {
+    // Its entry in the queue is skipped when popped.
+    queue_depth_--;
+  }
+  requests_.erase(found);
+  if (handle == current_handle_) {
+    current_handle_ = -1;
+  }
+}
+
+void PathRequestService::complete(int64_t tick, Request& request,
+                                  HierarchicalPathFinder::SearchStatus status) {
+  request.status = status == HierarchicalPathFinder::SearchStatus::kFound
+                       ? Status::kFound
+                       : Status::kNotFound;
+  current_handle_ = -1;
+
+  int64_t const latency{tick - request.submission_tick};
+  queue_depth_--;
+  completed_requests_++;
+  total_latency_in_ticks_ += latency;
+  max_latency_in_ticks_ = max(max_latency_in_ticks_, latency);
+}
+
+int64_t PathRequestService::completedRequests() const {
+  return completed_requests_;
+}
+
+int64_t PathRequestService::enqueue(Solid const& solid,
+                                    TilePosition const& start,
+                                    TilePosition const& goal, int64_t priority,
+                                    int64_t tick) {
+  SizeKey const size_key{sizeKey(solid)};
+  if (!path_finders_.contains(size_key)) {
+    solids_.try_emplace(size_key, solid);
+  }
+
+  int64_t const handle{next_handle_++};
+  requests_.emplace(handle, Request{size_key, start, goal, tick,
+                                    Status::kPending, {}});
+  // Negated handle, so that older requests come first on equal priorities.
+  queue_.emplace_back(priority, -handle);
+  push_heap(queue_.begin(), queue_.end());
+  queue_depth_++;
+  max_queue_depth_ = max(max_queue_depth_, queue_depth_);
+  return handle;
+}
+
+int64_t PathRequestService::maxLatencyInTicks() const {
+  return max_latency_in_ticks_;
+}
+
+int64_t PathRequestService::maxQueueDepth() const { return max_queue_depth_; }
+
+void PathRequestService::onTileChanged(int64_t x, int64_t y) {
+  for (auto& [_, path_finder] : path_finders_) {
+    path_finder->onTileChanged(x, y);
+  }
+}
+
+HierarchicalPathFinder& PathRequestService::pathFinder(
+    SizeKey const& size_key) {
+  auto const solid{solids_.find(size_key)};
+  return solid != solids_.end() ? pathFinder(solid->second)
+                                : *path_finders_.at(size_key);
+}
+
+HierarchicalPathFinder& PathRequestService::pathFinder(Solid const& solid) {
+  SizeKey const size_key{sizeKey(solid)};
+  auto found{path_finders_.find(size_key)};
+  if (found == path_finders_.end()) {
+    found = path_finders_
+                .emplace(size_key, make_unique<HierarchicalPathFinder>(
+                                       solid, clearance_map_, path_cache_))
+                .first;
+    solids_.erase(size_key);
+  }
+
+  return *found->second;
+}
+
+void PathRequestService::process(int64_t tick, int64_t budget_expansions) {
+  using SearchStatus = HierarchicalPathFinder::SearchStatus;
+
+  int64_t expansions{0};
+  while (expansions < budget_expansions) {
+    if (current_handle_ == -1) {
+      if (queue_.empty()) {
+        return;
+      }
+      current_handle_ = -queue_.front().second;
+      pop_heap(queue_.begin(), queue_.end());
+      queue_.pop_back();
+      auto const found{requests_.find(current_handle_)};
+      if (found == requests_.end()) {
+        // Cancelled.
+        current_handle_ = -1;
+        continue;
+      }
+
+      Request& request{found->second};
+      SearchStatus const status{pathFinder(request.size_key)
+                                    .beginSearch(request.start, request.goal,
+                                                 request.waypoints)};
+      expansions += kExpansionsPerStep;
+      current_steps_ = 1;
+      if (status != SearchStatus::kInProgress) {
+        complete(tick, request, status);
+      }
+      continue;
+    }
+
+    auto const found{requests_.find(current_handle_)};
+    if (found == requests_.end()) {
+      // Cancelled while in progress.
+      current_handle_ = -1;
+      continue;
+    }
+
+    Request& request{found->second};
+    HierarchicalPathFinder& path_finder{pathFinder(request.size_key)};
+    if (restart_search_ || !path_finder.isSearching()) {
+      /* The search was dropped (e.g. a tile changed), or the path finder may
+       * be searching for another request (restored). Start it over and bring
+       * it back to the step where it was: searches are deterministic, so it
+       * then goes on as if it had never been interrupted. */
+      restart_search_ = false;
+      SearchStatus status{path_finder.beginSearch(request.start, request.goal,
+                                                  request.waypoints)};
+      if (status == SearchStatus::kInProgress && current_steps_ > 1) {
+        status = path_finder.continueSearch(
+            (current_steps_ - 1) * kExpansionsPerStep, request.waypoints);
+      }
+      if (status != SearchStatus::kInProgress) {
+        // The graph changed, the search ends within the steps already counted.
+        complete(tick, request, status);
+        continue;
+      }
+    }
+    SearchStatus const status{
+        path_finder.continueSearch(kExpansionsPerStep, request.waypoints)};
+    expansions += kExpansionsPerStep;
+    current_steps_++;
+    if (status != SearchStatus::kInProgress) {
+      complete(tick, request, status);
+    }
+  }
+}
+
+int64_t PathRequestService::queueDepth() const { return queue_depth_; }
+
+void PathRequestService::restore(Snapshot const& snapshot) {
+  requests_ = snapshot.requests_;
+  queue_ = snapshot.queue_;
+  current_handle_ = snapshot.current_handle_;
+  current_steps_ = snapshot.current_steps_;
+  restart_search_ = current_handle_ != -1;
+  next_handle_ = snapshot.next_handle_;
+  queue_depth_ = snapshot.queue_depth_;
+  max_queue_depth_ = snapshot.max_queue_depth_;
+  completed_requests_ = snapshot.completed_requests_;
+  total_latency_in_ticks_ = snapshot.total_latency_in_ticks_;
+  max_latency_in_ticks_ = snapshot.max_latency_in_ticks_;
+}
+
+void PathRequestService::save(Snapshot& snapshot) const {
+  snapshot.requests_ = requests_;
+  snapshot.queue_ = queue_;
+  snapshot.current_handle_ = current_handle_;
+  snapshot.current_steps_ = current_steps_;
+  snapshot.next_handle_ = next_handle_;
+  snapshot.queue_depth_ = queue_depth_;
+  snapshot.max_queue_depth_ = max_queue_depth_;
+  snapshot.completed_requests_ = completed_requests_;
+  snapshot.total_latency_in_ticks_ = total_latency_in_ticks_;
+  snapshot.max_latency_in_ticks_ = max_latency_in_ticks_;
+}
+
+PathRequestService::SizeKey PathRequestService::sizeKey(Solid const& solid) {
+  PositionedRectangle const& bounding_box{solid.boundingBox()};
+  return SizeKey{bounding_box.x(), bounding_box.y(), bounding_box.width(),
+                 bounding_box.height()};
+}
+
+PathRequestService::Status PathRequestService::status(int64_t handle) const {
+  auto const found{requests_.find(handle)};
+  return found == requests_.end() ? Status::kUnknown : found->second.status;
+}
+
+bool PathRequestService::takeWaypoints(int64_t handle,
+                                       vector<TilePosition>& waypoints) {
+  waypoints.clear();
+  auto const found{requests_.find(handle)};
+  if (found == requests_.end() || found->second.status == Status::kPending) {
+    return false;
+  }
+
+  bool const has_path{found->second.status == Status::kFound};
+  waypoints.swap(found->second.waypoints);
+  requests_.erase(found);
+  return has_path;
+}
@@ -0,0 +1,216 @@
+/*
+ * Copyright (C) 2021-2023 Jean-Marie BARAN (jeanmarie.baran@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Refer to 'COPYING.txt' for the full notice.
+ */
+
+#ifndef LIBFLATKISS_LOGIC_PATH_REQUEST_SERVICE_HPP_INCLUDED
+#define LIBFLATKISS_LOGIC_PATH_REQUEST_SERVICE_HPP_INCLUDED
+
+#include <array>
+#include <libflatkiss/logic/clearance_map.hpp>
+#include <libflatkiss/logic/hierarchical_path_finder.hpp>
+#include <libflatkiss/logic/path_cache.hpp>
+#include <libflatkiss/model/model.hpp>
+#include <map>
+#include <memory>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Solves path requests over several ticks.
+ *
+ * Searching for paths right away in CharacterController::onTick() would make
+ * a tick last too long when many characters need a path at once. Instead,
+ * controllers enqueue requests and get a handle back. Once per tick, process()
+ * solves the pending requests by order of priority, until its budget of node
+ * expansions is spent. A search is carried on a few nodes at a time, so a long
+ * one is simply resumed on the next tick, as are the remaining requests.
+ *
+ * The budget is counted in nodes rather than in time, so that the tick at
+ * which a request is solved does not depend on the speed of the machine: the
+ * same inputs give the same world, e.g. when replaying them.
+ *
+ * Requests are solved with a HierarchicalPathFinder, one per size of solid,
+ * built the first time a request for that size is processed (or by calling
+ * pathFinder() beforehand). A solved request gives the waypoints of the path:
+ * the controller refines them with the path finder as it reaches them, so that
+ * the cost of a request stays small and bounded.
+ */
+class PathRequestService {
+ private:
+  // Bounding box of a solid (x, y, width, height), the path finders depend on
+  // nothing else.
+  using SizeKey = std::array<int64_t, 4>;
+
+ public:
+  enum class Status {
+    kPending,
+    kFound,
+    kNotFound,
+    // Never enqueued, cancelled, or the result was already taken.
+    kUnknown,
+  };
+
+  /**
+   * @brief The requests at some point (refer to save()).
+   */
+  class Snapshot {
+   private:
+    friend class PathRequestService;
+
+    struct Request {
+      SizeKey size_key;
+      TilePosition start;
+      TilePosition goal;
+      int64_t submission_tick;
+      Status status;
+      std::vector<TilePosition> waypoints;
+    };
+
+    std::unordered_map<int64_t, Request> requests_;
+    std::vector<std::pair<int64_t, int64_t>> queue_;
+    int64_t current_handle_{-1};
+    int64_t current_steps_{0};
+    int64_t next_handle_{0};
+    int64_t queue_depth_{0};
+    int64_t max_queue_depth_{0};
+    int64_t completed_requests_{0};
+    int64_t total_latency_in_ticks_{0};
+    int64_t max_latency_in_ticks_{0};
+  };
+
+  /**
+   * @param clearance_map Clearances of the level, must outlive the service.
+   * @param path_cache Cache of routes shared by the path finders, must outlive
+   * the service.
+   */
+  PathRequestService(ClearanceMap const& clearance_map, PathCache& path_cache);
+  /**
+   * @brief Returns the average number of ticks between the submission and the
+   * completion of the requests.
+   */
+  double averageLatencyInTicks() const;
+  /**
+   * @brief Forget a request, whether it was solved or not.
+   */
+  void cancel(int64_t handle);
+  int64_t completedRequests() const;
+  /**
+   * @brief Submit a path request.
+   *
+   * @param solid The solid which follows the path.
+   * @param start Tile where the path starts.
+   * @param goal Tile where the path ends.
+   * @param priority Requests with a greater priority are solved first. Among
+   * requests of the same priority, the oldest are solved first.
+   * @param tick The current tick.
+   * @return int64_t The handle of the request.
+   */
+  int64_t enqueue(Solid const& solid, TilePosition const& start,
+                  TilePosition const& goal, int64_t priority, int64_t tick);
+  int64_t maxLatencyInTicks() const;
+  int64_t maxQueueDepth() const;
+  /**
+   * @brief Forward a change of tile to the path finders.
+   *
+   * The clearance map must have been notified first.
+   */
+  void onTileChanged(int64_t x, int64_t y);
+  /**
+   * @brief Returns the path finder for the given solid, building it if needed.
+   *
+   * It is meant for refining waypoints. Searching with it directly would drop
+   * the request being solved by the service.
+   */
+  HierarchicalPathFinder& pathFinder(Solid const& solid);
+  /**
+   * @brief Solve pending requests until the budget is spent.
+   *
+   * Searches are carried on kExpansionsPerStep nodes at a time, and each step
+   * is counted as that many nodes, even when the search ends before. Beginning
+   * a search counts as a step too. Building a path finder (the first time a
+   * size of solid is met) is not counted.
+   *
+   * @param tick The current tick.
+   * @param budget_expansions Number of nodes the searches may expand.
+   */
+  void process(int64_t tick, int64_t budget_expansions);
+  /**
+   * @brief Returns the number of requests waiting to be solved.
+   */
+  int64_t queueDepth() const;
+  /**
+   * @brief Bring the requests back to those saved in a snapshot.
+   *
+   * The request whose search was in progress is searched again from the
+   * start, up to where it was when saved, without counting against the
+   * budget. The path finders built since the snapshot are kept.
+   */
+  void restore(Snapshot const& snapshot);
+  /**
+   * @brief Save the requests, solved or not.
+   *
+   * @param snapshot Receives the requests, overwritten.
+   */
+  void save(Snapshot& snapshot) const;
+  Status status(int64_t handle) const;
+  /**
+   * @brief Retrieve the waypoints of a solved request, and forget it.
+   *
+   * @param handle The handle of the request.
+   * @param waypoints Receives the waypoints, refer to
+   * HierarchicalPathFinder::findAbstractPath(). Cleared first.
+   * @return bool False if the request is not solved yet, has no path, or is
+   * unknown. The request is forgotten unless it is still pending.
+   */
+  bool takeWaypoints(int64_t handle, std::vector<TilePosition>& waypoints);
+
+ private:
+  using Request = Snapshot::Request;
+
+  ClearanceMap const& clearance_map_;
+  PathCache& path_cache_;
+  std::map<SizeKey, std::unique_ptr<HierarchicalPathFinder>> path_finders_;
+  // Solids waiting for their path finder to be built.
+  std::map<SizeKey, Solid const> solids_;
+  std::unordered_map<int64_t, Request> requests_;
+  // Heap of (priority, -handle), cancelled handles are skipped when popped.
+  std::vector<std::pair<int64_t, int64_t>> queue_;
+  // Request whose search is in progress, -1 if none.
+  int64_t current_handle_{-1};
+  // Steps of the search of the current request, beginning included.
+  int64_t current_steps_{0};
+  /* Whether the search of the current request must be started over, and
+   * brought back to where it was. */
+  bool restart_search_{false};
+  int64_t next_handle_{0};
+  int64_t queue_depth_{0};
+  int64_t max_queue_depth_{0};
+  int64_t completed_requests_{0};
+  int64_t total_latency_in_ticks_{0};
+  int64_t max_latency_in_ticks_{0};
+
+  static int64_t constexpr kExpansionsPerStep{64};
+
+  void complete(int64_t tick, Request& request,
+                HierarchicalPathFinder::SearchStatus status);
+  HierarchicalPathFinder& pathFinder(SizeKey const& size_key);
+  static SizeKey sizeKey(Solid const& solid);
+};
+
+#endif
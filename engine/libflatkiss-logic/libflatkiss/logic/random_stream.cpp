@@ -0,0 +1,41 @@
+/*
+ * Copyright (C) 2021-2023 Jean-Marie BARAN (jeanmarie.baran@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Refer to 'COPYING.txt' for the full notice.
+ */
+
+#include <libflatkiss/logic/random_stream.hpp>
+
+RandomStream::RandomStream(uint64_t seed, uint64_t key, uint64_t tick)
+    : state_{mix(mix(seed, key), tick)} {}
+
+int64_t RandomStream::between(int64_t lower, int64_t upper) {
+  /* The modulo slightly favours the lowest values, by far less than what
+   * matters for ranges as small as those used by the controllers. */
+  return lower + static_cast<int64_t>(
+                     next() % static_cast<uint64_t>(upper - lower + 1));
+}
+
+uint64_t RandomStream::mix(uint64_t seed, uint64_t value) {
+  // NOLINTBEGIN(readability-magic-numbers)
+  uint64_t hash{seed ^ (value + 0x9E3779B97F4A7C15ULL)};
+  hash = (hash ^ (hash >> 30U)) * 0xBF58476D1CE4E5B9ULL;
+  hash = (hash ^ (hash >> 27U)) * 0x94D049BB133111EBULL;
+  return hash ^ (hash >> 31U);
+  // NOLINTEND(readability-magic-numbers)
+}
+
+uint64_t RandomStream::next() { return mix(state_, counter_++); }
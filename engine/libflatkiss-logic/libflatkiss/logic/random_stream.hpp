@@ -0,0 +1,64 @@
+/*
+ * Copyright (C) 2021-2023 Jean-Marie BARAN (jeanmarie.baran@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Refer to 'COPYING.txt' for the full notice.
+ */
+
+#ifndef LIBFLATKISS_LOGIC_RANDOM_STREAM_HPP_INCLUDED
+#define LIBFLATKISS_LOGIC_RANDOM_STREAM_HPP_INCLUDED
+
+#include <cstdint>
+
+/**
+ * @brief Random values computed from a key instead of drawn from a shared
+ * state.
+ *
+ * The values of a stream only depend on its seed, key and tick, and on how
+ * many values were drawn from it before: the same stream always gives the same
+ * values, whichever thread computes it and whenever it does. Each value is a
+ * hash of all of these, using the finalizer of SplitMix64.
+ */
+class RandomStream {
+ public:
+  /**
+   * @param seed Seed of the world (or of a part of it).
+   * @param key Identifies whom the stream is for (e.g. a character).
+   * @param tick The tick for which the values are drawn.
+   */
+  RandomStream(uint64_t seed, uint64_t key, uint64_t tick);
+  /**
+   * @brief Returns a value between [lower, upper].
+   *
+   * @param lower Minimum possible value.
+   * @param upper Maximum possible value.
+   * @return int64_t A value in the interval [lower, upper], inclusive.
+   */
+  int64_t between(int64_t lower, int64_t upper);
+  /**
+   * @brief Returns a well spread hash of a value mixed with a seed.
+   */
+  static uint64_t mix(uint64_t seed, uint64_t value);
+  /**
+   * @brief Returns the next value of the stream, over the 64 bits.
+   */
+  uint64_t next();
+
+ private:
+  uint64_t const state_;
+  uint64_t counter_{0};
+};
+
+#endif
@@ -0,0 +1,155 @@
+/*
+ * Copyright (C) 2021-2023 Jean-Marie BARAN (jeanmarie.baran@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Refer to 'COPYING.txt' for the full notice.
+ */
+
+#include <libflatkiss/logic/script.hpp>
+#include <libflatkiss/logic/script_frame_allocator.hpp>
+#include <utility>
+
+using std::coroutine_handle;
+using std::current_exception;
+using std::exchange;
+using std::rethrow_exception;
+using std::size_t;
+using std::suspend_always;
+
+Script::Context::Context(ClearanceMap const& clearance_map, int64_t tick,
+                         Vector const& pending_displacement)
+    : clearance_map_{&clearance_map},
+      tick_{tick},
+      pending_dx_{pending_displacement.dx()},
+      pending_dy_{pending_displacement.dy()} {}
+
+bool Script::Context::fits(Character const& character,
+                           CardinalDirection direction) const {
+  int64_t delta_x{pending_dx_};
+  int64_t delta_y{pending_dy_};
+  switch (direction) {
+    case kWest:
+      delta_x--;
+      break;
+    case kSouth:
+      delta_y++;
+      break;
+    case kEast:
+      delta_x++;
+      break;
+    case kNorth:
+      delta_y--;
+      break;
+  }
+  return clearance_map_->fits(character.solid().boundingBox(),
+                              character.position() + Vector{delta_x, delta_y});
+}
+
+Level const& Script::Context::level() const { return clearance_map_->level(); }
+
+int64_t Script::Context::tick() const { return tick_; }
+
+Script Script::promise_type::get_return_object() {
+  return Script{coroutine_handle<promise_type>::from_promise(*this)};
+}
+
+suspend_always Script::promise_type::initial_suspend() noexcept { return {}; }
+
+suspend_always Script::promise_type::final_suspend() noexcept { return {}; }
+
+void Script::promise_type::return_void() {}
+
+void Script::promise_type::unhandled_exception() {
+  exception = current_exception();
+}
+
+void* Script::promise_type::operator new(size_t size) {
+  return ScriptFrameAllocator::allocate(size);
+}
+
+void Script::promise_type::operator delete(void* frame, size_t size) {
+  ScriptFrameAllocator::deallocate(frame, size);
+}
+
+Script::CommandAwaiter::CommandAwaiter(Command const& command)
+    : command_{command} {}
+
+bool Script::CommandAwaiter::await_ready() const noexcept { return false; }
+
+void Script::CommandAwaiter::await_suspend(
+    coroutine_handle<promise_type> handle) const {
+  handle.promise().command = command_;
+}
+
+void Script::CommandAwaiter::await_resume() const noexcept {}
+
+bool Script::ContextAwaiter::await_ready() const noexcept { return false; }
+
+bool Script::ContextAwaiter::await_suspend(
+    coroutine_handle<promise_type> handle) {
+  context_ = &handle.promise().context;
+  // Carry on right away.
+  return false;
+}
+
+Script::Context const& Script::ContextAwaiter::await_resume() const {
+  return *context_;
+}
+
+Script::Script(coroutine_handle<promise_type> handle) : handle_{handle} {}
+
+Script::Script(Script&& other) noexcept
+    : handle_{exchange(other.handle_, nullptr)} {}
+
+Script::~Script() {
+  if (handle_) {
+    handle_.destroy();
+  }
+}
+
+Script::ContextAwaiter Script::context() { return {}; }
+
+bool Script::done() const { return handle_.done(); }
+
+Script::CommandAwaiter Script::gather(TilePosition const& goal) {
+  return CommandAwaiter{{Command::Kind::kGather, kSouth, 0, goal}};
+}
+
+Script::CommandAwaiter Script::idle(int64_t num_ticks) {
+  return CommandAwaiter{{Command::Kind::kIdle, kSouth, num_ticks}};
+}
+
+Script::Command const& Script::resume(Context const& context) {
+  promise_type& promise{handle_.promise()};
+  promise.context = context;
+  handle_.resume();
+  if (promise.exception) {
+    rethrow_exception(promise.exception);
+  }
+  return promise.command;
+}
+
+Script::CommandAwaiter Script::waitForEvent() {
+  return CommandAwaiter{{Command::Kind::kWaitForEvent, kSouth, 0}};
+}
+
+Script::CommandAwaiter Script::walk(CardinalDirection direction,
+                                    int64_t num_ticks) {
+  return CommandAwaiter{{Command::Kind::kWalk, direction, num_ticks}};
+}
+
+Script::CommandAwaiter Script::walkTo(TilePosition const& goal) {
+  return CommandAwaiter{{Command::Kind::kWalkTo, kSouth, 0, goal}};
+}
@@ -0,0 +1,202 @@
+/*
+ * Copyright (C) 2021-2023 Jean-Marie BARAN (jeanmarie.baran@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Refer to 'COPYING.txt' for the full notice.
+ */
+
+#ifndef LIBFLATKISS_LOGIC_SCRIPT_HPP_INCLUDED
+#define LIBFLATKISS_LOGIC_SCRIPT_HPP_INCLUDED
+
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <libflatkiss/logic/clearance_map.hpp>
+#include <libflatkiss/model/model.hpp>
+
+/**
+ * @brief A behaviour written as a coroutine, run by the scripted controller.
+ *
+ * A script is a function returning a Script, which tells what its character
+ * does by awaiting commands, e.g.:
+ *
+ *   co_await Script::walk(kEast, 35);
+ *   co_await Script::idle(250);
+ *
+ * The script is suspended at each command, until the command is over. Its
+ * state is its own local variables, kept in its frame (allocated by
+ * ScriptFrameAllocator). A script must take its arguments by value: references
+ * would outlive what they refer to.
+ *
+ * A frame cannot be copied: a script must be able to start over from any of its
+ * commands instead (refer to CharacterScripts).
+ */
+class Script {
+ public:
+  /**
+   * @brief What the character does until the script is resumed.
+   */
+  struct Command {
+    enum class Kind {
+      kGather,
+      kIdle,
+      kWaitForEvent,
+      kWalk,
+      kWalkTo,
+    };
+
+    Kind kind;
+    CardinalDirection direction;
+    int64_t num_ticks;
+    // Tile to reach, for the commands which lead to a goal.
+    TilePosition goal{0, 0};
+  };
+  /**
+   * @brief What the script can see of the world, refreshed each time it is
+   * resumed.
+   */
+  class Context {
+   public:
+    Context() = default;
+    /**
+     * @param clearance_map Clearance map of the level of the character.
+     * @param tick The tick at which the script is resumed.
+     * @param pending_displacement Steps walked but not applied yet to the
+     * position of the character.
+     */
+    Context(ClearanceMap const& clearance_map, int64_t tick,
+            Vector const& pending_displacement);
+    /**
+     * @brief Whether the character fits one step towards the direction.
+     */
+    bool fits(Character const& character, CardinalDirection direction) const;
+    Level const& level() const;
+    int64_t tick() const;
+
+   private:
+    ClearanceMap const* clearance_map_{nullptr};
+    int64_t tick_{0};
+    int64_t pending_dx_{0};
+    int64_t pending_dy_{0};
+  };
+  class promise_type {
+   public:
+    Script get_return_object();
+    // Scripts only start once resumed by their controller.
+    std::suspend_always initial_suspend() noexcept;
+    std::suspend_always final_suspend() noexcept;
+    void return_void();
+    void unhandled_exception();
+    static void* operator new(std::size_t size);
+    static void operator delete(void* frame, std::size_t size);
+
+    Command command{Command::Kind::kWaitForEvent, kSouth, 0};
+    // A copy, so that the scripts can keep a reference to it.
+    Context context;
+    std::exception_ptr exception;
+  };
+  /**
+   * @brief Awaited for a command, suspending the script.
+   */
+  class CommandAwaiter {
+   public:
+    CommandAwaiter(Command const& command);
+    bool await_ready() const noexcept;
+    void await_suspend(std::coroutine_handle<promise_type> handle) const;
+    void await_resume() const noexcept;
+
+   private:
+    Command const command_;
+  };
+  /**
+   * @brief Awaited for the context, without suspending the script.
+   */
+  class ContextAwaiter {
+   public:
+    bool await_ready() const noexcept;
+    bool await_suspend(std::coroutine_handle<promise_type> handle);
+    Context const& await_resume() const;
+
+   private:
+    Context const* context_{nullptr};
+  };
+
+  Script(std::coroutine_handle<promise_type> handle);
+  Script(Script const& other) = delete;
+  Script(Script&& other) noexcept;
+  Script& operator=(Script const& other) = delete;
+  Script& operator=(Script&& other) = delete;
+  ~Script();
+  /**
+   * @brief Returns the current context, which stays up to date for the whole
+   * life of the script.
+   */
+  static ContextAwaiter context();
+  /**
+   * @brief Whether the script returned.
+   */
+  bool done() const;
+  /**
+   * @brief Walk to a tile which many characters head to, following its flow
+   * field (refer to FlowFieldCache).
+   *
+   * Over once the character stands at the top left of the goal, or when the
+   * goal cannot be reached from where it stands.
+   *
+   * @param goal Tile to reach.
+   */
+  static CommandAwaiter gather(TilePosition const& goal);
+  /**
+   * @brief Stay idle.
+   *
+   * @param num_ticks For how many ticks, at least one.
+   */
+  static CommandAwaiter idle(int64_t num_ticks);
+  /**
+   * @brief Run the script until its next command.
+   *
+   * @param context What the script can see of the world.
+   * @return Command const& The next command, meaningless if the script is
+   * done.
+   */
+  Command const& resume(Context const& context);
+  /**
+   * @brief Stay idle until the controller is woken up (refer to
+   * LevelSimulation::wake()).
+   */
+  static CommandAwaiter waitForEvent();
+  /**
+   * @brief Walk one step per tick.
+   *
+   * @param direction Towards where.
+   * @param num_ticks For how many ticks, at least one.
+   */
+  static CommandAwaiter walk(CardinalDirection direction, int64_t num_ticks);
+  /**
+   * @brief Walk to a tile along a path requested to the path request service
+   * (refer to PathRequestService).
+   *
+   * The character idles until the path is found. Over once the character
+   * stands at the top left of the goal, or when there is no path (anymore).
+   *
+   * @param goal Tile to reach.
+   */
+  static CommandAwaiter walkTo(TilePosition const& goal);
+
+ private:
+  std::coroutine_handle<promise_type> handle_;
+};
+
+#endif
@@ -0,0 +1,73 @@
+/*
+ * Copyright (C) 2021-2023 Jean-Marie BARAN (jeanmarie.baran@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Refer to 'COPYING.txt' for the full notice.
+ */
+
+#include <libflatkiss/logic/script_frame_allocator.hpp>
+#include <new>
+
+using std::byte;
+using std::lock_guard;
+using std::make_unique;
+using std::mutex;
+using std::size_t;
+
+void* ScriptFrameAllocator::allocate(size_t size) {
+  int64_t const pool_index{poolIndex(size)};
+  if (pool_index >= kNumPools) {
+    return ::operator new(size);
+  }
+
+  ScriptFrameAllocator& allocator{instance()};
+  lock_guard<mutex> const lock{allocator.mutex_};
+  FreeBlock*& free_blocks{allocator.free_blocks_[pool_index]};
+  if (free_blocks == nullptr) {
+    // Carve a new chunk into blocks of the size of the pool.
+    int64_t const block_size{(pool_index + 1) * kBlockSize};
+    allocator.chunks_.push_back(
+        make_unique<byte[]>(block_size * kBlocksPerChunk));
+    byte* const chunk{allocator.chunks_.back().get()};
+    for (int64_t i{kBlocksPerChunk - 1}; i >= 0; i--) {
+      free_blocks = new (chunk + i * block_size) FreeBlock{free_blocks};
+    }
+  }
+  FreeBlock* const block{free_blocks};
+  free_blocks = block->next;
+  return block;
+}
+
+void ScriptFrameAllocator::deallocate(void* frame, size_t size) {
+  int64_t const pool_index{poolIndex(size)};
+  if (pool_index >= kNumPools) {
+    ::operator delete(frame);
+    return;
+  }
+
+  ScriptFrameAllocator& allocator{instance()};
+  lock_guard<mutex> const lock{allocator.mutex_};
+  FreeBlock*& free_blocks{allocator.free_blocks_[pool_index]};
+  free_blocks = new (frame) FreeBlock{free_blocks};
+}
+
+ScriptFrameAllocator& ScriptFrameAllocator::instance() {
+  static ScriptFrameAllocator allocator;
+  return allocator;
+}
+
+int64_t ScriptFrameAllocator::poolIndex(size_t size) {
+  return (static_cast<int64_t>(size) + kBlockSize - 1) / kBlockSize - 1;
+}
@@ -0,0 +1,71 @@
+/*
+ * Copyright (C) 2021-2023 Jean-Marie BARAN (jeanmarie.baran@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Refer to 'COPYING.txt' for the full notice.
+ */
+
+#ifndef LIBFLATKISS_LOGIC_SCRIPT_FRAME_ALLOCATOR_HPP_INCLUDED
+#define LIBFLATKISS_LOGIC_SCRIPT_FRAME_ALLOCATOR_HPP_INCLUDED
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+/**
+ * @brief Allocates the frames of the scripts (refer to Script) from pools.
+ *
+ * Frame sizes are rounded up to a multiple of kBlockSize, and each size has
+ * its pool: blocks are carved from chunks of kBlocksPerChunk blocks, and the
+ * freed blocks are kept in a free list for the next frames of the same size.
+ * As all the scripts of a kind have frames of the same size, starting and
+ * ending scripts does not allocate once warmed up. Frames larger than the
+ * largest size come from the heap.
+ *
+ * The pools are shared by all the threads. Frames are only allocated and freed
+ * when controllers are created and destroyed, so the lock is not contended.
+ */
+class ScriptFrameAllocator {
+ public:
+  static void* allocate(std::size_t size);
+  static void deallocate(void* frame, std::size_t size);
+
+ private:
+  struct FreeBlock {
+    FreeBlock* next;
+  };
+
+  static int64_t constexpr kBlockSize{64};
+  static int64_t constexpr kBlocksPerChunk{64};
+  static int64_t constexpr kNumPools{16};
+
+  std::mutex mutex_;
+  std::array<FreeBlock*, kNumPools> free_blocks_{};
+  std::vector<std::unique_ptr<std::byte[]>> chunks_;
+
+  /**
+   * @brief Returns the allocator shared by all the scripts.
+   */
+  static ScriptFrameAllocator& instance();
+  /**
+   * @brief Returns the index of the pool of the frames of the given size.
+   */
+  static int64_t poolIndex(std::size_t size);
+};
+
+#endif
@@ -0,0 +1,253 @@
+/*
+ * Copyright (C) 2021-2023 Jean-Marie BARAN (jeanmarie.baran@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Refer to 'COPYING.txt' for the full notice.
+ */
+
+#include <algorithm>
+#include <cstdlib>
+#include <libflatkiss/logic/character_scripts.hpp>
+#include <libflatkiss/logic/scripted_character_controller.hpp>
+#include <memory>
+#include <utility>
+
+using std::abs;
+using std::max;
+using std::min;
+using std::move;
+using std::shared_ptr;
+
+ScriptedCharacterController::ScriptedCharacterController(
+    Character const& character, uint64_t seed)
+    : character_{character},
+      seed_{seed},
+      script_{CharacterScripts::create(character.behaviourIndex(), character,
+                                       seed, 0)} {}
+
+ScriptedCharacterController::ScriptedCharacterController(
+    ScriptedCharacterController const& other)
+    : character_{other.character_},
+      seed_{other.seed_},
+      num_commands_{other.num_commands_},
+      script_{CharacterScripts::create(other.character_.behaviourIndex(),
+                                       other.character_, other.seed_,
+                                       other.num_commands_)},
+      command_{other.command_},
+      step_{other.step_},
+      step_end_{other.step_end_},
+      clock_{other.clock_},
+      idle_after_move_{other.idle_after_move_},
+      path_request_{other.path_request_},
+      waypoints_{other.waypoints_},
+      next_waypoint_{other.next_waypoint_},
+      path_{other.path_},
+      next_tile_{other.next_tile_} {}
+
+Character const& ScriptedCharacterController::character() const {
+  return character_;
+}
+
+bool ScriptedCharacterController::nextStep(Position const& position,
+                                           TickContext const& context) {
+  switch (command_.kind) {
+    case Script::Command::Kind::kGather:
+      return nextStepTowardsGoal(position, context.level, context.flow_fields);
+    case Script::Command::Kind::kWalkTo:
+      return nextStepAlongPath(position, context.level, context.path_requests);
+    default:
+      return false;
+  }
+}
+
+bool ScriptedCharacterController::nextStepAlongPath(
+    Position const& position, Level const& level,
+    PathRequestService& path_requests) {
+  if (path_request_ != -1) {
+    if (path_requests.status(path_request_) ==
+        PathRequestService::Status::kPending) {
+      step_ = {Script::Command::Kind::kIdle, kSouth, 1};
+      return true;
+    }
+    bool const has_path{path_requests.takeWaypoints(path_request_, waypoints_)};
+    path_request_ = -1;
+    if (!has_path) {
+      return false;
+    }
+    next_waypoint_ = 0;
+    path_.clear();
+    next_tile_ = 0;
+  }
+
+  // Walk to the top left of each tile of the path in turn.
+  int64_t const tiles_width{level.spriteset().spritesWidth()};
+  int64_t const tiles_height{level.spriteset().spritesHeight()};
+  while (true) {
+    if (next_tile_ == path_.size()) {
+      if (next_waypoint_ == waypoints_.size()) {
+        return false;
+      }
+
+      // The path is refined up to the next waypoint only once reached.
+      path_.clear();
+      next_tile_ = 0;
+      if (next_waypoint_ == 0) {
+        path_.push_back(waypoints_.front());
+      } else if (!path_requests.pathFinder(character_.solid())
+                      .refine(waypoints_[next_waypoint_ - 1],
+                              waypoints_[next_waypoint_], path_)) {
+        // Tiles changed since the path was found.
+        return false;
+      }
+      next_waypoint_++;
+      // Successive waypoints can be the same tile.
+      continue;
+    }
+
+    TilePosition const& tile{path_[next_tile_]};
+    int64_t const delta_x{tile.x() * tiles_width - position.x()};
+    int64_t const delta_y{tile.y() * tiles_height - position.y()};
+    if (delta_x != 0) {
+      step_ = {Script::Command::Kind::kWalk, delta_x < 0 ? kWest : kEast,
+               abs(delta_x) / kSpeedInPixels};
+      return true;
+    }
+    if (delta_y != 0) {
+      step_ = {Script::Command::Kind::kWalk, delta_y < 0 ? kNorth : kSouth,
+               abs(delta_y) / kSpeedInPixels};
+      return true;
+    }
+    next_tile_++;
+  }
+}
+
+bool ScriptedCharacterController::nextStepTowardsGoal(
+    Position const& position, Level const& level, FlowFieldCache& flow_fields) {
+  int64_t const tiles_width{level.spriteset().spritesWidth()};
+  int64_t const tiles_height{level.spriteset().spritesHeight()};
+  int64_t const x{position.x() / tiles_width};
+  int64_t const y{position.y() / tiles_height};
+  shared_ptr<FlowField const> const flow_field{
+      flow_fields.flowField(character_.solid(), command_.goal)};
+  if (flow_field->distanceAt(x, y) < 0) {
+    return false;
+  }
+
+  // The field is followed from the top left of the tiles.
+  if (position.x() > x * tiles_width) {
+    step_ = {Script::Command::Kind::kWalk, kWest,
+             (position.x() - x * tiles_width) / kSpeedInPixels};
+    return true;
+  }
+  if (position.y() > y * tiles_height) {
+    step_ = {Script::Command::Kind::kWalk, kNorth,
+             (position.y() - y * tiles_height) / kSpeedInPixels};
+    return true;
+  }
+  CardinalDirection direction{kSouth};
+  if (!flow_field->directionAt(x, y, direction)) {
+    return false;
+  }
+  step_ = {Script::Command::Kind::kWalk, direction,
+           (direction == kWest || direction == kEast ? tiles_width
+                                                     : tiles_height) /
+               kSpeedInPixels};
+  return true;
+}
+
+int64_t ScriptedCharacterController::onTick(TickContext const& context) {
+  // At the start, or when woken up, the script carries on from now.
+  if (clock_ < 0 || command_.kind == Script::Command::Kind::kWaitForEvent) {
+    clock_ = context.tick;
+    step_end_ = context.tick;
+  }
+
+  int64_t delta_x{0};
+  int64_t delta_y{0};
+  while (clock_ <= context.tick && !script_.done()) {
+    if (clock_ >= step_end_) {
+      Position const position{character_.position() +
+                              Vector{delta_x, delta_y}};
+      if (!nextStep(position, context)) {
+        command_ = script_.resume(Script::Context{
+            context.clearance_map, clock_, Vector{delta_x, delta_y}});
+        num_commands_++;
+        if (script_.done() ||
+            command_.kind == Script::Command::Kind::kWaitForEvent) {
+          break;
+        }
+        step_ = command_;
+        if (command_.kind == Script::Command::Kind::kWalkTo) {
+          int64_t const start_x{position.x() /
+                                context.level.spriteset().spritesWidth()};
+          int64_t const start_y{position.y() /
+                                context.level.spriteset().spritesHeight()};
+          path_request_ = context.path_requests.enqueue(
+              character_.solid(), TilePosition{start_x, start_y},
+              command_.goal, kPathPriority, context.tick);
+        }
+        // A goal already reached (or out of reach) still takes one tick.
+        if ((command_.kind == Script::Command::Kind::kGather ||
+             command_.kind == Script::Command::Kind::kWalkTo) &&
+            !nextStep(position, context)) {
+          step_ = {Script::Command::Kind::kIdle, kSouth, 1};
+        }
+      }
+      step_end_ = clock_ + max<int64_t>(1, step_.num_ticks);
+    }
+
+    if (step_.kind == Script::Command::Kind::kWalk) {
+      int64_t const num_steps{min(context.tick + 1, step_end_) - clock_};
+      delta_x += num_steps * kSpeedInPixels *
+                 (step_.direction == kWest
+                      ? -1
+                      : (step_.direction == kEast ? 1 : 0));
+      delta_y += num_steps * kSpeedInPixels *
+                 (step_.direction == kNorth
+                      ? -1
+                      : (step_.direction == kSouth ? 1 : 0));
+      clock_ += num_steps;
+    } else {
+      clock_ = step_end_;
+    }
+  }
+
+  bool const is_asleep{script_.done() ||
+                       command_.kind ==
+                           Script::Command::Kind::kWaitForEvent};
+  bool const is_idle{is_asleep || step_.kind == Script::Command::Kind::kIdle};
+  if (delta_x != 0 || delta_y != 0) {
+    idle_after_move_ = is_idle;
+    context.move_batch.submit(*this, character_.solid(),
+                              character_.position(), Vector{delta_x, delta_y},
+                              0, kSpeedInPixels, true);
+  } else if (is_idle) {
+    // Reset the animation as the character is not moving anymore.
+    character_.updateFacingDirection(Vector::kZero, Vector::kZero);
+  }
+  return is_asleep ? kWakeOnEvent : clock_;
+}
+
+void ScriptedCharacterController::onMoved(
+    Navigator::MoveIntent const& intent, Navigator::MoveResult const& result) {
+  Position final_position{result.position};
+  character_.updateFacingDirection(intent.desired_displacement,
+                                   final_position - character_.position());
+  character_.moveTo(move(final_position));
+  if (idle_after_move_) {
+    character_.updateFacingDirection(Vector::kZero, Vector::kZero);
+    idle_after_move_ = false;
+  }
+}
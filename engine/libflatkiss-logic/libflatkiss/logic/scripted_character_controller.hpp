@@ -0,0 +1,114 @@
+/*
+ * Copyright (C) 2021-2023 Jean-Marie BARAN (jeanmarie.baran@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Refer to 'COPYING.txt' for the full notice.
+ */
+
+#ifndef LIBFLATKISS_LOGIC_SCRIPTED_CHARACTER_CONTROLLER_HPP_INCLUDED
+#define LIBFLATKISS_LOGIC_SCRIPTED_CHARACTER_CONTROLLER_HPP_INCLUDED
+
+#include <libflatkiss/logic/character_controller.hpp>
+#include <libflatkiss/logic/navigator.hpp>
+#include <libflatkiss/logic/script.hpp>
+#include <libflatkiss/media/media.hpp>
+#include <libflatkiss/model/model.hpp>
+#include <vector>
+
+/**
+ * @brief Character controller which runs the script of its character.
+ *
+ * The script (refer to CharacterScripts) is resumed each time its command is
+ * over. Until then, the controller carries the command out on its own: it
+ * walks the character at each tick, or sleeps until the end of an idle time
+ * or until it is woken up, costing nothing. A command leading to a goal is
+ * carried out as walks from tile to tile.
+ *
+ * When the controller is called late, it runs through all the ticks it missed
+ * (resuming the script as many times as needed), and the steps of these ticks
+ * are made as one move.
+ *
+ * A copy (e.g. for a snapshot) runs a new script, created to carry on from the
+ * next command of the script of the original (refer to CharacterScripts).
+ */
+class ScriptedCharacterController final : public CharacterController {
+ public:
+  /**
+   * @param character The character to control.
+   * @param seed Seed of the random values drawn by the script.
+   */
+  ScriptedCharacterController(Character const& character, uint64_t seed);
+  ScriptedCharacterController(ScriptedCharacterController const& other);
+  ScriptedCharacterController(ScriptedCharacterController&& other) = default;
+  ScriptedCharacterController& operator=(
+      ScriptedCharacterController const& other) = delete;
+  ScriptedCharacterController& operator=(ScriptedCharacterController&& other) =
+      delete;
+  Character const& character() const override;
+  int64_t onTick(TickContext const& context) override;
+  void onMoved(Navigator::MoveIntent const& intent,
+               Navigator::MoveResult const& result) override;
+
+  static ControllerType constexpr kType{ControllerType::kScriptedController};
+
+ private:
+  Character character_;
+  uint64_t const seed_;
+  // Number of commands the script issued, to create it again when copied.
+  int64_t num_commands_{0};
+  Script script_;
+  Script::Command command_{Script::Command::Kind::kIdle, kSouth, 0};
+  // Part of the command being carried out, a walk or an idle time.
+  Script::Command step_{Script::Command::Kind::kIdle, kSouth, 0};
+  // Tick at which the current step is over.
+  int64_t step_end_{0};
+  // Tick up to which the command was carried out, or -1 before the start.
+  int64_t clock_{-1};
+  // Whether the last move submitted is followed by idle time.
+  bool idle_after_move_{false};
+  // Handle of the path requested for the current command, or -1.
+  int64_t path_request_{-1};
+  // Waypoints of the path, and the next one to refine the path to.
+  std::vector<TilePosition> waypoints_;
+  int64_t next_waypoint_{0};
+  // Tiles up to the last waypoint refined, and the next one to walk to.
+  std::vector<TilePosition> path_;
+  int64_t next_tile_{0};
+  // Priority of the path requests (refer to PathRequestService::enqueue()).
+  static int64_t constexpr kPathPriority{0};
+  static int64_t constexpr kSpeedInPixels{1};
+
+  /**
+   * @brief Find the next step of the current command.
+   *
+   * @param position Where the character stands once its pending steps are
+   * made.
+   * @return bool False if the command is over. Walks and idle times are a
+   * single step, taken when they start.
+   */
+  bool nextStep(Position const& position, TickContext const& context);
+  /**
+   * @brief Find the next step of a walk along the path of the request.
+   */
+  bool nextStepAlongPath(Position const& position, Level const& level,
+                         PathRequestService& path_requests);
+  /**
+   * @brief Find the next step of a gathering, following the flow field.
+   */
+  bool nextStepTowardsGoal(Position const& position, Level const& level,
+                           FlowFieldCache& flow_fields);
+};
+
+#endif
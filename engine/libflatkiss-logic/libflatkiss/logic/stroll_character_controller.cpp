@@ -17,66 +17,103 @@
  * Refer to 'COPYING.txt' for the full notice.
  */
 
-#include <functional>
+#include <algorithm>
+#include <array>
+#include <libflatkiss/logic/random_stream.hpp>
 #include <libflatkiss/logic/stroll_character_controller.hpp>
-#include <random>
 #include <utility>
 
-using std::bind;
-using std::default_random_engine;
+using std::array;
+using std::max;
+using std::min;
 using std::move;
-using std::uniform_int_distribution;
 
-StrollCharacterController::StrollCharacterController(Character& character)
-    : character_{character} {}
+StrollCharacterController::StrollCharacterController(
+    Character const& character, uint64_t seed)
+    : character_{character}, seed_{seed} {}
 
 Character const& StrollCharacterController::character() const {
   return character_;
 }
 
-void StrollCharacterController::onTick(int64_t tick,
-                                       EventHandler const& event_handler,
-                                       Navigator const& navigator,
-                                       Level const& level) {
-  // At the beginning of a new cycle, decide on a random direction.
-  if (tick % (kIdleTimeInTicks + kWalkTimeInTicks) == 0) {
-    switch (randomValue(1, 4)) {
-      case 1:
-        current_direction_ = kSouth;
-        break;
-      case 2:
-        current_direction_ = kNorth;
-        break;
-      case 3:
-        current_direction_ = kWest;
-        break;
-      case 4:
-        current_direction_ = kEast;
-        break;
+int64_t StrollCharacterController::onTick(TickContext const& context) {
+  int64_t const cycle_duration{kIdleTimeInTicks + kWalkTimeInTicks};
+  int64_t const cycle_start{context.tick - context.tick % cycle_duration};
+
+  /* At the beginning of a new cycle, decide on a random direction. Directions
+   * in which the character would not fit after its first step are skipped,
+   * unless there is none left (then the navigator deals with it). The draw
+   * only depends on the character and on the cycle, not on when the controller
+   * happens to be called. */
+  if (cycle_start > last_tick_) {
+    array<CardinalDirection, 4> constexpr kDirections{kSouth, kNorth, kWest,
+                                                      kEast};
+    array<CardinalDirection, 4> candidates{kDirections};
+    int64_t num_candidates{0};
+    for (CardinalDirection direction : kDirections) {
+      if (context.clearance_map.fits(
+              character_.solid().boundingBox(),
+              character_.position() + movementTowards(direction))) {
+        candidates[num_candidates++] = direction;
+      }
+    }
+    if (num_candidates == 0) {
+      candidates = kDirections;
+      num_candidates = kDirections.size();
     }
+    RandomStream random_stream{
+        seed_,
+        (static_cast<uint64_t>(character_.index()) << 32U) |
+            character_.generation(),
+        static_cast<uint64_t>(cycle_start)};
+    current_direction_ =
+        candidates[random_stream.between(0, num_candidates - 1)];
   }
 
-  Vector movement{
-      current_direction_ == kWest ? -1 : (current_direction_ == kEast ? 1 : 0),
-      current_direction_ == kNorth ? -1
-                                   : (current_direction_ == kSouth ? 1 : 0)};
+  /* Walk one step per walking tick of the cycle since the last call. There is
+   * more than one when the controller was called late, in which case the walk
+   * may be over already. */
+  int64_t const walk_end{cycle_start + kWalkTimeInTicks};
+  int64_t const num_steps{max<int64_t>(
+      0, min(context.tick + 1, walk_end) - max(last_tick_ + 1, cycle_start))};
+  bool const is_walking{context.tick < walk_end};
+  last_tick_ = context.tick;
+
+  if (num_steps > 0) {
+    Vector const movement{movementTowards(current_direction_)};
+    idle_after_move_ = !is_walking;
+    context.move_batch.submit(
+        *this, character_.solid(), character_.position(),
+        Vector{movement.dx() * num_steps, movement.dy() * num_steps}, 0,
+        kSpeedInPixels, true);
+  }
+  if (is_walking) {
+    return context.tick + 1;
+  }
+
+  /* Idle time. Reset the animation as the character is not moving anymore
+   * (once moved, if it still has to), then sleep until the beginning of the
+   * next cycle. */
+  if (num_steps == 0) {
+    character_.updateFacingDirection(Vector::kZero, Vector::kZero);
+  }
+  return cycle_start + cycle_duration;
+}
 
-  if (tick % (kIdleTimeInTicks + kWalkTimeInTicks) < kWalkTimeInTicks) {
-    // Walking time.
-    auto [_, final_position]{navigator.moveBy(character_.positionedSolid(),
-                                              movement, level, 0,
-                                              kSpeedInPixels, true)};
-    character_.updateFacingDirection(movement,
-                                     final_position - character_.position());
-    character_.moveTo(move(final_position));
-  } else {
-    // Idle time. Reset the animation when the character is not moving.
+void StrollCharacterController::onMoved(Navigator::MoveIntent const& intent,
+                                        Navigator::MoveResult const& result) {
+  Position final_position{result.position};
+  character_.updateFacingDirection(intent.desired_displacement,
+                                   final_position - character_.position());
+  character_.moveTo(move(final_position));
+  if (idle_after_move_) {
     character_.updateFacingDirection(Vector::kZero, Vector::kZero);
+    idle_after_move_ = false;
   }
 }
 
-int64_t StrollCharacterController::randomValue(int64_t lower, int64_t upper) {
-  static auto gen = bind(uniform_int_distribution<int64_t>(lower, upper),
-                         default_random_engine());
-  return gen();
+Vector StrollCharacterController::movementTowards(
+    CardinalDirection direction) {
+  return Vector{direction == kWest ? -1 : (direction == kEast ? 1 : 0),
+                direction == kNorth ? -1 : (direction == kSouth ? 1 : 0)};
 }
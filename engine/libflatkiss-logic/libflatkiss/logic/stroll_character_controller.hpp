@@ -33,28 +33,35 @@
  * A character controlled by this controller stays iddle and from time to time
  * choose a random direction and walks a few steps.
  */
-class StrollCharacterController : public CharacterController {
+class StrollCharacterController final : public CharacterController {
  public:
-  StrollCharacterController(Character& character);
-  Character const& character() const;
-  void onTick(int64_t tick, EventHandler const& event_handler,
-              Navigator const& navigator, Level const& level);
+  /**
+   * @param character The character to control.
+   * @param seed Seed of the random directions.
+   */
+  StrollCharacterController(Character const& character, uint64_t seed);
+  Character const& character() const override;
+  int64_t onTick(TickContext const& context) override;
+  void onMoved(Navigator::MoveIntent const& intent,
+               Navigator::MoveResult const& result) override;
+
+  static ControllerType constexpr kType{ControllerType::kStrollController};
 
  private:
-  Character& character_;
+  Character character_;
   CardinalDirection current_direction_{kSouth};
+  int64_t last_tick_{0};
+  // Whether the last move submitted is the end of a walk.
+  bool idle_after_move_{false};
+  uint64_t const seed_;
   static int64_t constexpr kIdleTimeInTicks{250};
   static int64_t constexpr kSpeedInPixels{1};
   static int64_t constexpr kWalkTimeInTicks{35};
 
   /**
-   * @brief Returns a value between [lower, upper].
-   *
-   * @param lower Minimum possible value.
-   * @param upper Maximum possible value.
-   * @return int64_t A value in the interval [lower, upper], inclusive.
+   * @brief Returns the displacement of one step in the given direction.
    */
-  static int64_t randomValue(int64_t lower, int64_t upper);
+  static Vector movementTowards(CardinalDirection direction);
 };
 
 #endif
@@ -0,0 +1,49 @@
+/*
+ * Copyright (C) 2021-2023 Jean-Marie BARAN (jeanmarie.baran@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Refer to 'COPYING.txt' for the full notice.
+ */
+
+#ifndef LIBFLATKISS_LOGIC_TICK_CONTEXT_HPP_INCLUDED
+#define LIBFLATKISS_LOGIC_TICK_CONTEXT_HPP_INCLUDED
+
+#include <cstdint>
+#include <libflatkiss/logic/clearance_map.hpp>
+#include <libflatkiss/logic/flow_field_cache.hpp>
+#include <libflatkiss/logic/move_batch.hpp>
+#include <libflatkiss/logic/path_request_service.hpp>
+#include <libflatkiss/media/media.hpp>
+#include <libflatkiss/model/model.hpp>
+
+/**
+ * @brief What the controllers of a level are given at each tick (refer to
+ * CharacterController::onTick()).
+ *
+ * The services belong to the level simulation, which gathers them once per
+ * tick rather than passing each of them to every controller.
+ */
+struct TickContext {
+  int64_t tick;
+  EventHandler const& event_handler;
+  // Where the moves are submitted.
+  MoveBatch& move_batch;
+  Level const& level;
+  ClearanceMap const& clearance_map;
+  FlowFieldCache& flow_fields;
+  PathRequestService& path_requests;
+};
+
+#endif
@@ -0,0 +1,111 @@
+/*
+ * Copyright (C) 2021-2023 Jean-Marie BARAN (jeanmarie.baran@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Refer to 'COPYING.txt' for the full notice.
+ */
+
+#include <algorithm>
+#include <libflatkiss/logic/collider.hpp>
+#include <libflatkiss/logic/tile_solids.hpp>
+
+using std::max;
+using std::min;
+using std::unordered_map;
+using std::vector;
+
+TileSolids::TileSolids(Level const& level,
+                       unordered_map<int64_t, Solid const> const& solids)
+    : level_{level},
+      tiles_width_{level.spriteset().spritesWidth()},
+      tiles_height_{level.spriteset().spritesHeight()},
+      solids_per_tile_index_{resolve(level.tileSolidMapper(), solids)} {}
+
+bool TileSolids::collide(Solid const& solid, Position const& position) const {
+  TileRange const tile_range{tileRange(solid, position, position)};
+
+  /* Disabling lint for short variables names because they are useful for
+   * math-related things (x, y, ...). */
+  // NOLINTBEGIN(readability-identifier-length)
+  for (int64_t y{tile_range.first_y}; y <= tile_range.last_y; y++) {
+    for (int64_t x{tile_range.first_x}; x <= tile_range.last_x; x++) {
+      Solid const* tile_solid{solidAt(x, y)};
+      if (tile_solid != nullptr &&
+          Collider::collide(solid, position, *tile_solid,
+                            Position{x * tiles_width_, y * tiles_height_})) {
+        return true;
+      }
+    }
+  }
+  // NOLINTEND(readability-identifier-length)
+
+  return false;
+}
+
+// NOLINTBEGIN(readability-identifier-length)
+bool TileSolids::hasSolid(TileRange const& tile_range) const {
+  for (int64_t y{tile_range.first_y}; y <= tile_range.last_y; y++) {
+    for (int64_t x{tile_range.first_x}; x <= tile_range.last_x; x++) {
+      if (solidAt(x, y) != nullptr) {
+        return true;
+      }
+    }
+  }
+
+  return false;
+}
+// NOLINTEND(readability-identifier-length)
+
+Level const& TileSolids::level() const { return level_; }
+
+vector<Solid const*> TileSolids::resolve(
+    TileSolidMapper const& tile_solid_mapper,
+    unordered_map<int64_t, Solid const> const& solids) {
+  int64_t max_tile_index{-1};
+  for (auto const& [tile_index, _] : tile_solid_mapper.tilesToSolids()) {
+    max_tile_index = max(max_tile_index, static_cast<int64_t>(tile_index));
+  }
+
+  vector<Solid const*> solids_per_tile_index(max_tile_index + 1, nullptr);
+  for (auto const& [tile_index, solid_index] :
+       tile_solid_mapper.tilesToSolids()) {
+    solids_per_tile_index[tile_index] = &solids.at(solid_index);
+  }
+
+  return solids_per_tile_index;
+}
+
+Solid const* TileSolids::solidAt(int64_t x, int64_t y) const {
+  uint16_t const tile_index{level_.tileIndex(x, y)};
+  if (tile_index >= solids_per_tile_index_.size()) {
+    return nullptr;
+  }
+
+  return solids_per_tile_index_[tile_index];
+}
+
+TileSolids::TileRange TileSolids::tileRange(Solid const& solid,
+                                            Position const& first,
+                                            Position const& last) const {
+  PositionedRectangle const& bounding_box{solid.boundingBox()};
+  int64_t const left{min(first.x(), last.x()) + bounding_box.x()};
+  int64_t const top{min(first.y(), last.y()) + bounding_box.y()};
+  int64_t const right{max(first.x(), last.x()) + bounding_box.x() +
+                      bounding_box.width() - 1};
+  int64_t const bottom{max(first.y(), last.y()) + bounding_box.y() +
+                       bounding_box.height() - 1};
+  return {left / tiles_width_, top / tiles_height_, right / tiles_width_,
+          bottom / tiles_height_};
+}
@@ -0,0 +1,98 @@
+/*
+ * Copyright (C) 2021-2023 Jean-Marie BARAN (jeanmarie.baran@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Refer to 'COPYING.txt' for the full notice.
+ */
+
+#ifndef LIBFLATKISS_LOGIC_TILE_SOLIDS_HPP_INCLUDED
+#define LIBFLATKISS_LOGIC_TILE_SOLIDS_HPP_INCLUDED
+
+#include <libflatkiss/model/model.hpp>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief Resolves the solids of the tiles of a level.
+ *
+ * Looking up the solid of a tile normally goes through two hash maps (tile
+ * index to solid index, then solid index to solid). This class does it once
+ * for all the tile indices of the level, so that afterwards finding the solid
+ * of a tile is a simple array access. It is meant to be built once and reused
+ * for many collision checks against the same level (e.g. for all the moves of
+ * a tick).
+ */
+class TileSolids {
+ public:
+  /**
+   * @brief Tiles from (first_x, first_y) to (last_x, last_y), both included.
+   */
+  struct TileRange {
+    int64_t first_x;
+    int64_t first_y;
+    int64_t last_x;
+    int64_t last_y;
+  };
+
+  TileSolids(Level const& level,
+             std::unordered_map<int64_t, Solid const> const& solids);
+  /**
+   * @brief Whether the solid at the given position collides with the tiles of
+   * the level.
+   *
+   * @param solid Solid to check.
+   * @param position Position of the solid in pixels.
+   * @return bool Whether there is a collision.
+   */
+  bool collide(Solid const& solid, Position const& position) const;
+  /**
+   * @brief Whether any of the tiles of the range has a solid.
+   */
+  bool hasSolid(TileRange const& tile_range) const;
+  Level const& level() const;
+  /**
+   * @brief Returns the solid of the tile at the given location.
+   *
+   * @param x Location of the tile along the horizontal axis, in tiles.
+   * @param y Location of the tile along the vertical axis, in tiles.
+   * @return Solid const* The solid of the tile, or nullptr if the tile never
+   * collides.
+   */
+  Solid const* solidAt(int64_t x, int64_t y) const;
+  /**
+   * @brief Returns the tiles covered by the bounding box of a solid anywhere
+   * between two positions.
+   *
+   * @param solid Solid to cover.
+   * @param first First position of the solid in pixels.
+   * @param last Last position of the solid in pixels.
+   * @return TileRange The tiles covered.
+   */
+  TileRange tileRange(Solid const& solid, Position const& first,
+                      Position const& last) const;
+
+ private:
+  Level const& level_;
+  int64_t const tiles_width_;
+  int64_t const tiles_height_;
+  // Indexed by tile index, nullptr when the tile has no solid.
+  std::vector<Solid const*> const solids_per_tile_index_;
+
+  static std::vector<Solid const*> resolve(
+      TileSolidMapper const& tile_solid_mapper,
+      std::unordered_map<int64_t, Solid const> const& solids);
+};
+
+#endif
@@ -0,0 +1,108 @@
+/*
+ * Copyright (C) 2021-2023 Jean-Marie BARAN (jeanmarie.baran@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Refer to 'COPYING.txt' for the full notice.
+ */
+
+#include <libflatkiss/logic/timer_wheel.hpp>
+#include <stdexcept>
+
+using std::invalid_argument;
+using std::vector;
+
+void TimerWheel::advance(vector<int64_t>& due) {
+  current_tick_++;
+
+  // Past the last wheel, the overflowing timers may fit again.
+  if ((current_tick_ & ((int64_t{1} << (kSlotBits * kWheels)) - 1)) == 0) {
+    cascade(overflow_);
+  }
+
+  /* Entering a new block at some wheel means entering a new block at all the
+   * wheels below it too. Spread the timers from the highest wheel down, so that
+   * timers landing in a slot about to be spread are spread again. */
+  int64_t highest_wheel{0};
+  while (highest_wheel < kWheels - 1 &&
+         (current_tick_ &
+          ((int64_t{1} << (kSlotBits * (highest_wheel + 1))) - 1)) == 0) {
+    highest_wheel++;
+  }
+  for (int64_t wheel{highest_wheel}; wheel > 0; wheel--) {
+    cascade(wheels_[wheel]
+                   [(current_tick_ >> (kSlotBits * wheel)) & (kSlots - 1)]);
+  }
+
+  vector<Timer>& slot{wheels_[0][current_tick_ & (kSlots - 1)]};
+  for (Timer const& timer : slot) {
+    due.push_back(timer.id);
+  }
+  size_ -= static_cast<int64_t>(slot.size());
+  slot.clear();
+}
+
+void TimerWheel::cascade(vector<Timer>& timers) {
+  cascading_.swap(timers);
+  for (Timer const& timer : cascading_) {
+    place(timer);
+  }
+  cascading_.clear();
+}
+
+int64_t TimerWheel::currentTick() const { return current_tick_; }
+
+int64_t TimerWheel::idleTicks() const {
+  int64_t const block_end{current_tick_ | (kSlots - 1)};
+  int64_t tick{current_tick_ + 1};
+  while (tick <= block_end && wheels_[0][tick & (kSlots - 1)].empty()) {
+    tick++;
+  }
+  return tick - current_tick_ - 1;
+}
+
+void TimerWheel::place(Timer const& timer) {
+  /* The timer goes in the lowest wheel whose current block contains its tick
+   * (for instance, the first wheel if the tick is in the current block of 256
+   * ticks). */
+  for (int64_t wheel{0}; wheel < kWheels; wheel++) {
+    int64_t const block_bits{kSlotBits * (wheel + 1)};
+    if ((timer.tick >> block_bits) == (current_tick_ >> block_bits)) {
+      wheels_[wheel][(timer.tick >> (kSlotBits * wheel)) & (kSlots - 1)]
+          .push_back(timer);
+      return;
+    }
+  }
+
+  overflow_.push_back(timer);
+}
+
+void TimerWheel::schedule(int64_t id, int64_t tick) {
+  if (tick <= current_tick_) {
+    throw invalid_argument("A timer must be scheduled after the current tick");
+  }
+
+  place(Timer{id, tick});
+  size_++;
+}
+
+int64_t TimerWheel::size() const { return size_; }
+
+void TimerWheel::skip(int64_t num_ticks) {
+  if (num_ticks < 0 || ((current_tick_ + num_ticks) >> kSlotBits) !=
+                           (current_tick_ >> kSlotBits)) {
+    throw invalid_argument("Cannot skip past the current block of ticks");
+  }
+  current_tick_ += num_ticks;
+}
@@ -0,0 +1,98 @@
+/*
+ * Copyright (C) 2021-2023 Jean-Marie BARAN (jeanmarie.baran@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Refer to 'COPYING.txt' for the full notice.
+ */
+
+#ifndef LIBFLATKISS_LOGIC_TIMER_WHEEL_HPP_INCLUDED
+#define LIBFLATKISS_LOGIC_TIMER_WHEEL_HPP_INCLUDED
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Keeps track of what must happen at which tick, cheaply.
+ *
+ * A hierarchical timer wheel: the first wheel has one slot for each of the
+ * next 256 ticks, the second one a slot for each of the next 256 blocks of 256
+ * ticks, and so on. A timer goes in the wheel matching how far it is. When the
+ * current tick enters a new block, the timers of the matching slot of the upper
+ * wheel are spread into the lower wheels. Scheduling a timer and advancing by
+ * one tick are therefore done in constant time (amortized), however many
+ * timers are pending. Timers further than 2^32 ticks wait in an overflow list.
+ */
+class TimerWheel {
+ public:
+  /**
+   * @brief Returns the tick the wheel is at, zero at first.
+   */
+  int64_t currentTick() const;
+  /**
+   * @brief Advance the wheel by one tick.
+   *
+   * @param due Receives (appended) the identifiers of the timers scheduled at
+   * the new current tick, in no particular order.
+   */
+  void advance(std::vector<int64_t>& due);
+  /**
+   * @brief Returns how many ticks after the current one can be skipped, as no
+   * timer is due at any of them.
+   *
+   * Only looks up to the end of the current block of the first wheel, where
+   * the timers of the upper wheels must be spread by advance().
+   */
+  int64_t idleTicks() const;
+  /**
+   * @brief Returns the number of pending timers.
+   */
+  int64_t size() const;
+  /**
+   * @brief Advance the wheel by several ticks at once.
+   *
+   * @param num_ticks Number of ticks, at most idleTicks().
+   */
+  void skip(int64_t num_ticks);
+  /**
+   * @brief Schedule a timer.
+   *
+   * @param id Identifier given back when the timer is due.
+   * @param tick Tick at which the timer is due, must be after the current one.
+   */
+  void schedule(int64_t id, int64_t tick);
+
+ private:
+  struct Timer {
+    int64_t id;
+    int64_t tick;
+  };
+
+  static int64_t constexpr kSlotBits{8};
+  static int64_t constexpr kSlots{1 << kSlotBits};
+  static int64_t constexpr kWheels{4};
+
+  std::array<std::array<std::vector<Timer>, kSlots>, kWheels> wheels_;
+  std::vector<Timer> overflow_;
+  // Timers being moved to lower wheels.
+  std::vector<Timer> cascading_;
+  int64_t current_tick_{0};
+  int64_t size_{0};
+
+  void cascade(std::vector<Timer>& timers);
+  void place(Timer const& timer);
+};
+
+#endif
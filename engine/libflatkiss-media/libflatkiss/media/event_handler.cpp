@@ -34,8 +34,14 @@ void EventHandler::handleEvents() {
 
 bool EventHandler::isKeyPressed(Key key) const { return keys_state_[key]; }
 
+void EventHandler::isKeyPressed(Key key, bool is_pressed) {
+  keys_state_[key] = is_pressed;
+}
+
 bool EventHandler::mustQuit() const { return must_quit_; }
 
+void EventHandler::mustQuit(bool must_quit) { must_quit_ = must_quit; }
+
 void EventHandler::updateKeysState(SDL_Event const& event) {
   SDL_Scancode key{event.key.keysym.scancode};
   bool pressed{event.key.state == SDL_PRESSED};
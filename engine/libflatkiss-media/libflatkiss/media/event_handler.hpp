@@ -28,9 +28,17 @@ union SDL_Event;
 
 class EventHandler {
  public:
+  /**
+   * @brief Update the state of the keys from the pending user events.
+   */
   void handleEvents();
   bool isKeyPressed(Key key) const;
+  /**
+   * @brief Set the state of a key, in place of the user (e.g. on replay).
+   */
+  void isKeyPressed(Key key, bool is_pressed);
   bool mustQuit() const;
+  void mustQuit(bool must_quit);
 
  private:
   std::vector<bool> keys_state_{std::vector<bool>(Key::kMax)};
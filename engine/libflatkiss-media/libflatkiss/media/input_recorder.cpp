@@ -0,0 +1,65 @@
+/*
+ * Copyright (C) 2021-2023 Jean-Marie BARAN (jeanmarie.baran@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Refer to 'COPYING.txt' for the full notice.
+ */
+
+#include <ios>
+#include <libflatkiss/media/input_recorder.hpp>
+#include <libflatkiss/media/key.hpp>
+
+using std::ios;
+using std::string;
+
+InputRecorder::InputRecorder(string const& path)
+    : stream_{path, ios::binary | ios::trunc} {
+  if (!stream_.is_open()) {
+    throw ios::failure("Failed to open file: " + path);
+  }
+  static_assert(Key::kMax < 8, "The keys must fit in one byte with quit");
+}
+
+void InputRecorder::record(EventHandler const& event_handler) {
+  uint8_t const state{stateOf(event_handler)};
+  if (state != state_) {
+    uint64_t delta{static_cast<uint64_t>(ticks_ - last_record_tick_)};
+    uint8_t constexpr kLowBits{0x7F};
+    uint8_t constexpr kMoreBytesBit{0x80};
+    uint64_t constexpr kBitsPerByte{7};
+    while (delta > kLowBits) {
+      stream_.put(static_cast<char>((delta & kLowBits) | kMoreBytesBit));
+      delta >>= kBitsPerByte;
+    }
+    stream_.put(static_cast<char>(delta));
+    stream_.put(static_cast<char>(state));
+    if ((state & kQuitBit) != 0) {
+      stream_.flush();
+    }
+    state_ = state;
+    last_record_tick_ = ticks_;
+  }
+  ticks_++;
+}
+
+uint8_t InputRecorder::stateOf(EventHandler const& event_handler) {
+  uint8_t state{event_handler.mustQuit() ? kQuitBit : uint8_t{0}};
+  for (int key{0}; key < Key::kMax; key++) {
+    if (event_handler.isKeyPressed(static_cast<Key>(key))) {
+      state |= 1U << key;
+    }
+  }
+  return state;
+}
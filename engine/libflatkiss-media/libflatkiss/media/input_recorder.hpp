@@ -0,0 +1,69 @@
+/*
+ * Copyright (C) 2021-2023 Jean-Marie BARAN (jeanmarie.baran@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Refer to 'COPYING.txt' for the full notice.
+ */
+
+#ifndef LIBFLATKISS_MEDIA_INPUT_RECORDER_HPP_INCLUDED
+#define LIBFLATKISS_MEDIA_INPUT_RECORDER_HPP_INCLUDED
+
+#include <cstdint>
+#include <fstream>
+#include <libflatkiss/media/event_handler.hpp>
+#include <string>
+
+/**
+ * @brief Records the state of the keys at each tick into a file, to be
+ * replayed by InputReplayer.
+ *
+ * Only the changes are written: a record is the number of ticks since the
+ * previous record (as a variable-length integer, 7 bits per byte, least
+ * significant first, the high bit set on all bytes but the last), followed by
+ * the new state (one byte, one bit per key, the highest bit telling that the
+ * user quit). A session where the keys change a few times per second takes a
+ * few bytes per second.
+ */
+class InputRecorder {
+ public:
+  /**
+   * @param path Path of the file to write, overwritten.
+   */
+  InputRecorder(std::string const& path);
+  InputRecorder(InputRecorder const& other) = delete;
+  InputRecorder(InputRecorder&& other) = delete;
+  InputRecorder& operator=(InputRecorder const& other) = delete;
+  InputRecorder& operator=(InputRecorder&& other) = delete;
+  /**
+   * @brief Record the state of the keys, once per tick.
+   *
+   * @param event_handler The event handler, once it handled the events of the
+   * tick.
+   */
+  void record(EventHandler const& event_handler);
+
+  // Bit of the state telling that the user quit.
+  static uint8_t constexpr kQuitBit{0x80};
+
+ private:
+  std::ofstream stream_;
+  int64_t ticks_{0};
+  int64_t last_record_tick_{0};
+  uint8_t state_{0};
+
+  static uint8_t stateOf(EventHandler const& event_handler);
+};
+
+#endif
@@ -0,0 +1,80 @@
+/*
+ * Copyright (C) 2021-2023 Jean-Marie BARAN (jeanmarie.baran@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Refer to 'COPYING.txt' for the full notice.
+ */
+
+#include <fstream>
+#include <ios>
+#include <iterator>
+#include <libflatkiss/media/input_recorder.hpp>
+#include <libflatkiss/media/input_replayer.hpp>
+#include <libflatkiss/media/key.hpp>
+#include <stdexcept>
+
+using std::ifstream;
+using std::invalid_argument;
+using std::ios;
+using std::istreambuf_iterator;
+using std::string;
+using std::vector;
+
+InputReplayer::InputReplayer(string const& path) {
+  ifstream stream{path, ios::binary};
+  if (!stream.is_open()) {
+    throw ios::failure("Failed to open file: " + path);
+  }
+  vector<uint8_t> const bytes{istreambuf_iterator<char>{stream},
+                              istreambuf_iterator<char>{}};
+
+  uint8_t constexpr kLowBits{0x7F};
+  uint8_t constexpr kMoreBytesBit{0x80};
+  uint64_t constexpr kBitsPerByte{7};
+  int64_t tick{0};
+  auto byte{bytes.cbegin()};
+  while (byte != bytes.cend()) {
+    uint64_t delta{0};
+    uint64_t shift{0};
+    while (byte != bytes.cend() && (*byte & kMoreBytesBit) != 0) {
+      delta |= static_cast<uint64_t>(*byte++ & kLowBits) << shift;
+      shift += kBitsPerByte;
+    }
+    if (byte == bytes.cend() || byte + 1 == bytes.cend()) {
+      throw invalid_argument("Truncated input record in " + path);
+    }
+    delta |= static_cast<uint64_t>(*byte++) << shift;
+    tick += static_cast<int64_t>(delta);
+    records_.emplace_back(tick, *byte++);
+  }
+}
+
+bool InputReplayer::isOver() const { return next_record_ == records_.size(); }
+
+void InputReplayer::replay(EventHandler& event_handler) {
+  while (!isOver() && records_[next_record_].first <= ticks_) {
+    uint8_t const state{records_[next_record_].second};
+    for (int key{0}; key < Key::kMax; key++) {
+      event_handler.isKeyPressed(static_cast<Key>(key),
+                                 (state & (1U << key)) != 0);
+    }
+    event_handler.mustQuit((state & InputRecorder::kQuitBit) != 0);
+    next_record_++;
+  }
+  if (isOver()) {
+    event_handler.mustQuit(true);
+  }
+  ticks_++;
+}
@@ -0,0 +1,61 @@
+/*
+ * Copyright (C) 2021-2023 Jean-Marie BARAN (jeanmarie.baran@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Refer to 'COPYING.txt' for the full notice.
+ */
+
+#ifndef LIBFLATKISS_MEDIA_INPUT_REPLAYER_HPP_INCLUDED
+#define LIBFLATKISS_MEDIA_INPUT_REPLAYER_HPP_INCLUDED
+
+#include <cstdint>
+#include <libflatkiss/media/event_handler.hpp>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Replays the keys recorded by InputRecorder, in place of the user.
+ *
+ * Replayed with the same assets, configuration and seed, a recorded session
+ * runs exactly as it did, with or without a window.
+ */
+class InputReplayer {
+ public:
+  /**
+   * @param path Path of a file written by InputRecorder.
+   */
+  InputReplayer(std::string const& path);
+  /**
+   * @brief Whether all the records were replayed.
+   */
+  bool isOver() const;
+  /**
+   * @brief Set the state of the keys for the next tick, once per tick in place
+   * of EventHandler::handleEvents().
+   *
+   * Once the records are over (the user quit, or the recording was cut), the
+   * event handler is told to quit.
+   */
+  void replay(EventHandler& event_handler);
+
+ private:
+  // The tick of each record, and the state from this tick on.
+  std::vector<std::pair<int64_t, uint8_t>> records_;
+  int64_t next_record_{0};
+  int64_t ticks_{0};
+};
+
+#endif
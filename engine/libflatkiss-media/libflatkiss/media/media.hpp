@@ -21,9 +21,13 @@
 #define LIBFLATKISS_MEDIA_MEDIA_HPP_INCLUDED
 
 #include <libflatkiss/media/event_handler.hpp>
+#include <libflatkiss/media/input_recorder.hpp>
+#include <libflatkiss/media/input_replayer.hpp>
 #include <libflatkiss/media/key.hpp>
+#include <libflatkiss/media/quad_batch.hpp>
 #include <libflatkiss/media/renderer.hpp>
 #include <libflatkiss/media/texture_atlas.hpp>
+#include <libflatkiss/media/tile_layer_cache.hpp>
 #include <libflatkiss/media/window.hpp>
 
 #endif
@@ -0,0 +1,74 @@
+/*
+ * Copyright (C) 2021-2023 Jean-Marie BARAN (jeanmarie.baran@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Refer to 'COPYING.txt' for the full notice.
+ */
+
+#include <SDL2/SDL.h>
+
+#include <libflatkiss/media/quad_batch.hpp>
+
+QuadBatch::QuadBatch(SDL_Renderer* sdl_renderer)
+    : sdl_renderer_{sdl_renderer} {}
+
+QuadBatch::~QuadBatch() = default;
+
+void QuadBatch::add(SDL_Texture* texture, SDL_Rect const& source_rect,
+                    SDL_Rect const& dest_rect) {
+  if (texture != texture_) {
+    flush();
+    int width{0};
+    int height{0};
+    SDL_QueryTexture(texture, nullptr, nullptr, &width, &height);
+    texture_ = texture;
+    texture_width_ = width;
+    texture_height_ = height;
+  }
+
+  // Two triangles, top left / top right / bottom right / bottom left.
+  auto const first{static_cast<int>(vertices_.size())};
+  auto const left{static_cast<float>(dest_rect.x)};
+  auto const top{static_cast<float>(dest_rect.y)};
+  auto const right{static_cast<float>(dest_rect.x + dest_rect.w)};
+  auto const bottom{static_cast<float>(dest_rect.y + dest_rect.h)};
+  auto const u_left{static_cast<float>(source_rect.x) /
+                    static_cast<float>(texture_width_)};
+  auto const v_top{static_cast<float>(source_rect.y) /
+                   static_cast<float>(texture_height_)};
+  auto const u_right{static_cast<float>(source_rect.x + source_rect.w) /
+                     static_cast<float>(texture_width_)};
+  auto const v_bottom{static_cast<float>(source_rect.y + source_rect.h) /
+                      static_cast<float>(texture_height_)};
+  SDL_Color const white{255, 255, 255, 255};  // NOLINT(*-magic-numbers)
+  vertices_.push_back(SDL_Vertex{{left, top}, white, {u_left, v_top}});
+  vertices_.push_back(SDL_Vertex{{right, top}, white, {u_right, v_top}});
+  vertices_.push_back(SDL_Vertex{{right, bottom}, white, {u_right, v_bottom}});
+  vertices_.push_back(SDL_Vertex{{left, bottom}, white, {u_left, v_bottom}});
+  for (int index : {0, 1, 2, 0, 2, 3}) {
+    indices_.push_back(first + index);
+  }
+}
+
+void QuadBatch::flush() {
+  if (!indices_.empty()) {
+    SDL_RenderGeometry(sdl_renderer_, texture_, vertices_.data(),
+                       static_cast<int>(vertices_.size()), indices_.data(),
+                       static_cast<int>(indices_.size()));
+    vertices_.clear();
+    indices_.clear();
+  }
+  texture_ = nullptr;
+}
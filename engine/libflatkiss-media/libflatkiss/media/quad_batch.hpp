@@ -0,0 +1,77 @@
+/*
+ * Copyright (C) 2021-2023 Jean-Marie BARAN (jeanmarie.baran@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Refer to 'COPYING.txt' for the full notice.
+ */
+
+#ifndef LIBFLATKISS_MEDIA_QUAD_BATCH_HPP_INCLUDED
+#define LIBFLATKISS_MEDIA_QUAD_BATCH_HPP_INCLUDED
+
+#include <cstdint>
+#include <vector>
+
+// Forward declarations to avoid exposing SDL to the outside world.
+struct SDL_Rect;
+struct SDL_Renderer;
+struct SDL_Texture;
+struct SDL_Vertex;
+
+/**
+ * @brief Textured quads gathered to be drawn with as few calls as possible.
+ *
+ * The quads are accumulated in vertex and index buffers for as long as they
+ * come from the same texture, then drawn at once with SDL_RenderGeometry. The
+ * quads are drawn in the order they were added, so the callers sort them by
+ * texture wherever the order does not matter. The buffers are reused from one
+ * batch to the next.
+ */
+class QuadBatch {
+ public:
+  QuadBatch(SDL_Renderer* sdl_renderer);
+  QuadBatch(QuadBatch const& other) = delete;
+  QuadBatch(QuadBatch&& other) = delete;
+  QuadBatch& operator=(QuadBatch const& other) = delete;
+  QuadBatch& operator=(QuadBatch&& other) = delete;
+  ~QuadBatch();
+  /**
+   * @brief Add a quad, after drawing the pending ones if they come from
+   * another texture.
+   *
+   * @param texture Texture the quad is taken from.
+   * @param source_rect Part of the texture, in pixels.
+   * @param dest_rect Where the quad is drawn on the current target, in pixels.
+   */
+  void add(SDL_Texture* texture, SDL_Rect const& source_rect,
+           SDL_Rect const& dest_rect);
+  /**
+   * @brief Draw the pending quads.
+   *
+   * To be called before anything else is drawn, or before the target changes.
+   */
+  void flush();
+
+ private:
+  SDL_Renderer* const sdl_renderer_;
+  /* Texture of the pending quads, null if none. Forgotten once drawn, as it
+   * may be destroyed and another one created in its place. */
+  SDL_Texture* texture_{nullptr};
+  int64_t texture_width_{0};
+  int64_t texture_height_{0};
+  std::vector<SDL_Vertex> vertices_;
+  std::vector<int> indices_;
+};
+
+#endif
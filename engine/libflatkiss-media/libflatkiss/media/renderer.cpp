@@ -21,8 +21,14 @@
 
 #include <algorithm>
 #include <libflatkiss/media/renderer.hpp>
+#include <limits>
 #include <stdexcept>
+#include <utility>
 
+using std::max;
+using std::min;
+using std::numeric_limits;
+using std::pair;
 using std::runtime_error;
 using std::sort;
 using std::unordered_map;
@@ -31,13 +37,20 @@ using std::vector;
 Renderer::Renderer(SDL_Window* sdl_window)
     : sdl_renderer_{SDL_CreateRenderer(
           sdl_window, -1,
-          SDL_RENDERER_ACCELERATED | SDL_RENDERER_PRESENTVSYNC)} {
+          SDL_RENDERER_ACCELERATED | SDL_RENDERER_PRESENTVSYNC |
+              SDL_RENDERER_TARGETTEXTURE)},
+      quad_batch_{sdl_renderer_},
+      tile_layer_cache_{sdl_renderer_, kChunksCacheCapacity} {
   if (sdl_renderer_ == nullptr) {
     throw runtime_error("Failed to create SDL renderer");
   }
 }
 
-Renderer::~Renderer() { SDL_DestroyRenderer(sdl_renderer_); }
+Renderer::~Renderer() {
+  // The textures of the chunks go before their renderer.
+  tile_layer_cache_.clear();
+  SDL_DestroyRenderer(sdl_renderer_);
+}
 
 SDL_Texture* Renderer::createTextureFromSurface(SDL_Surface* surface) const {
   return SDL_CreateTextureFromSurface(sdl_renderer_, surface);
@@ -61,84 +74,257 @@ SDL_Rect Renderer::rectForSpriteIndex(int64_t sprite_index,
 
 void Renderer::render(Level const& level, PositionedRectangle const& viewport,
                       int64_t tick, TextureAtlas const& textures,
-                      vector<Character> const& characters) const {
+                      JobSystem& job_system) {
   SDL_RenderClear(sdl_renderer_);
   renderLevel(level, textures.textureForIndex(level.spriteset().textureIndex()),
               viewport, tick);
-  renderCharacters(viewport, characters, textures);
+  renderCharacters(viewport, level, textures, job_system);
+  quad_batch_.flush();
   SDL_RenderPresent(sdl_renderer_);
 }
 
 void Renderer::renderCharacter(PositionedRectangle const& viewport,
                                Texture const& characterset_texture,
-                               Character const& character) const {
-  SDL_Rect source_rect{
-      rectForSpriteIndex(character.spriteIndex(), character.spriteset())};
+                               Spriteset const& characterset,
+                               Position const& position,
+                               uint16_t sprite_index) {
+  SDL_Rect source_rect{rectForSpriteIndex(sprite_index, characterset)};
   SDL_Rect dest_rect;
-  dest_rect.x = static_cast<int>(character.x() - viewport.x());
-  dest_rect.y = static_cast<int>(character.y() - viewport.y());
-  dest_rect.w = static_cast<int>(character.spriteset().spritesWidth());
-  dest_rect.h = static_cast<int>(character.spriteset().spritesHeight());
+  dest_rect.x = static_cast<int>(position.x() - viewport.x());
+  dest_rect.y = static_cast<int>(position.y() - viewport.y());
+  dest_rect.w = static_cast<int>(characterset.spritesWidth());
+  dest_rect.h = static_cast<int>(characterset.spritesHeight());
 
-  SDL_RenderCopy(sdl_renderer_, characterset_texture.texture(), &source_rect,
-                 &dest_rect);
+  quad_batch_.add(characterset_texture.texture(), source_rect, dest_rect);
 }
 
 void Renderer::renderCharacters(
-    PositionedRectangle const& viewport, vector<Character> const& characters,
-    TextureAtlas const& charactersets_textures) const {
+    PositionedRectangle const& viewport, Level const& level,
+    TextureAtlas const& charactersets_textures, JobSystem& job_system) {
   /* The characters with the lower positions on the Y-axis must appear behind
-   * the others. Sort them using their Y-positions. However it is better not to
-   * modify the input vector (plus it is const). A copy could be made, but then
-   * sorting it would require Character to be copy-assignable (i.e. no const
-   * attributes), so that is not possible either. Instead create a vector of
-   * indices to the character, and sort that instead. Easy! See:
-   * https://stackoverflow.com/a/47537314 */
-
-  // Vector of indices.
+   * the others. Sort them using their Y-positions. Instead of moving the
+   * characters around, create a vector of indices to the characters, and sort
+   * that instead. See: https://stackoverflow.com/a/47537314 */
+  vector<Position> const& positions{level.characterPositions()};
+
+  /* Vector of indices, skipping the free slots and the characters out of the
+   * viewport. Crowded levels are gathered in parallel, one vector per part of
+   * the slots, then joined in order. */
+  int64_t const num_slots{static_cast<int64_t>(positions.size())};
+  vector<vector<int64_t>> parts(
+      (num_slots + kCharactersGrainSize - 1) / kCharactersGrainSize);
+  job_system.parallelFor(
+      0, static_cast<int64_t>(parts.size()), 1,
+      [&](int64_t first_part, int64_t last_part) {
+        for (int64_t part{first_part}; part < last_part; part++) {
+          int64_t const last{
+              min(num_slots, (part + 1) * kCharactersGrainSize)};
+          for (int64_t i{part * kCharactersGrainSize}; i < last; i++) {
+            if (!level.isCharacterAlive(i)) {
+              continue;
+            }
+            Spriteset const& characterset{
+                level.characterTemplate(i).spriteset()};
+            if (positions[i].x() + characterset.spritesWidth() > viewport.x() &&
+                positions[i].x() < viewport.x() + viewport.width() &&
+                positions[i].y() + characterset.spritesHeight() >
+                    viewport.y() &&
+                positions[i].y() < viewport.y() + viewport.height()) {
+              parts[part].push_back(i);
+            }
+          }
+        }
+      });
   vector<int64_t> character_indices;
-  for (int64_t i{0}; i < characters.size(); i++) {
-    character_indices.push_back(i);
+  for (vector<int64_t> const& part : parts) {
+    character_indices.insert(character_indices.end(), part.cbegin(),
+                             part.cend());
   }
 
-  // Sorted by Y-position.
+  /* Sorted by Y-position, then by texture so that the characters on the same
+   * row are drawn together (refer to QuadBatch). Further than that, the order
+   * of the textures cannot change without breaking that of the Y-positions. */
   sort(character_indices.begin(), character_indices.end(),
-       [characters](int64_t left, int64_t right) {
-         return characters[left].position().y() <
-                characters[right].position().y();
+       [&positions, &level](int64_t left, int64_t right) {
+         return pair{positions[left].y(),
+                     level.characterTemplate(left).spriteset().textureIndex()} <
+                pair{positions[right].y(),
+                     level.characterTemplate(right).spriteset().textureIndex()};
        });
 
   // Render the characters from top-most to bottom-most.
   for (int64_t character_index : character_indices) {
-    Character const& character = characters[character_index];
-    renderCharacter(viewport,
-                    charactersets_textures.textureForIndex(
-                        character.spriteset().textureIndex()),
-                    character);
+    Spriteset const& characterset{
+        level.characterTemplate(character_index).spriteset()};
+    renderCharacter(
+        viewport,
+        charactersets_textures.textureForIndex(characterset.textureIndex()),
+        characterset, positions[character_index],
+        level.characterSpriteIndex(character_index));
+  }
+}
+
+void Renderer::renderChunk(Level const& level, Texture const& tileset_texture,
+                           TileLayerCache::Chunk& chunk, int64_t tick) {
+  // What was batched for the previous target is drawn first.
+  quad_batch_.flush();
+  SDL_SetRenderTarget(sdl_renderer_, chunk.texture);
+  SDL_SetRenderDrawColor(sdl_renderer_, 0, 0, 0, 0);
+  SDL_RenderClear(sdl_renderer_);
+
+  Spriteset const& tileset{level.spriteset()};
+  vector<TilePosition> const& animated_tiles{
+      level.animatedTiles(chunk.chunk_x, chunk.chunk_y)};
+  int64_t const first_x{chunk.chunk_x * Level::kChunkSizeInTiles};
+  int64_t const first_y{chunk.chunk_y * Level::kChunkSizeInTiles};
+  int64_t const last_x{
+      min(level.widthInTiles(), first_x + Level::kChunkSizeInTiles)};
+  int64_t const last_y{
+      min(level.heightInTiles(), first_y + Level::kChunkSizeInTiles)};
+  // Both go row by row, the animated tiles are skipped as they come.
+  auto animated_tile{animated_tiles.cbegin()};
+  for (int64_t y{first_y}; y < last_y; y++) {
+    for (int64_t x{first_x}; x < last_x; x++) {
+      if (animated_tile != animated_tiles.cend() &&
+          *animated_tile == TilePosition{x, y}) {
+        animated_tile++;
+        continue;
+      }
+      renderTile(tileset_texture, tileset, level.tileIndex(x, y),
+                 (x - first_x) * tileset.spritesWidth(),
+                 (y - first_y) * tileset.spritesHeight());
+    }
+  }
+
+  chunk.animated_sprites.clear();
+  chunk.animations_tick = tick;
+  chunk.next_animations_tick = numeric_limits<int64_t>::max();
+  for (TilePosition const& tile_position : animated_tiles) {
+    Animation const* animation{level.animationPlayer().animationFor(
+        level.tileIndex(tile_position.x(), tile_position.y()))};
+    uint16_t const sprite_index{animation->spriteIndexAt(tick)};
+    renderTile(tileset_texture, tileset, sprite_index,
+               (tile_position.x() - first_x) * tileset.spritesWidth(),
+               (tile_position.y() - first_y) * tileset.spritesHeight());
+    chunk.animated_sprites.push_back({animation, sprite_index});
+    chunk.next_animations_tick =
+        min(chunk.next_animations_tick, animation->nextStepTick(tick));
   }
+
+  quad_batch_.flush();
+  SDL_SetRenderTarget(sdl_renderer_, nullptr);
+  SDL_SetRenderDrawColor(sdl_renderer_, 0, 0, 0, SDL_ALPHA_OPAQUE);
 }
 
 void Renderer::renderLevel(Level const& level, Texture const& tileset_texture,
-                           PositionedRectangle const& viewport,
-                           int64_t tick) const {
+                           PositionedRectangle const& viewport, int64_t tick) {
   Spriteset const& tileset = level.spriteset();
-  for (int64_t y(viewport.y() / tileset.spritesHeight());
-       y <= (viewport.y() + viewport.height()) / tileset.spritesHeight(); y++) {
-    for (int64_t x(viewport.x() / tileset.spritesWidth());
-         x <= (viewport.x() + viewport.width()) / tileset.spritesWidth(); x++) {
-      uint16_t tile_index(level.animationPlayer().animatedSpriteIndexFor(
-          level.tileIndex(x, y), tick));
-
-      SDL_Rect source_rect{rectForSpriteIndex(tile_index, tileset)};
+
+  // The chunks in the viewport, each with a single copy.
+  int64_t const chunk_width{Level::kChunkSizeInTiles * tileset.spritesWidth()};
+  int64_t const chunk_height{Level::kChunkSizeInTiles *
+                             tileset.spritesHeight()};
+  int64_t const last_chunk_x{
+      min(level.widthInChunks() - 1,
+          (viewport.x() + viewport.width() - 1) / chunk_width)};
+  int64_t const last_chunk_y{
+      min(level.heightInChunks() - 1,
+          (viewport.y() + viewport.height() - 1) / chunk_height)};
+  for (int64_t chunk_y{max(int64_t{0}, viewport.y() / chunk_height)};
+       chunk_y <= last_chunk_y; chunk_y++) {
+    for (int64_t chunk_x{max(int64_t{0}, viewport.x() / chunk_width)};
+         chunk_x <= last_chunk_x; chunk_x++) {
+      TileLayerCache::Chunk* chunk{
+          tile_layer_cache_.find(level, chunk_x, chunk_y)};
+      if (chunk == nullptr) {
+        chunk = &tile_layer_cache_.store(level, chunk_x, chunk_y);
+        renderChunk(level, tileset_texture, *chunk, tick);
+      } else {
+        updateAnimatedTiles(level, tileset_texture, *chunk, tick);
+      }
+
+      SDL_Rect source_rect;
+      source_rect.x = 0;
+      source_rect.y = 0;
+      source_rect.w = static_cast<int>(chunk_width);
+      source_rect.h = static_cast<int>(chunk_height);
       SDL_Rect dest_rect;
-      dest_rect.w = static_cast<int>(tileset.spritesWidth());
-      dest_rect.h = static_cast<int>(tileset.spritesHeight());
-      dest_rect.x = static_cast<int>(x * tileset.spritesWidth() - viewport.x());
-      dest_rect.y =
-          static_cast<int>(y * tileset.spritesHeight() - viewport.y());
-
-      SDL_RenderCopy(sdl_renderer_, tileset_texture.texture(), &source_rect,
-                     &dest_rect);
+      dest_rect.w = static_cast<int>(chunk_width);
+      dest_rect.h = static_cast<int>(chunk_height);
+      dest_rect.x = static_cast<int>(chunk_x * chunk_width - viewport.x());
+      dest_rect.y = static_cast<int>(chunk_y * chunk_height - viewport.y());
+
+      quad_batch_.add(chunk->texture, source_rect, dest_rect);
     }
   }
 }
+
+void Renderer::renderTile(Texture const& tileset_texture,
+                          Spriteset const& tileset, uint16_t sprite_index,
+                          int64_t x, int64_t y) {
+  SDL_Rect source_rect{rectForSpriteIndex(sprite_index, tileset)};
+  SDL_Rect dest_rect;
+  dest_rect.w = static_cast<int>(tileset.spritesWidth());
+  dest_rect.h = static_cast<int>(tileset.spritesHeight());
+  dest_rect.x = static_cast<int>(x);
+  dest_rect.y = static_cast<int>(y);
+
+  quad_batch_.add(tileset_texture.texture(), source_rect, dest_rect);
+}
+
+void Renderer::updateAnimatedTiles(Level const& level,
+                                   Texture const& tileset_texture,
+                                   TileLayerCache::Chunk& chunk,
+                                   int64_t tick) {
+  // Most frames fall between two steps of the animations.
+  if (tick >= chunk.animations_tick && tick < chunk.next_animations_tick) {
+    return;
+  }
+
+  Spriteset const& tileset{level.spriteset()};
+  vector<TilePosition> const& animated_tiles{
+      level.animatedTiles(chunk.chunk_x, chunk.chunk_y)};
+  erased_tiles_.clear();
+  chunk.animations_tick = tick;
+  chunk.next_animations_tick = numeric_limits<int64_t>::max();
+  for (int64_t i{0}; i < animated_tiles.size(); i++) {
+    TileLayerCache::AnimatedSprite& animated_sprite{chunk.animated_sprites[i]};
+    chunk.next_animations_tick =
+        min(chunk.next_animations_tick,
+            animated_sprite.animation->nextStepTick(tick));
+    uint16_t const sprite_index{animated_sprite.animation->spriteIndexAt(tick)};
+    if (sprite_index == animated_sprite.sprite_index) {
+      continue;
+    }
+
+    if (erased_tiles_.empty()) {
+      // What was batched for the previous target is drawn first.
+      quad_batch_.flush();
+    }
+    SDL_Rect tile_rect;
+    tile_rect.w = static_cast<int>(tileset.spritesWidth());
+    tile_rect.h = static_cast<int>(tileset.spritesHeight());
+    tile_rect.x = static_cast<int>(
+        (animated_tiles[i].x() - chunk.chunk_x * Level::kChunkSizeInTiles) *
+        tileset.spritesWidth());
+    tile_rect.y = static_cast<int>(
+        (animated_tiles[i].y() - chunk.chunk_y * Level::kChunkSizeInTiles) *
+        tileset.spritesHeight());
+    erased_tiles_.push_back(tile_rect);
+    renderTile(tileset_texture, tileset, sprite_index, tile_rect.x,
+               tile_rect.y);
+    animated_sprite.sprite_index = sprite_index;
+  }
+
+  if (!erased_tiles_.empty()) {
+    /* The batched sprites are drawn once the previous ones are erased, as the
+     * new ones may not cover them. */
+    SDL_SetRenderTarget(sdl_renderer_, chunk.texture);
+    SDL_SetRenderDrawColor(sdl_renderer_, 0, 0, 0, 0);
+    SDL_RenderFillRects(sdl_renderer_, erased_tiles_.data(),
+                        static_cast<int>(erased_tiles_.size()));
+    quad_batch_.flush();
+    SDL_SetRenderTarget(sdl_renderer_, nullptr);
+    SDL_SetRenderDrawColor(sdl_renderer_, 0, 0, 0, SDL_ALPHA_OPAQUE);
+  }
+}
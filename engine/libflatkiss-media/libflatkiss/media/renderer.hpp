@@ -20,8 +20,11 @@
 #ifndef LIBFLATKISS_MEDIA_RENDERER_HPP_INCLUDED
 #define LIBFLATKISS_MEDIA_RENDERER_HPP_INCLUDED
 
+#include <libflatkiss/job/job.hpp>
+#include <libflatkiss/media/quad_batch.hpp>
 #include <libflatkiss/media/texture.hpp>
 #include <libflatkiss/media/texture_atlas.hpp>
+#include <libflatkiss/media/tile_layer_cache.hpp>
 #include <libflatkiss/model/model.hpp>
 #include <unordered_map>
 #include <vector>
@@ -35,6 +38,13 @@ struct SDL_Window;
 
 /**
  * @brief Renders the whole scene.
+ *
+ * The tiles of the level are drawn from chunk textures (refer to
+ * TileLayerCache). Only the animated tiles whose sprites changed since the
+ * previous frame are drawn again into their chunks.
+ *
+ * Everything is drawn through a QuadBatch: the quads from the same texture are
+ * drawn with a single call.
  */
 class Renderer {
  public:
@@ -52,24 +62,59 @@ class Renderer {
    * nullptr.
    */
   SDL_Texture* createTextureFromSurface(SDL_Surface* surface) const;
+  /**
+   * @brief Draw the part of a level in the viewport.
+   *
+   * @param job_system Job system gathering the visible characters.
+   */
   void render(Level const& level, PositionedRectangle const& viewport,
               int64_t tick, TextureAtlas const& textures,
-              std::vector<Character> const& characters) const;
+              JobSystem& job_system);
 
  private:
   SDL_Renderer* const sdl_renderer_;
+  QuadBatch quad_batch_;
+  TileLayerCache tile_layer_cache_;
+  // Tiles of a chunk to erase before drawing their new sprites.
+  std::vector<SDL_Rect> erased_tiles_;
 
   static SDL_Rect rectForSpriteIndex(int64_t sprite_index,
                                      Spriteset const& spriteset);
   void renderCharacter(PositionedRectangle const& viewport,
                        Texture const& characterset_texture,
-                       Character const& character) const;
-  void renderCharacters(
-      PositionedRectangle const& viewport,
-      std::vector<Character> const& characters,
-      TextureAtlas const& charactersets_textures) const;
+                       Spriteset const& characterset, Position const& position,
+                       uint16_t sprite_index);
+  void renderCharacters(PositionedRectangle const& viewport,
+                        Level const& level,
+                        TextureAtlas const& charactersets_textures,
+                        JobSystem& job_system);
+  /**
+   * @brief Draw all the tiles of a chunk into its texture.
+   */
+  void renderChunk(Level const& level, Texture const& tileset_texture,
+                   TileLayerCache::Chunk& chunk, int64_t tick);
   void renderLevel(Level const& level, Texture const& tileset_texture,
-                   PositionedRectangle const& viewport, int64_t tick) const;
+                   PositionedRectangle const& viewport, int64_t tick);
+  /**
+   * @brief Draw a tile at the given location of the current target, in
+   * pixels.
+   */
+  void renderTile(Texture const& tileset_texture, Spriteset const& tileset,
+                  uint16_t sprite_index, int64_t x, int64_t y);
+  /**
+   * @brief Draw again into its texture the animated tiles of a chunk whose
+   * sprites changed.
+   *
+   * Nothing is looked up until the tick at which the first of the animations
+   * of the chunk moves on to its next sprite.
+   */
+  void updateAnimatedTiles(Level const& level,
+                           Texture const& tileset_texture,
+                           TileLayerCache::Chunk& chunk, int64_t tick);
+  // Number of chunks of tiles kept in the tile layer cache.
+  static int64_t constexpr kChunksCacheCapacity{64};
+  // Number of character slots gathered by one job.
+  static int64_t constexpr kCharactersGrainSize{4096};
 };
 
 #endif
@@ -0,0 +1,121 @@
+/*
+ * Copyright (C) 2021-2023 Jean-Marie BARAN (jeanmarie.baran@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Refer to 'COPYING.txt' for the full notice.
+ */
+
+#include <SDL2/SDL.h>
+
+#include <functional>
+#include <iterator>
+#include <libflatkiss/media/tile_layer_cache.hpp>
+#include <stdexcept>
+
+using std::hash;
+using std::invalid_argument;
+using std::prev;
+using std::runtime_error;
+using std::size_t;
+
+TileLayerCache::TileLayerCache(SDL_Renderer* sdl_renderer, int64_t capacity)
+    : sdl_renderer_{sdl_renderer}, capacity_{capacity} {
+  if (capacity_ <= 0) {
+    throw invalid_argument("Capacity of a tile layer cache must be positive");
+  }
+}
+
+TileLayerCache::~TileLayerCache() { clear(); }
+
+void TileLayerCache::clear() {
+  for (Chunk const& chunk : chunks_) {
+    SDL_DestroyTexture(chunk.texture);
+  }
+  chunks_.clear();
+  chunks_by_key_.clear();
+}
+
+TileLayerCache::Chunk* TileLayerCache::find(Level const& level,
+                                            int64_t chunk_x, int64_t chunk_y) {
+  auto const found{chunks_by_key_.find(Key{&level, chunk_x, chunk_y})};
+  if (found == chunks_by_key_.end() ||
+      found->second->version != level.chunkVersion(chunk_x, chunk_y)) {
+    return nullptr;
+  }
+
+  // Move the chunk to the front, it is now the most recently used.
+  chunks_.splice(chunks_.begin(), chunks_, found->second);
+  return &*found->second;
+}
+
+TileLayerCache::Chunk& TileLayerCache::store(Level const& level,
+                                             int64_t chunk_x, int64_t chunk_y) {
+  Key const key{&level, chunk_x, chunk_y};
+  int64_t const width{Level::kChunkSizeInTiles *
+                      level.spriteset().spritesWidth()};
+  int64_t const height{Level::kChunkSizeInTiles *
+                       level.spriteset().spritesHeight()};
+  auto const found{chunks_by_key_.find(key)};
+  if (found == chunks_by_key_.end()) {
+    if (chunks_.size() == capacity_) {
+      // The least recently used chunk gives way, with its texture.
+      Chunk const& last{chunks_.back()};
+      chunks_by_key_.erase(Key{last.level, last.chunk_x, last.chunk_y});
+      chunks_.splice(chunks_.begin(), chunks_, prev(chunks_.end()));
+      chunks_.front().level = &level;
+      chunks_.front().chunk_x = chunk_x;
+      chunks_.front().chunk_y = chunk_y;
+    } else {
+      chunks_.push_front(
+          Chunk{&level, chunk_x, chunk_y, 0, nullptr, 0, 0, {}, 0, 0});
+    }
+    chunks_by_key_.emplace(key, chunks_.begin());
+  } else {
+    chunks_.splice(chunks_.begin(), chunks_, found->second);
+  }
+
+  Chunk& chunk{chunks_.front()};
+  if (chunk.width != width || chunk.height != height) {
+    SDL_DestroyTexture(chunk.texture);
+    chunk.texture = SDL_CreateTexture(
+        sdl_renderer_, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET,
+        static_cast<int>(width), static_cast<int>(height));
+    if (chunk.texture == nullptr) {
+      chunks_by_key_.erase(key);
+      chunks_.pop_front();
+      throw runtime_error("Failed to create SDL texture");
+    }
+    // What the tiles leave transparent shows what is behind the chunk.
+    SDL_SetTextureBlendMode(chunk.texture, SDL_BLENDMODE_BLEND);
+    chunk.width = width;
+    chunk.height = height;
+  }
+  chunk.version = level.chunkVersion(chunk_x, chunk_y);
+  return chunk;
+}
+
+bool TileLayerCache::Key::operator==(Key const& other) const {
+  return level == other.level && chunk_x == other.chunk_x &&
+         chunk_y == other.chunk_y;
+}
+
+size_t TileLayerCache::KeyHash::operator()(Key const& key) const {
+  size_t seed{hash<Level const*>{}(key.level)};
+  seed ^= hash<int64_t>{}(key.chunk_x) + 0x9e3779b9 + (seed << 6) +
+          (seed >> 2);
+  seed ^= hash<int64_t>{}(key.chunk_y) + 0x9e3779b9 + (seed << 6) +
+          (seed >> 2);
+  return seed;
+}
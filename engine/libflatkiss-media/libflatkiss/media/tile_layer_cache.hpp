@@ -0,0 +1,133 @@
+/*
+ * Copyright (C) 2021-2023 Jean-Marie BARAN (jeanmarie.baran@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Refer to 'COPYING.txt' for the full notice.
+ */
+
+#ifndef LIBFLATKISS_MEDIA_TILE_LAYER_CACHE_HPP_INCLUDED
+#define LIBFLATKISS_MEDIA_TILE_LAYER_CACHE_HPP_INCLUDED
+
+#include <cstddef>
+#include <libflatkiss/model/model.hpp>
+#include <list>
+#include <unordered_map>
+#include <vector>
+
+// Forward declarations to avoid exposing SDL to the outside world.
+struct SDL_Renderer;
+struct SDL_Texture;
+
+/**
+ * @brief Textures of the tiles of the levels, drawn once per chunk.
+ *
+ * The chunks are those of the levels (refer to Level::kChunkSizeInTiles). Once
+ * drawn into its texture, a chunk is rendered with a single copy instead of
+ * one per tile, as long as its tiles do not change. Its animated tiles are
+ * drawn again into the texture whenever their sprites change.
+ *
+ * The cache is bounded: when it is full, the texture of the least recently
+ * used chunk is taken for the next one. Each chunk keeps the version of its
+ * tiles it was drawn with (refer to Level::chunkVersion()), and is stale once
+ * the level has a newer one: looking a chunk up costs the same whatever the
+ * number of its tiles.
+ */
+class TileLayerCache {
+ public:
+  /**
+   * @brief An animated tile of a chunk, with the sprite it was drawn with.
+   */
+  struct AnimatedSprite {
+    Animation const* animation;
+    uint16_t sprite_index;
+  };
+
+  /**
+   * @brief A chunk and its texture.
+   *
+   * The animated sprites are kept by the renderer, the rest by the cache.
+   */
+  struct Chunk {
+    Level const* level;
+    int64_t chunk_x;
+    int64_t chunk_y;
+    // Version of the tiles the chunk was drawn with.
+    uint64_t version;
+    SDL_Texture* texture;
+    int64_t width;
+    int64_t height;
+    // One per animated tile of the chunk (refer to Level::animatedTiles()).
+    std::vector<AnimatedSprite> animated_sprites;
+    /* The animated sprites were drawn at the first tick, and none of them
+     * changes before the second one. */
+    int64_t animations_tick;
+    int64_t next_animations_tick;
+  };
+
+  /**
+   * @param sdl_renderer Renderer creating the textures of the chunks.
+   * @param capacity Maximum number of chunks kept at once.
+   */
+  TileLayerCache(SDL_Renderer* sdl_renderer, int64_t capacity);
+  TileLayerCache(TileLayerCache const& other) = delete;
+  TileLayerCache(TileLayerCache&& other) = delete;
+  TileLayerCache& operator=(TileLayerCache const& other) = delete;
+  TileLayerCache& operator=(TileLayerCache&& other) = delete;
+  ~TileLayerCache();
+  /**
+   * @brief Drop all the chunks, and destroy their textures.
+   *
+   * To be called before the renderer is destroyed.
+   */
+  void clear();
+  /**
+   * @brief Look up a chunk.
+   *
+   * @param level Level of the chunk.
+   * @param chunk_x Location of the chunk along the horizontal axis, in chunks.
+   * @param chunk_y Location of the chunk along the vertical axis, in chunks.
+   * @return Chunk* The chunk, or null if it is not cached or is stale.
+   */
+  Chunk* find(Level const& level, int64_t chunk_x, int64_t chunk_y);
+  /**
+   * @brief Store a chunk with the current version of its tiles, and returns it
+   * to be drawn.
+   *
+   * Its texture has the size of the chunk in pixels. The caller clears it
+   * before drawing: it may still show another chunk.
+   */
+  Chunk& store(Level const& level, int64_t chunk_x, int64_t chunk_y);
+
+ private:
+  struct Key {
+    Level const* level;
+    int64_t chunk_x;
+    int64_t chunk_y;
+
+    bool operator==(Key const& other) const;
+  };
+
+  struct KeyHash {
+    std::size_t operator()(Key const& key) const;
+  };
+
+  SDL_Renderer* const sdl_renderer_;
+  int64_t const capacity_;
+  // Most recently used first.
+  std::list<Chunk> chunks_;
+  std::unordered_map<Key, std::list<Chunk>::iterator, KeyHash> chunks_by_key_;
+};
+
+#endif
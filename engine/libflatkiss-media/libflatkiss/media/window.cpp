@@ -75,8 +75,8 @@ void Window::quitSDL() { SDL_Quit(); }
 
 void Window::render(Level const& level, PositionedRectangle const& viewport,
                     int64_t tick, TextureAtlas const& textures,
-                    std::vector<Character> const& characters) const {
-  renderer_.render(level, viewport, tick++, textures, characters);
+                    JobSystem& job_system) {
+  renderer_.render(level, viewport, tick++, textures, job_system);
 }
 
 Renderer const& Window::renderer() const { return renderer_; }
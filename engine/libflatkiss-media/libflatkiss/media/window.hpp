@@ -42,7 +42,7 @@ class Window {
 
   void render(Level const& level, PositionedRectangle const& viewport,
               int64_t tick, TextureAtlas const& textures,
-              std::vector<Character> const& characters) const;
+              JobSystem& job_system);
   Renderer const& renderer() const;
 
  private:
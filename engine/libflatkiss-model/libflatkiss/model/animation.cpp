@@ -31,6 +31,15 @@ int64_t Animation::getDuration() const { return duration_; }
 
 int64_t Animation::getPeriod() const { return period_; }
 
+int64_t Animation::nextStepTick(int64_t tick) const {
+  return (tick / getDuration() + 1) * getDuration();
+}
+
+uint16_t Animation::spriteIndexAt(int64_t tick) const {
+  return spriteIndexAtStep((tick % (getPeriod() * getDuration())) /
+                           getDuration());
+}
+
 uint16_t Animation::spriteIndexAtStep(int64_t step) const {
   return sprite_indices_[step];
 }
@@ -36,6 +36,16 @@ class Animation {
             uint8_t Duration);
   int64_t getDuration() const;
   int64_t getPeriod() const;
+  /**
+   * @brief Returns the first tick after the given one at which the animation
+   * moves on to its next sprite.
+   */
+  int64_t nextStepTick(int64_t tick) const;
+  /**
+   * @brief Returns the sprite displayed at the given tick, the animation
+   * looping every period * duration ticks.
+   */
+  uint16_t spriteIndexAt(int64_t tick) const;
   uint16_t spriteIndexAtStep(int64_t step) const;
 
  private:
@@ -27,16 +27,19 @@ AnimationPlayer::AnimationPlayer(
     unordered_map<uint16_t, Animation>&& animations_per_sprite_index)
     : animations_per_sprite_index_{move(animations_per_sprite_index)} {}
 
+Animation const* AnimationPlayer::animationFor(uint16_t sprite_index) const {
+  auto const animation{animations_per_sprite_index_.find(sprite_index)};
+  return animation != animations_per_sprite_index_.end() ? &animation->second
+                                                         : nullptr;
+}
+
 uint16_t AnimationPlayer::animatedSpriteIndexFor(uint16_t sprite_index,
                                                  int64_t tick) const {
   if (!animations_per_sprite_index_.contains(sprite_index)) {
     return sprite_index;
   }
 
-  Animation const& animation{animations_per_sprite_index_.at(sprite_index)};
-  return animation.spriteIndexAtStep(
-      (tick % (animation.getPeriod() * animation.getDuration())) /
-      animation.getDuration());
+  return animations_per_sprite_index_.at(sprite_index).spriteIndexAt(tick);
 }
 
 int64_t AnimationPlayer::animationDurationForSpriteIndex(
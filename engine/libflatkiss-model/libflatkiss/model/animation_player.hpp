@@ -41,6 +41,10 @@ class AnimationPlayer {
    */
   AnimationPlayer(
       std::unordered_map<uint16_t, Animation>&& animations_per_sprite_index);
+  /**
+   * @brief Returns the animation of a sprite, or null if it is not animated.
+   */
+  Animation const* animationFor(uint16_t sprite_index) const;
   uint16_t animatedSpriteIndexFor(uint16_t sprite_index, int64_t tick) const;
   int64_t animationDurationForSpriteIndex(uint16_t sprite_index) const;
 
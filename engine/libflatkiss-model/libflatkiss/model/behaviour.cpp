@@ -0,0 +1,65 @@
+/*
+ * Copyright (C) 2021-2023 Jean-Marie BARAN (jeanmarie.baran@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Refer to 'COPYING.txt' for the full notice.
+ */
+
+#include <libflatkiss/model/behaviour.hpp>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+using std::invalid_argument;
+using std::move;
+using std::to_string;
+using std::vector;
+
+Behaviour::Behaviour(vector<Instruction>&& instructions)
+    : instructions_{move(instructions)} {
+  for (int64_t i{0}; i < instructions_.size(); i++) {
+    Instruction const& instruction{instructions_[i]};
+    if (instruction.register_index >= kNumRegisters) {
+      throw invalid_argument("Unknown register " +
+                             to_string(instruction.register_index) +
+                             " at instruction " + to_string(i));
+    }
+    bool const is_jump{instruction.opcode == Opcode::kJump ||
+                       instruction.opcode == Opcode::kJumpIfZero ||
+                       instruction.opcode == Opcode::kJumpIfNotZero};
+    if (is_jump && (instruction.operand < 0 ||
+                    instruction.operand >= instructions_.size())) {
+      throw invalid_argument("Jump out of the behaviour at instruction " +
+                             to_string(i));
+    }
+    if (instruction.opcode == Opcode::kFits &&
+        (instruction.operand < 0 || instruction.operand >= kNumRegisters)) {
+      throw invalid_argument("Unknown register " +
+                             to_string(instruction.operand) +
+                             " at instruction " + to_string(i));
+    }
+    if (instruction.opcode == Opcode::kRandom && instruction.operand < 0) {
+      throw invalid_argument("Random value below 0 at instruction " +
+                             to_string(i));
+    }
+    if (instruction.opcode == Opcode::kWait && instruction.operand <= 0) {
+      throw invalid_argument("Wait of no tick at instruction " + to_string(i));
+    }
+  }
+}
+
+vector<Behaviour::Instruction> const& Behaviour::instructions() const {
+  return instructions_;
+}
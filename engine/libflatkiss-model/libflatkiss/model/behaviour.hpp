@@ -0,0 +1,87 @@
+/*
+ * Copyright (C) 2021-2023 Jean-Marie BARAN (jeanmarie.baran@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Refer to 'COPYING.txt' for the full notice.
+ */
+
+#ifndef LIBFLATKISS_MODEL_BEHAVIOUR_HPP_INCLUDED
+#define LIBFLATKISS_MODEL_BEHAVIOUR_HPP_INCLUDED
+
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief A script driving a character, as bytecode.
+ *
+ * The bytecode is run by a small register machine (refer to
+ * BytecodeCharacterController), so that new behaviours can be shipped as
+ * assets rather than as new controllers. Each instruction holds an opcode, a
+ * register and an operand, whose meaning depends on the opcode:
+ *
+ * - kHalt: stop the behaviour for good.
+ * - kSet: set the register to the operand.
+ * - kAdd: add the operand to the register.
+ * - kRandom: set the register to a random value from 0 to the operand.
+ * - kFits: set the register to 1 if the character fits one step towards the
+ *   direction in the register given by the operand, to 0 otherwise.
+ * - kJump: continue at the instruction given by the operand.
+ * - kJumpIfZero: same, only if the register is 0.
+ * - kJumpIfNotZero: same, only if the register is not 0.
+ * - kMove: walk one step towards the direction in the register, which takes
+ *   one tick.
+ * - kFace: turn towards the direction in the register, without moving.
+ * - kWait: stay idle for as many ticks as the operand.
+ *
+ * Directions are values of CardinalDirection (taken modulo 4). Running past the
+ * last instruction halts the behaviour.
+ */
+class Behaviour {
+ public:
+  enum class Opcode : uint8_t {
+    kHalt = 0,
+    kSet = 1,
+    kAdd = 2,
+    kRandom = 3,
+    kFits = 4,
+    kJump = 5,
+    kJumpIfZero = 6,
+    kJumpIfNotZero = 7,
+    kMove = 8,
+    kFace = 9,
+    kWait = 10,
+  };
+  struct Instruction {
+    Opcode opcode;
+    uint8_t register_index;
+    int16_t operand;
+  };
+
+  /**
+   * @brief Construct a behaviour, checking that its instructions only refer to
+   * existing registers and instructions.
+   *
+   * @param instructions The bytecode of the behaviour.
+   */
+  Behaviour(std::vector<Instruction>&& instructions);
+  std::vector<Instruction> const& instructions() const;
+
+  static int64_t constexpr kNumRegisters{8};
+
+ private:
+  std::vector<Instruction> const instructions_;
+};
+
+#endif
@@ -18,59 +18,43 @@
  */
 
 #include <libflatkiss/model/character.hpp>
+#include <libflatkiss/model/level.hpp>
 #include <set>
-#include <stdexcept>
-#include <string>
 #include <utility>
 
-using std::invalid_argument;
 using std::move;
 using std::set;
-using std::to_string;
 using std::vector;
 
-Character::Character(Spriteset const& spriteset,
-                     ActionSpriteMapper const& action_sprite_mapper,
-                     AnimationPlayer const& animation_player,
-                     vector<ControllerType> const& controllers,
-                     Solid const& solid, Position const& initial_position)
-    : spriteset_{spriteset},
-      action_sprite_mapper_{action_sprite_mapper},
-      animation_player_{animation_player},
-      controllers_{controllers},
-      facing_direction_{CardinalDirection::kSouth},
-      positioned_solid_{initial_position, solid} {}
+Character::Character(Level& level, int64_t index, uint32_t generation)
+    : level_{level}, index_{index}, generation_{generation} {}
+
+Behaviour const* Character::behaviour() const {
+  return level_.characterTemplate(index_).behaviour();
+}
+
+int64_t Character::behaviourIndex() const {
+  return level_.characterTemplate(index_).behaviourIndex();
+}
 
 vector<ControllerType> const& Character::controllers() const {
-  return controllers_;
+  return level_.characterTemplate(index_).controllers();
 }
 
-Action Character::currentAction() const {
-  switch (facing_direction_) {
-    case kWest:
-      return Action::kWalkLeft;
-    case kSouth:
-      return Action::kWalkDown;
-    case kEast:
-      return Action::kWalkRight;
-    case kNorth:
-      return Action::kWalkUp;
-    default:
-      throw invalid_argument("Unknown cardinal direction: " +
-                             to_string(facing_direction_));
-  }
+uint32_t Character::generation() const { return generation_; }
+
+int64_t Character::index() const { return index_; }
+
+bool Character::isAlive() const {
+  return level_.characterGeneration(index_) == generation_;
 }
 
 void Character::moveTo(Position&& new_position) {
-  positioned_solid_.position(move(new_position));
+  level_.characterPosition(index_, move(new_position));
 }
 
 Position const& Character::position() const {
-  return positioned_solid_.position();
-}
-
-PositionedSolid const& Character::positionedSolid() const {
-  return positioned_solid_;
+  return level_.characterPosition(index_);
 }
 
 void Character::resetAnimationTick() {
@@ -79,24 +63,32 @@ void Character::resetAnimationTick() {
    * immediately starts animating. In particular, this prevents it from sliding
    * for small moves. If this causes issues in the future, it could be replaced
    * by adding pre-animation, played a single time when the animation starts. */
-  animation_tick_ =
-      animation_player_.animationDurationForSpriteIndex(spriteIndex()) - 1;
+  level_.characterAnimationTick(
+      index_, level_.characterTemplate(index_)
+                      .animation_player()
+                      .animationDurationForSpriteIndex(spriteIndex()) -
+                  1);
+}
+
+Solid const& Character::solid() const {
+  return level_.characterTemplate(index_).solid();
 }
 
 uint16_t Character::spriteIndex() const {
-  return animation_player_.animatedSpriteIndexFor(
-      action_sprite_mapper_.spriteIndexForAction(currentAction()),
-      animation_tick_);
+  return level_.characterSpriteIndex(index_);
 }
 
-Spriteset const& Character::spriteset() const { return spriteset_; }
+Spriteset const& Character::spriteset() const {
+  return level_.characterTemplate(index_).spriteset();
+}
 
 void Character::updateFacingDirection(Vector const& desired_displacement,
                                       Vector const& actual_displacement) {
   /* Using the desired displacement as fallback ensures that when the character
    * is blocked, it still turns toward the tried direction. */
   if (actual_displacement != Vector::kZero) {
-    animation_tick_++;
+    level_.characterAnimationTick(index_,
+                                  level_.characterAnimationTick(index_) + 1);
     updateFacingDirectionForDisplacement(actual_displacement);
   } else if (desired_displacement == Vector::kZero) {
     /* Only reset the animation when the character is blocked and not trying to
@@ -130,9 +122,9 @@ void Character::updateFacingDirectionForDisplacement(
    * random direction. Because direction changes are sequential, picking a
    * "random" direction is always right. */
   if (!facing_directions.empty() &&
-      !facing_directions.contains(facing_direction_)) {
+      !facing_directions.contains(level_.characterFacingDirection(index_))) {
     // The direction changed.
-    facing_direction_ = *facing_directions.begin();
+    level_.characterFacingDirection(index_, *facing_directions.begin());
     resetAnimationTick();
   }
 }
@@ -20,15 +20,13 @@
 #ifndef LIBFLATKISS_MODEL_CHARACTER_HPP_INCLUDED
 #define LIBFLATKISS_MODEL_CHARACTER_HPP_INCLUDED
 
-#include <libflatkiss/model/action_sprite_mapper.hpp>
-#include <libflatkiss/model/animation_player.hpp>
 #include <libflatkiss/model/cardinal_direction.hpp>
 #include <libflatkiss/model/character_template.hpp>
 #include <libflatkiss/model/controller_type.hpp>
-#include <libflatkiss/model/positioned_solid.hpp>
-#include <libflatkiss/model/rectangle.hpp>
+#include <libflatkiss/model/position.hpp>
+#include <libflatkiss/model/solid.hpp>
 #include <libflatkiss/model/spriteset.hpp>
-#include <unordered_map>
+#include <libflatkiss/model/vector.hpp>
 #include <vector>
 
 // Forward declaration to break the cycle Character / Level.
@@ -37,19 +35,44 @@ class Level;
 /**
  * @brief A character in the level.
  *
- * Can be seen as an instance of a character spriteset.
+ * Can be seen as an instance of a character template. The state of the
+ * characters is stored by their level, in one array per field (refer to
+ * Level): a character is only a handle on it, cheap to copy. A handle remains
+ * valid as long as the level is neither moved nor destroyed, even when other
+ * characters are spawned.
+ *
+ * Once the character is despawned, the handle is no longer alive and must not
+ * be used anymore (apart from isAlive()).
  */
 class Character {
  public:
-  Character(Spriteset const& spriteset,
-            ActionSpriteMapper const& action_sprite_mapper,
-            AnimationPlayer const& animation_player,
-            std::vector<ControllerType> const& controllers, Solid const& solid,
-            Position const& initial_position);
+  Character(Level& level, int64_t index, uint32_t generation);
+  /**
+   * @brief Returns the script run by the bytecode controller, nullptr if the
+   * character is not driven by one.
+   */
+  Behaviour const* behaviour() const;
+  int64_t behaviourIndex() const;
   std::vector<ControllerType> const& controllers() const;
+  /**
+   * @brief Returns the generation of the slot of the character (refer to
+   * Level).
+   *
+   * With the index, it identifies the character among all those which ever
+   * were in the level.
+   */
+  uint32_t generation() const;
+  /**
+   * @brief Returns the index of the character in its level.
+   */
+  int64_t index() const;
+  /**
+   * @brief Whether the character is still in the level.
+   */
+  bool isAlive() const;
   void moveTo(Position&& new_position);
   Position const& position() const;
-  PositionedSolid const& positionedSolid() const;
+  Solid const& solid() const;
   uint16_t spriteIndex() const;
   Spriteset const& spriteset() const;
   void updateFacingDirection(Vector const& desired_displacement,
@@ -58,15 +81,10 @@ class Character {
   int64_t y() const;
 
  private:
-  AnimationPlayer const& animation_player_;
-  int64_t animation_tick_{0};
-  std::vector<ControllerType> const controllers_;
-  Spriteset const& spriteset_;
-  CardinalDirection facing_direction_;
-  PositionedSolid positioned_solid_;
-  ActionSpriteMapper const& action_sprite_mapper_;
+  Level& level_;
+  int64_t const index_;
+  uint32_t const generation_;
 
-  Action currentAction() const;
   void resetAnimationTick();
   void updateFacingDirectionForDisplacement(Vector const& displacement);
 };
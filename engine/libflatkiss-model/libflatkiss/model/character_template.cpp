@@ -23,11 +23,13 @@ using std::vector;
 
 CharacterTemplate::CharacterTemplate(
     ActionSpriteMapper const& action_sprite_mapper,
-    AnimationPlayer const& animation_player,
-    vector<ControllerType> const& controllers, Spriteset const& spriteset,
-    Solid const& solid)
+    AnimationPlayer const& animation_player, Behaviour const* behaviour,
+    int64_t behaviour_index, vector<ControllerType> const& controllers,
+    Spriteset const& spriteset, Solid const& solid)
     : action_sprite_mapper_{action_sprite_mapper},
       animation_player_{animation_player},
+      behaviour_{behaviour},
+      behaviour_index_{behaviour_index},
       controllers_{controllers},
       spriteset_{spriteset},
       solid_{solid} {}
@@ -40,10 +42,14 @@ AnimationPlayer const& CharacterTemplate::animation_player() const {
   return animation_player_;
 }
 
+Behaviour const* CharacterTemplate::behaviour() const { return behaviour_; }
+
+int64_t CharacterTemplate::behaviourIndex() const { return behaviour_index_; }
+
 vector<ControllerType> const& CharacterTemplate::controllers() const {
   return controllers_;
 }
 
 Spriteset const& CharacterTemplate::spriteset() const { return spriteset_; }
 
-Solid CharacterTemplate::solid() const { return solid_; }
+Solid const& CharacterTemplate::solid() const { return solid_; }
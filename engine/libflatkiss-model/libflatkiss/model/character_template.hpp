@@ -22,6 +22,7 @@
 
 #include <libflatkiss/model/action_sprite_mapper.hpp>
 #include <libflatkiss/model/animation_player.hpp>
+#include <libflatkiss/model/behaviour.hpp>
 #include <libflatkiss/model/controller_type.hpp>
 #include <libflatkiss/model/solid.hpp>
 #include <libflatkiss/model/spriteset.hpp>
@@ -31,17 +32,30 @@ class CharacterTemplate {
  public:
   CharacterTemplate(ActionSpriteMapper const& action_sprite_mapper,
                     AnimationPlayer const& animation_player,
+                    Behaviour const* behaviour, int64_t behaviour_index,
                     std::vector<ControllerType> const& controllers,
                     Spriteset const& spriteset, Solid const& solid);
   ActionSpriteMapper const& action_sprite_mapper() const;
   AnimationPlayer const& animation_player() const;
+  /**
+   * @brief Returns the script run by the bytecode controller, nullptr if the
+   * character is not driven by one.
+   */
+  Behaviour const* behaviour() const;
+  /**
+   * @brief Returns the index of the behaviour of the character, run either as
+   * bytecode or as a script depending on its controller.
+   */
+  int64_t behaviourIndex() const;
   std::vector<ControllerType> const& controllers() const;
   Spriteset const& spriteset() const;
-  Solid solid() const;
+  Solid const& solid() const;
 
  private:
   ActionSpriteMapper const& action_sprite_mapper_;
   AnimationPlayer const& animation_player_;
+  Behaviour const* behaviour_;
+  int64_t const behaviour_index_;
   std::vector<ControllerType> const controllers_;
   Spriteset const& spriteset_;
   Solid const solid_;
@@ -23,6 +23,8 @@
 enum class ControllerType {
   kKeyboardController = 0,
   kStrollController = 1,
+  kBytecodeController = 2,
+  kScriptedController = 3,
 };
 
 #endif
@@ -17,41 +17,329 @@
  * Refer to 'COPYING.txt' for the full notice.
  */
 
+#include <algorithm>
 #include <libflatkiss/model/level.hpp>
+#include <stdexcept>
+#include <string>
 #include <utility>
 
+using std::find_if;
+using std::invalid_argument;
+using std::lower_bound;
+using std::make_shared;
 using std::move;
+using std::to_string;
 using std::vector;
 
 Level::Level(vector<uint16_t>&& tiles, int64_t width_in_tiles,
              int64_t height_in_tiles, Spriteset const& spriteset,
              AnimationPlayer const& animation_player,
-             std::vector<Character>& characters,
              TileSolidMapper const& tile_solid_mapper)
-    : tiles_{move(tiles)},
+    : tiles_{make_shared<vector<uint16_t>>(move(tiles))},
       width_in_tiles_{width_in_tiles},
       height_in_tiles_{height_in_tiles},
       spriteset_{spriteset},
       animation_player_{animation_player},
-      characters_{move(characters)},
-      tile_solid_mapper_{tile_solid_mapper} {}
+      tile_solid_mapper_{tile_solid_mapper} {
+  animated_tiles_.resize(widthInChunks() * heightInChunks());
+  chunk_versions_.resize(widthInChunks() * heightInChunks(), 0);
+  for (int64_t j{0}; j < height_in_tiles_; j++) {
+    for (int64_t i{0}; i < width_in_tiles_; i++) {
+      updateAnimatedTile(i, j);
+    }
+  }
+}
+
+Action Level::actionFacing(CardinalDirection facing_direction) {
+  switch (facing_direction) {
+    case kWest:
+      return Action::kWalkLeft;
+    case kSouth:
+      return Action::kWalkDown;
+    case kEast:
+      return Action::kWalkRight;
+    case kNorth:
+      return Action::kWalkUp;
+    default:
+      throw invalid_argument("Unknown cardinal direction: " +
+                             to_string(facing_direction));
+  }
+}
+
+void Level::addWarp(Warp const& warp) {
+  if (warp.position().x() < 0 || warp.position().x() >= width_in_tiles_ ||
+      warp.position().y() < 0 || warp.position().y() >= height_in_tiles_) {
+    throw invalid_argument("The warp is outside the level");
+  }
+  if (warpAt(warp.position()) != nullptr) {
+    throw invalid_argument("The tile is a warp already");
+  }
+  warps_.push_back(warp);
+}
+
+vector<TilePosition> const& Level::animatedTiles(int64_t chunk_x,
+                                                 int64_t chunk_y) const {
+  return animated_tiles_[chunk_y * widthInChunks() + chunk_x];
+}
 
 AnimationPlayer const& Level::animationPlayer() const {
   return animation_player_;
 }
 
-vector<Character>& Level::characters() { return characters_; }
+Character Level::character(int64_t index) {
+  return Character{*this, index, character_generations_[index]};
+}
+
+int64_t Level::characterAnimationTick(int64_t index) const {
+  return character_animation_ticks_[index];
+}
+
+void Level::characterAnimationTick(int64_t index, int64_t animation_tick) {
+  state_hash_ ^=
+      hashOf(index, HashedField::kAnimationTick,
+             static_cast<uint64_t>(character_animation_ticks_[index])) ^
+      hashOf(index, HashedField::kAnimationTick,
+             static_cast<uint64_t>(animation_tick));
+  character_animation_ticks_[index] = animation_tick;
+}
+
+CardinalDirection Level::characterFacingDirection(int64_t index) const {
+  return character_facing_directions_[index];
+}
+
+void Level::characterFacingDirection(int64_t index,
+                                     CardinalDirection facing_direction) {
+  state_hash_ ^= hashOf(index, HashedField::kFacingDirection,
+                        character_facing_directions_[index]) ^
+                 hashOf(index, HashedField::kFacingDirection, facing_direction);
+  character_facing_directions_[index] = facing_direction;
+}
+
+uint32_t Level::characterGeneration(int64_t index) const {
+  return character_generations_[index];
+}
+
+Position const& Level::characterPosition(int64_t index) const {
+  return character_positions_[index];
+}
+
+void Level::characterPosition(int64_t index, Position&& position) {
+  state_hash_ ^= hashOf(index, HashedField::kPosition,
+                        packed(character_positions_[index])) ^
+                 hashOf(index, HashedField::kPosition, packed(position));
+  character_positions_[index] = move(position);
+}
+
+vector<Position> const& Level::characterPositions() const {
+  return character_positions_;
+}
+
+uint16_t Level::characterSpriteIndex(int64_t index) const {
+  CharacterTemplate const& character_template{*character_templates_[index]};
+  return character_template.animation_player().animatedSpriteIndexFor(
+      character_template.action_sprite_mapper().spriteIndexForAction(
+          actionFacing(character_facing_directions_[index])),
+      character_animation_ticks_[index]);
+}
+
+CharacterTemplate const& Level::characterTemplate(int64_t index) const {
+  return *character_templates_[index];
+}
+
+int64_t Level::chunkOf(int64_t i, int64_t j) const {
+  return (j / kChunkSizeInTiles) * widthInChunks() + i / kChunkSizeInTiles;
+}
+
+uint64_t Level::chunkVersion(int64_t chunk_x, int64_t chunk_y) const {
+  return chunk_versions_[chunk_y * widthInChunks() + chunk_x];
+}
+
+void Level::despawnCharacter(Character const& character) {
+  if (!character.isAlive()) {
+    throw invalid_argument("The character is not alive");
+  }
+  // A free slot does not count in the hash.
+  state_hash_ ^= characterHash(character.index());
+  character_generations_[character.index()]++;
+  character_templates_[character.index()] = nullptr;
+  free_character_slots_.push_back(character.index());
+}
+
+uint64_t Level::characterHash(int64_t index) const {
+  return hashOf(index, HashedField::kAnimationTick,
+                static_cast<uint64_t>(character_animation_ticks_[index])) ^
+         hashOf(index, HashedField::kFacingDirection,
+                character_facing_directions_[index]) ^
+         hashOf(index, HashedField::kGeneration,
+                character_generations_[index]) ^
+         hashOf(index, HashedField::kPosition,
+                packed(character_positions_[index]));
+}
+
+uint64_t Level::hashOf(int64_t index, HashedField field, uint64_t value) {
+  // NOLINTBEGIN(readability-magic-numbers)
+  // SplitMix64 finalizer, over the value keyed by the slot and the field.
+  uint64_t const key{static_cast<uint64_t>(index) * kNumHashedFields +
+                     static_cast<uint64_t>(field)};
+  uint64_t hash{value ^ (key * 0x9E3779B97F4A7C15ULL)};
+  hash = (hash ^ (hash >> 30U)) * 0xBF58476D1CE4E5B9ULL;
+  hash = (hash ^ (hash >> 27U)) * 0x94D049BB133111EBULL;
+  return hash ^ (hash >> 31U);
+  // NOLINTEND(readability-magic-numbers)
+}
+
+int64_t Level::heightInChunks() const {
+  return (height_in_tiles_ + kChunkSizeInTiles - 1) / kChunkSizeInTiles;
+}
 
 int64_t Level::heightInTiles() const { return height_in_tiles_; }
 
+bool Level::isCharacterAlive(int64_t index) const {
+  return character_templates_[index] != nullptr;
+}
+
+int64_t Level::numCharacters() const {
+  return numCharacterSlots() - free_character_slots_.size();
+}
+
+int64_t Level::numCharacterSlots() const {
+  return character_templates_.size();
+}
+
+void Level::reserveCharacters(int64_t num_characters) {
+  character_animation_ticks_.reserve(num_characters);
+  character_facing_directions_.reserve(num_characters);
+  character_generations_.reserve(num_characters);
+  character_positions_.reserve(num_characters);
+  character_templates_.reserve(num_characters);
+  free_character_slots_.reserve(num_characters);
+}
+
+Character Level::spawnCharacter(CharacterTemplate const& character_template,
+                                Position const& position) {
+  int64_t index{numCharacterSlots()};
+  if (free_character_slots_.empty()) {
+    character_animation_ticks_.push_back(0);
+    character_facing_directions_.push_back(CardinalDirection::kSouth);
+    character_generations_.push_back(0);
+    character_positions_.push_back(position);
+    character_templates_.push_back(&character_template);
+  } else {
+    index = free_character_slots_.back();
+    free_character_slots_.pop_back();
+    character_animation_ticks_[index] = 0;
+    character_facing_directions_[index] = CardinalDirection::kSouth;
+    character_positions_[index] = Position{position};
+    character_templates_[index] = &character_template;
+  }
+  state_hash_ ^= characterHash(index);
+  return character(index);
+}
+
+uint64_t Level::packed(Position const& position) {
+  uint64_t constexpr kNumBitsPerCoordinate{32};
+  return (static_cast<uint64_t>(position.x()) << kNumBitsPerCoordinate) ^
+         static_cast<uint64_t>(position.y());
+}
+
+void Level::restore(Snapshot const& snapshot,
+                    vector<TilePosition>& changed_tiles) {
+  copyInto(snapshot.character_animation_ticks_, character_animation_ticks_);
+  copyInto(snapshot.character_facing_directions_,
+           character_facing_directions_);
+  copyInto(snapshot.character_generations_, character_generations_);
+  copyInto(snapshot.character_positions_, character_positions_);
+  copyInto(snapshot.character_templates_, character_templates_);
+  copyInto(snapshot.free_character_slots_, free_character_slots_);
+  state_hash_ = snapshot.state_hash_;
+
+  // The tiles were only copied if one was changed since the snapshot.
+  if (tiles_ != snapshot.tiles_) {
+    int64_t const first_changed_tile{
+        static_cast<int64_t>(changed_tiles.size())};
+    for (int64_t j{0}; j < height_in_tiles_; j++) {
+      for (int64_t i{0}; i < width_in_tiles_; i++) {
+        int64_t const tile{j * width_in_tiles_ + i};
+        if ((*tiles_)[tile] != (*snapshot.tiles_)[tile]) {
+          changed_tiles.emplace_back(i, j);
+        }
+      }
+    }
+    tiles_ = snapshot.tiles_;
+    for (int64_t k{first_changed_tile}; k < changed_tiles.size(); k++) {
+      updateAnimatedTile(changed_tiles[k].x(), changed_tiles[k].y());
+      chunk_versions_[chunkOf(changed_tiles[k].x(), changed_tiles[k].y())]++;
+    }
+  }
+}
+
+void Level::save(Snapshot& snapshot) const {
+  copyInto(character_animation_ticks_, snapshot.character_animation_ticks_);
+  copyInto(character_facing_directions_,
+           snapshot.character_facing_directions_);
+  copyInto(character_generations_, snapshot.character_generations_);
+  copyInto(character_positions_, snapshot.character_positions_);
+  copyInto(character_templates_, snapshot.character_templates_);
+  copyInto(free_character_slots_, snapshot.free_character_slots_);
+  snapshot.state_hash_ = state_hash_;
+  snapshot.tiles_ = tiles_;
+}
+
 Spriteset const& Level::spriteset() const { return spriteset_; }
 
+uint64_t Level::stateHash() const { return state_hash_; }
+
 uint16_t Level::tileIndex(int64_t i, int64_t j) const {
-  return tiles_[j * width_in_tiles_ + i];
+  return (*tiles_)[j * width_in_tiles_ + i];
+}
+
+void Level::tileIndex(int64_t i, int64_t j, uint16_t tile_index) {
+  if (tiles_.use_count() > 1) {
+    // Shared with a snapshot.
+    tiles_ = make_shared<vector<uint16_t>>(*tiles_);
+  }
+  (*tiles_)[j * width_in_tiles_ + i] = tile_index;
+  updateAnimatedTile(i, j);
+  chunk_versions_[chunkOf(i, j)]++;
 }
 
 TileSolidMapper const& Level::tileSolidMapper() const {
   return tile_solid_mapper_;
 }
 
+void Level::updateAnimatedTile(int64_t i, int64_t j) {
+  vector<TilePosition>& animated_tiles{animated_tiles_[chunkOf(i, j)]};
+  TilePosition const tile_position{i, j};
+  auto const position{lower_bound(
+      animated_tiles.begin(), animated_tiles.end(), tile_position,
+      [](TilePosition const& left, TilePosition const& right) {
+        return left.y() < right.y() ||
+               (left.y() == right.y() && left.x() < right.x());
+      })};
+  bool const is_listed{position != animated_tiles.end() &&
+                       *position == tile_position};
+  bool const is_animated{animation_player_.animationFor(tileIndex(i, j)) !=
+                         nullptr};
+  if (is_animated && !is_listed) {
+    animated_tiles.insert(position, tile_position);
+  } else if (!is_animated && is_listed) {
+    animated_tiles.erase(position);
+  }
+}
+
+// A level has only a few warps.
+Warp const* Level::warpAt(TilePosition const& tile_position) const {
+  auto const warp{find_if(warps_.cbegin(), warps_.cend(),
+                          [&tile_position](Warp const& warp) {
+                            return warp.position() == tile_position;
+                          })};
+  return warp != warps_.cend() ? &*warp : nullptr;
+}
+
+vector<Warp> const& Level::warps() const { return warps_; }
+
+int64_t Level::widthInChunks() const {
+  return (width_in_tiles_ + kChunkSizeInTiles - 1) / kChunkSizeInTiles;
+}
+
 int64_t Level::widthInTiles() const { return width_in_tiles_; }
@@ -20,11 +20,17 @@
 #ifndef LIBFLATKISS_MODEL_LEVEL_HPP_INCLUDED
 #define LIBFLATKISS_MODEL_LEVEL_HPP_INCLUDED
 
+#include <libflatkiss/model/action.hpp>
 #include <libflatkiss/model/animation_player.hpp>
+#include <libflatkiss/model/cardinal_direction.hpp>
 #include <libflatkiss/model/character.hpp>
 #include <libflatkiss/model/character_template.hpp>
+#include <libflatkiss/model/position.hpp>
 #include <libflatkiss/model/spriteset.hpp>
+#include <libflatkiss/model/tile_position.hpp>
 #include <libflatkiss/model/tile_solid_mapper.hpp>
+#include <libflatkiss/model/warp.hpp>
+#include <memory>
 #include <vector>
 
 /**
@@ -32,30 +38,258 @@
  *
  * A level is a list of tiles indices, with dimensions. Once created, this class
  * provides handy methods to access the content of the level.
+ *
+ * The level also stores the state of its characters, in one array per field
+ * (positions, facing directions, etc.). Going through a field for all the
+ * characters (e.g. sorting them by position) streams through dense memory
+ * instead of jumping from a large object to the next. Character is a handle
+ * gathering the fields of one character.
+ *
+ * The arrays are made of slots, and characters can be spawned and despawned at
+ * any time. The slot of a despawned character is reused by the next character
+ * spawned, so that spawning does not allocate once the arrays are large
+ * enough. Each slot has a generation, increased when its character is
+ * despawned: a handle on a despawned character is told apart from a handle on
+ * the character which reused the slot.
+ *
+ * The state of a level can be saved into a snapshot, and restored later. The
+ * tiles are shared by the level and its snapshots until the level changes one
+ * (copy on write), so that saving only copies the state of the characters.
+ *
+ * The level is divided in chunks, squares of kChunkSizeInTiles tiles on each
+ * side, each knowing its animated tiles: drawing the level only looks up the
+ * animations of these. Each chunk also has a version, increased whenever one of
+ * its tiles changes, so that what is built from the tiles of a chunk (e.g. its
+ * texture) is known to be stale by comparing a single value.
+ *
+ * Some tiles are warps to other levels. They are part of the data of the level,
+ * not of its state.
  */
 class Level {
  public:
+  /**
+   * @brief The state of a level at some point (refer to save()).
+   */
+  class Snapshot {
+   private:
+    friend class Level;
+
+    std::vector<int64_t> character_animation_ticks_;
+    std::vector<CardinalDirection> character_facing_directions_;
+    std::vector<uint32_t> character_generations_;
+    std::vector<Position> character_positions_;
+    std::vector<CharacterTemplate const*> character_templates_;
+    std::vector<int64_t> free_character_slots_;
+    uint64_t state_hash_{0};
+    std::shared_ptr<std::vector<uint16_t>> tiles_;
+  };
+
   Level(std::vector<uint16_t>&& tiles, int64_t width_in_tiles,
         int64_t height_in_tiles, Spriteset const& spriteset,
         AnimationPlayer const& animation_player,
-        std::vector<Character>& characters,
         TileSolidMapper const& tile_solid_mapper);
+  /**
+   * @brief Make a tile a warp.
+   *
+   * @throw std::invalid_argument If the tile is outside the level, or is a warp
+   * already.
+   */
+  void addWarp(Warp const& warp);
+  /**
+   * @brief Returns the positions of the animated tiles of a chunk, row by row.
+   *
+   * @param chunk_x Location of the chunk along the horizontal axis, in chunks.
+   * @param chunk_y Location of the chunk along the vertical axis, in chunks.
+   */
+  std::vector<TilePosition> const& animatedTiles(int64_t chunk_x,
+                                                 int64_t chunk_y) const;
   AnimationPlayer const& animationPlayer() const;
-  std::vector<Character>& characters();
+  /**
+   * @brief Returns the character in the slot at the given index.
+   */
+  Character character(int64_t index);
+  int64_t characterAnimationTick(int64_t index) const;
+  void characterAnimationTick(int64_t index, int64_t animation_tick);
+  CardinalDirection characterFacingDirection(int64_t index) const;
+  void characterFacingDirection(int64_t index,
+                                CardinalDirection facing_direction);
+  /**
+   * @brief Returns the generation of the slot at the given index.
+   */
+  uint32_t characterGeneration(int64_t index) const;
+  Position const& characterPosition(int64_t index) const;
+  void characterPosition(int64_t index, Position&& position);
+  /**
+   * @brief Returns the positions of all the characters, by index.
+   *
+   * The positions in the free slots are meaningless.
+   */
+  std::vector<Position> const& characterPositions() const;
+  /**
+   * @brief Returns the sprite currently showing a character.
+   */
+  uint16_t characterSpriteIndex(int64_t index) const;
+  CharacterTemplate const& characterTemplate(int64_t index) const;
+  /**
+   * @brief Returns the version of a chunk, increased each time one of its
+   * tiles changes (refer to tileIndex() and restore()).
+   *
+   * @param chunk_x Location of the chunk along the horizontal axis, in chunks.
+   * @param chunk_y Location of the chunk along the vertical axis, in chunks.
+   */
+  uint64_t chunkVersion(int64_t chunk_x, int64_t chunk_y) const;
+  /**
+   * @brief Remove a character from the level.
+   *
+   * Its slot is freed for the next character spawned. The handles on the
+   * character are no longer alive.
+   */
+  void despawnCharacter(Character const& character);
+  int64_t heightInChunks() const;
   int64_t heightInTiles() const;
+  /**
+   * @brief Whether the slot at the given index holds a character.
+   */
+  bool isCharacterAlive(int64_t index) const;
+  /**
+   * @brief Returns the number of characters in the level.
+   */
+  int64_t numCharacters() const;
+  /**
+   * @brief Returns the number of slots, free or not.
+   */
+  int64_t numCharacterSlots() const;
+  /**
+   * @brief Reserve slots for the given number of characters in total.
+   */
+  void reserveCharacters(int64_t num_characters);
+  /**
+   * @brief Bring the level back to the state saved in a snapshot.
+   *
+   * The handles on the characters which were alive in the snapshot are valid
+   * again. Once the arrays of the level are large enough, restoring does not
+   * allocate.
+   *
+   * @param snapshot A snapshot of this level.
+   * @param changed_tiles Receives (appended) the tiles which differ from those
+   * of the level before the call.
+   */
+  void restore(Snapshot const& snapshot,
+               std::vector<TilePosition>& changed_tiles);
+  /**
+   * @brief Save the state of the level.
+   *
+   * @param snapshot Receives the state, overwritten. Reusing the same snapshot
+   * does not allocate once its arrays are large enough.
+   */
+  void save(Snapshot& snapshot) const;
+  /**
+   * @brief Add a character to the level.
+   *
+   * It faces south, and its animation starts from the beginning.
+   *
+   * @param character_template Template of the character.
+   * @param position Initial position of the character.
+   * @return Character The new character.
+   */
+  Character spawnCharacter(CharacterTemplate const& character_template,
+                           Position const& position);
   Spriteset const& spriteset() const;
+  /**
+   * @brief Returns a hash of the state of the characters: their positions,
+   * facing directions, animation ticks and generations.
+   *
+   * The hash is updated on each change rather than computed on demand, so it
+   * costs nothing to read at every tick. Two runs whose hashes match at each
+   * tick (e.g. two replays of the same inputs) behaved the same.
+   */
+  uint64_t stateHash() const;
   uint16_t tileIndex(int64_t i, int64_t j) const;
+  /**
+   * @brief Replace the tile at the given location.
+   *
+   * Whatever depends on the tiles (e.g. the structures used for path finding)
+   * must be notified by the caller.
+   */
+  void tileIndex(int64_t i, int64_t j, uint16_t tile_index);
   TileSolidMapper const& tileSolidMapper() const;
+  /**
+   * @brief Returns the warp on the given tile, or null if there is none.
+   */
+  Warp const* warpAt(TilePosition const& tile_position) const;
+  std::vector<Warp> const& warps() const;
+  int64_t widthInChunks() const;
   int64_t widthInTiles() const;
 
+  static int64_t constexpr kChunkSizeInTiles{16};
+
  private:
+  // Fields of the characters in the hash, each hashed on its own.
+  enum class HashedField : uint64_t {
+    kAnimationTick,
+    kFacingDirection,
+    kGeneration,
+    kPosition,
+  };
+
+  // Positions of the animated tiles, sorted, chunk by chunk row by row.
+  std::vector<std::vector<TilePosition>> animated_tiles_;
   AnimationPlayer const& animation_player_;
-  std::vector<Character> characters_;
+  // The state of the characters, one field per array.
+  std::vector<int64_t> character_animation_ticks_;
+  std::vector<CardinalDirection> character_facing_directions_;
+  std::vector<uint32_t> character_generations_;
+  std::vector<Position> character_positions_;
+  // Null in the free slots.
+  std::vector<CharacterTemplate const*> character_templates_;
+  // Versions of the chunks, row by row.
+  std::vector<uint64_t> chunk_versions_;
+  std::vector<int64_t> free_character_slots_;
   int64_t const height_in_tiles_;
+  // Exclusive or of the hashes of the fields of the live characters.
+  uint64_t state_hash_{0};
   Spriteset const& spriteset_;
   TileSolidMapper const& tile_solid_mapper_;
-  std::vector<uint16_t> const tiles_;
+  // Shared with the snapshots, copied before being changed.
+  std::shared_ptr<std::vector<uint16_t>> tiles_;
+  std::vector<Warp> warps_;
   int64_t const width_in_tiles_;
+
+  static Action actionFacing(CardinalDirection facing_direction);
+  /**
+   * @brief Returns the hash of all the fields of the character at the given
+   * index.
+   */
+  uint64_t characterHash(int64_t index) const;
+  /**
+   * @brief Returns the hash of one field of the character at the given index.
+   */
+  static uint64_t hashOf(int64_t index, HashedField field, uint64_t value);
+  /**
+   * @brief Returns the coordinates of a position packed in a single value.
+   */
+  static uint64_t packed(Position const& position);
+  /**
+   * @brief Add or remove a tile from the animated tiles of its chunk,
+   * depending on its current index.
+   */
+  void updateAnimatedTile(int64_t i, int64_t j);
+  static uint64_t constexpr kNumHashedFields{4};
+  /**
+   * @brief Returns the index of the chunk containing a tile.
+   */
+  int64_t chunkOf(int64_t i, int64_t j) const;
+  /**
+   * @brief Overwrite a vector with another without reallocating (when large
+   * enough), even for types which cannot be copy assigned.
+   */
+  template <typename T>
+  static void copyInto(std::vector<T> const& from, std::vector<T>& to) {
+    to.clear();
+    for (T const& element : from) {
+      to.push_back(element);
+    }
+  }
 };
 
 #endif
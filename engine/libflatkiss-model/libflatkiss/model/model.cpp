@@ -27,11 +27,14 @@ using std::vector;
 Model::Model(
     unordered_map<int64_t, ActionSpriteMapper const>& action_sprite_mappers,
     unordered_map<int64_t, AnimationPlayer const>& animation_players,
-    vector<Level>& levels, unordered_map<int64_t, Solid const>& solids,
-    vector<Spriteset>& spritesets,
+    unordered_map<int64_t, Behaviour const>& behaviours,
+    vector<CharacterTemplate>& character_templates, vector<Level>& levels,
+    unordered_map<int64_t, Solid const>& solids, vector<Spriteset>& spritesets,
     unordered_map<int64_t, TileSolidMapper const>& tile_solid_mappers)
     : action_sprite_mappers_{move(action_sprite_mappers)},
       animation_players_{move(animation_players)},
+      behaviours_{move(behaviours)},
+      character_templates_{move(character_templates)},
       levels_{move(levels)},
       solids_{move(solids)},
       spritesets_{move(spritesets)},
@@ -47,6 +50,14 @@ unordered_map<int64_t, AnimationPlayer const> const& Model::animation_players()
   return animation_players_;
 }
 
+unordered_map<int64_t, Behaviour const> const& Model::behaviours() const {
+  return behaviours_;
+}
+
+vector<CharacterTemplate> const& Model::character_templates() const {
+  return character_templates_;
+}
+
 vector<Level>& Model::levels() { return levels_; }
 
 unordered_map<int64_t, Solid const> const& Model::solids() const {
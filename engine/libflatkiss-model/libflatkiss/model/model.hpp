@@ -22,12 +22,16 @@
 
 #include <libflatkiss/model/action_sprite_mapper.hpp>
 #include <libflatkiss/model/animation_player.hpp>
+#include <libflatkiss/model/behaviour.hpp>
 #include <libflatkiss/model/character.hpp>
+#include <libflatkiss/model/character_template.hpp>
 #include <libflatkiss/model/level.hpp>
 #include <libflatkiss/model/positioned_rectangle.hpp>
 #include <libflatkiss/model/spriteset.hpp>
+#include <libflatkiss/model/tile_position.hpp>
 #include <libflatkiss/model/tile_solid_mapper.hpp>
 #include <libflatkiss/model/vector.hpp>
+#include <libflatkiss/model/warp.hpp>
 #include <unordered_map>
 #include <vector>
 
@@ -36,6 +40,8 @@ class Model {
   Model(std::unordered_map<int64_t, ActionSpriteMapper const>&
             action_sprite_mappers,
         std::unordered_map<int64_t, AnimationPlayer const>& animation_players,
+        std::unordered_map<int64_t, Behaviour const>& behaviours,
+        std::vector<CharacterTemplate>& character_templates,
         std::vector<Level>& levels,
         std::unordered_map<int64_t, Solid const>& solids,
         std::vector<Spriteset>& spritesets,
@@ -44,6 +50,8 @@ class Model {
   action_sprite_mappers() const;
   std::unordered_map<int64_t, AnimationPlayer const> const& animation_players()
       const;
+  std::unordered_map<int64_t, Behaviour const> const& behaviours() const;
+  std::vector<CharacterTemplate> const& character_templates() const;
   std::vector<Level>& levels();
   std::unordered_map<int64_t, Solid const> const& solids() const;
   std::vector<Spriteset> const& spritesets() const;
@@ -53,6 +61,9 @@ class Model {
  private:
   std::unordered_map<int64_t, ActionSpriteMapper const> action_sprite_mappers_;
   std::unordered_map<int64_t, AnimationPlayer const> animation_players_;
+  std::unordered_map<int64_t, Behaviour const> behaviours_;
+  // The characters of the levels point to their templates.
+  std::vector<CharacterTemplate> character_templates_;
   std::vector<Level> levels_;
   std::unordered_map<int64_t, Solid const> solids_;
   std::vector<Spriteset> const spritesets_;
@@ -0,0 +1,44 @@
+/*
+ * Copyright (C) 2021-2023 Jean-Marie BARAN (jeanmarie.baran@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Refer to 'COPYING.txt' for the full notice.
+ */
+
+#ifndef LIBFLATKISS_MODEL_TILE_POSITION_HPP_INCLUDED
+#define LIBFLATKISS_MODEL_TILE_POSITION_HPP_INCLUDED
+
+#include <cstdint>
+
+/**
+ * @brief A location in a level, in tiles.
+ *
+ * This is the counterpart of Position for things measured in tiles, such as
+ * the nodes of a path. The top left tile of a level is at (0, 0).
+ */
+class TilePosition {
+ public:
+  TilePosition(int64_t x, int64_t y);
+  bool operator!=(TilePosition const& other) const;
+  bool operator==(TilePosition const& other) const;
+  int64_t x() const;
+  int64_t y() const;
+
+ private:
+  int64_t x_;
+  int64_t y_;
+};
+
+#endif
@@ -42,3 +42,7 @@ int64_t TileSolidMapper::solidIndexForTileIndex(uint16_t tile_index) const {
 
   throw invalid_argument("No solid for tile: " + to_string(tile_index));
 }
+
+unordered_map<uint16_t, int64_t> const& TileSolidMapper::tilesToSolids() const {
+  return tiles_to_solids_;
+}
@@ -37,6 +37,7 @@ class TileSolidMapper {
   TileSolidMapper(std::unordered_map<uint16_t, int64_t>&& tiles_to_solids);
   bool contains(uint16_t tile_index) const;
   int64_t solidIndexForTileIndex(uint16_t tile_index) const;
+  std::unordered_map<uint16_t, int64_t> const& tilesToSolids() const;
 
  private:
   std::unordered_map<uint16_t, int64_t> const tiles_to_solids_;
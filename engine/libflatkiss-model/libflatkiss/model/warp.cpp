@@ -0,0 +1,32 @@
+/*
+ * Copyright (C) 2021-2023 Jean-Marie BARAN (jeanmarie.baran@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Refer to 'COPYING.txt' for the full notice.
+ */
+
+#include <libflatkiss/model/warp.hpp>
+
+Warp::Warp(TilePosition const& position, int64_t destination_level_index,
+           TilePosition const& destination)
+    : position_{position},
+      destination_level_index_{destination_level_index},
+      destination_{destination} {}
+
+TilePosition const& Warp::destination() const { return destination_; }
+
+int64_t Warp::destinationLevelIndex() const { return destination_level_index_; }
+
+TilePosition const& Warp::position() const { return position_; }
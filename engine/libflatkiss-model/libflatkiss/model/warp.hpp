@@ -0,0 +1,53 @@
+/*
+ * Copyright (C) 2021-2023 Jean-Marie BARAN (jeanmarie.baran@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Refer to 'COPYING.txt' for the full notice.
+ */
+
+#ifndef LIBFLATKISS_MODEL_WARP_HPP_INCLUDED
+#define LIBFLATKISS_MODEL_WARP_HPP_INCLUDED
+
+#include <cstdint>
+#include <libflatkiss/model/tile_position.hpp>
+
+/**
+ * @brief A tile of a level leading to another level.
+ *
+ * A character entering the tile is moved to the destination tile of the
+ * destination level.
+ */
+class Warp {
+ public:
+  Warp(TilePosition const& position, int64_t destination_level_index,
+       TilePosition const& destination);
+  /**
+   * @brief Returns the tile the character arrives on, in the destination
+   * level.
+   */
+  TilePosition const& destination() const;
+  int64_t destinationLevelIndex() const;
+  /**
+   * @brief Returns the tile of the warp, in its own level.
+   */
+  TilePosition const& position() const;
+
+ private:
+  TilePosition const position_;
+  int64_t const destination_level_index_;
+  TilePosition const destination_;
+};
+
+#endif
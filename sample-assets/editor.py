@@ -289,13 +289,14 @@ class _LevelLoader(object):
         # Read all the levels until the right one.
         for _ in range(level_index + 1):
             # Level header length in bytes.
-            header = 6 * 2
+            header = 7 * 2
 
-            # Convert each two bytes to an unsigned int (second to last field is the tile to solid map, unused by the
+            # Convert each two bytes to an unsigned int (the fifth field is the tile to solid map, unused by the
             # editor).
-            width, height, tileset_index, animation_index, _, num_characters = \
-                struct.unpack('<' + 'HHHHHH', level_file.read(header))
+            width, height, tileset_index, animation_index, _, num_characters, num_warps = \
+                struct.unpack('<' + 'HHHHHHH', level_file.read(header))
             level_file.read(num_characters * 6)  # Skip the characters (unused by the editor).
+            level_file.read(num_warps * 10)  # Skip the warps (unused by the editor).
             length = width * height * 2
 
             tiles = list(struct.unpack('<' + 'H' * width * height, level_file.read(length)))
@@ -317,9 +318,10 @@ class _LevelLoader(object):
             level_file.write(level.animation_index().to_bytes(2, 'little'))
             level_file.read(2)  # Skip two bytes of the tile to solid map (unused by the editor).
 
-            # Skip the characters (unused by the editor).
-            num_characters = struct.unpack('<' + 'H', level_file.read(2))[0]
+            # Skip the characters and the warps (unused by the editor).
+            num_characters, num_warps = struct.unpack('<' + 'HH', level_file.read(4))
             level_file.read(num_characters * 6)
+            level_file.read(num_warps * 10)
 
             for i in level.tiles_generator():
                 level_file.write(i.to_bytes(2, 'little'))
@@ -0,0 +1,98 @@
+#!/usr/bin/env python3
+
+# Copyright (C) 2021-2023 Jean-Marie BARAN (jeanmarie.baran@gmail.com)
+
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+# GNU General Public License for more details.
+
+# You should have received a copy of the GNU General Public License
+# along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+# Refer to 'COPYING.txt' for the full notice.
+
+from typing import Dict, List, Tuple
+
+import pathlib
+import re
+import sys
+
+# Opcode and kind of the arguments of each instruction ('r' for a register, 'i' for an integer, 'l' for a label).
+INSTRUCTIONS: Dict[str, Tuple[int, str]] = {
+    'halt': (0, ''),
+    'set': (1, 'ri'),
+    'add': (2, 'ri'),
+    'random': (3, 'ri'),
+    'fits': (4, 'rr'),
+    'jump': (5, 'l'),
+    'jump_if_zero': (6, 'rl'),
+    'jump_if_not_zero': (7, 'rl'),
+    'move': (8, 'r'),
+    'face': (9, 'r'),
+    'wait': (10, 'i'),
+}
+
+
+def assemble(lines: List[str]) -> List[Tuple[int, int, int]]:
+    """Turn the text of a behaviour into (opcode, register, operand) instructions."""
+    statements = [line.split('#')[0].split() for line in lines]
+    statements = [statement for statement in statements if len(statement) > 0]
+
+    # First pass for the labels (ending with a colon), which are the index of the instruction which follows them.
+    labels: Dict[str, int] = {}
+    instructions = []
+    for statement in statements:
+        if statement[0].endswith(':'):
+            labels[statement[0][:-1]] = len(instructions)
+        else:
+            instructions.append(statement)
+
+    assembled = []
+    for instruction in instructions:
+        opcode, kinds = INSTRUCTIONS[instruction[0]]
+        if len(instruction) - 1 != len(kinds):
+            raise ValueError('Wrong number of arguments: {}'.format(' '.join(instruction)))
+        # The first register is held by the instruction, the other argument (if any) is the operand.
+        arguments = instruction[1:]
+        register = 0
+        if kinds.startswith('r'):
+            register = int(arguments[0][1:])
+            kinds, arguments = kinds[1:], arguments[1:]
+        operand = 0
+        for kind, argument in zip(kinds, arguments):
+            if kind == 'r':
+                operand = int(argument[1:])
+            elif kind == 'i':
+                operand = int(argument)
+            else:
+                operand = labels[argument]
+        assembled.append((opcode, register, operand))
+
+    return assembled
+
+
+def behaviours_to_binary(text_file_path: str, text_file_regex: str, binary_file_path: str) -> None:
+    with open(binary_file_path, 'wb') as behaviours_file:
+        for file_path in pathlib.Path(text_file_path).iterdir():
+            if re.match(text_file_regex, str(file_path)):
+                with open(file_path) as behaviour_text_file:
+                    instructions = assemble(behaviour_text_file.readlines())
+
+                # Index of the behaviour.
+                behaviours_file.write(int(re.search(r'\d+', file_path.name)[0]).to_bytes(2, 'little'))
+                # Number of instructions in the behaviour.
+                behaviours_file.write(len(instructions).to_bytes(2, 'little'))
+                for opcode, register, operand in instructions:
+                    behaviours_file.write(opcode.to_bytes(1, 'little'))
+                    behaviours_file.write(register.to_bytes(1, 'little'))
+                    behaviours_file.write(operand.to_bytes(2, 'little', signed=True))
+
+
+if __name__ == '__main__':
+    behaviours_to_binary(sys.argv[1], sys.argv[2], sys.argv[3])
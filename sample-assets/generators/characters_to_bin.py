@@ -33,6 +33,7 @@ def characters_to_binary(text_file_path: str, binary_file_path: str) -> None:
             characters_file.write(character[2].to_bytes(2, 'little'))
             characters_file.write(character[3].to_bytes(2, 'little'))
             characters_file.write(character[4].to_bytes(1, 'little'))
+            characters_file.write(character[5].to_bytes(2, 'little'))
 
 
 if __name__ == '__main__':
@@ -18,6 +18,7 @@
 # Refer to 'COPYING.txt' for the full notice.
 
 import animations_to_bin
+import behaviours_to_bin
 import characters_to_bin
 import contextlib
 import fetch_pictures
@@ -39,6 +40,8 @@ def generate() -> None:
     # Binary assets.
     animations_to_bin.animations_to_binary(str(input_directory), r'.*animations_\d+.txt',
                                            str(output_directory / 'animations.bin'))
+    behaviours_to_bin.behaviours_to_binary(str(input_directory), r'.*behaviour_\d+.txt',
+                                           str(output_directory / 'behaviours.bin'))
     characters_to_bin.characters_to_binary(str(input_directory / 'characters.txt'),
                                            str(output_directory / 'characters.bin'))
     levels_to_bin.levels_to_binary(str(input_directory / 'levels.txt'),
@@ -30,17 +30,20 @@ def levels_from_binary(binary_file_path: str, text_file_path: str) -> None:
     with open(text_file_path, 'w') as level_file:
 
         while len(level_bytes) > 0:
-            mark = 6 * 2
-            width, height, spriteset_index, animation_index, tile_solid_map_index, num_characters = \
-                struct.unpack('HHHHHH', level_bytes[:mark])
+            mark = 7 * 2
+            width, height, spriteset_index, animation_index, tile_solid_map_index, num_characters, num_warps = \
+                struct.unpack('HHHHHHH', level_bytes[:mark])
             characters = struct.unpack('HHH' * num_characters, level_bytes[mark:mark + num_characters * 3 * 2])
             mark += num_characters * 3 * 2
+            warps = struct.unpack('HHHHH' * num_warps, level_bytes[mark:mark + num_warps * 5 * 2])
+            mark += num_warps * 5 * 2
             tiles = struct.unpack('H' * width * height, level_bytes[mark:mark + width * height * 2])
 
-            level_file.write('{} {} {} {} {} {}\n'.format(width, height, spriteset_index, animation_index,
-                                                    tile_solid_map_index, num_characters))
+            level_file.write('{} {} {} {} {} {} {}\n'.format(width, height, spriteset_index, animation_index,
+                                                       tile_solid_map_index, num_characters, num_warps))
 
             rows = [characters[i:i + 3] for i in range(0, len(characters), 3)]
+            rows += [warps[i:i + 5] for i in range(0, len(warps), 5)]
             level_file.write('\n'.join([' '.join([str(index).zfill(2) for index in row]) for row in rows]))
 
             level_file.write('\n')
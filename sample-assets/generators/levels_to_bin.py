@@ -32,9 +32,13 @@ def levels_to_binary(text_file_path: str, binary_file_path: str) -> None:
             animation_index = int(items[3])
             tile_solid_map_index = int(items[4])
             num_characters = int(items[5])
+            num_warps = int(items[6])
             # One character is (index, x, y) with each component on two bytes.
-            mark = 6 + num_characters * 3
-            characters = [int(i) for i in items[6:mark]]
+            mark = 7 + num_characters * 3
+            characters = [int(i) for i in items[7:mark]]
+            # One warp is (x, y, destination level, destination x, destination y) with each component on two bytes.
+            warps = [int(i) for i in items[mark:mark + num_warps * 5]]
+            mark += num_warps * 5
             tiles = [int(i) for i in items[mark:mark + width * height]]
 
             level_file.write(width.to_bytes(2, 'little'))
@@ -43,8 +47,11 @@ def levels_to_binary(text_file_path: str, binary_file_path: str) -> None:
             level_file.write(animation_index.to_bytes(2, 'little'))
             level_file.write(tile_solid_map_index.to_bytes(2, 'little'))
             level_file.write(num_characters.to_bytes(2, 'little'))
+            level_file.write(num_warps.to_bytes(2, 'little'))
             for i in characters:
                 level_file.write(i.to_bytes(2, 'little'))
+            for i in warps:
+                level_file.write(i.to_bytes(2, 'little'))
             for i in tiles:
                 level_file.write(i.to_bytes(2, 'little'))
 